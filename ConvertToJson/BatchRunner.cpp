@@ -0,0 +1,165 @@
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+
+// Job indices of one worker: the owner pops the front, thieves the back
+struct WorkQueue
+{
+    std::mutex         mutex;
+    std::deque<size_t> jobs;
+};
+
+// Memory cost of the jobs that are running
+class MemoryBudget
+{
+  public:
+    explicit MemoryBudget(uint64_t limit) : m_limit(limit) {}
+
+    // Blocks until the job fits next to the running ones, or nothing else is running
+    void acquire(uint64_t cost)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [&] { return m_limit == 0 || m_used == 0 || m_used + cost <= m_limit; });
+        m_used += cost;
+    }
+
+    void release(uint64_t cost)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_used -= cost;
+        }
+        m_changed.notify_all();
+    }
+
+  private:
+    std::mutex              m_mutex;
+    std::condition_variable m_changed;
+    uint64_t                m_limit;
+    uint64_t                m_used = 0;
+};
+
+BatchRunner::BatchRunner(unsigned threads, uint64_t memoryBudget)
+    : m_threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())), m_memoryBudget(memoryBudget)
+{
+}
+
+std::vector<BatchResult> BatchRunner::run(const std::vector<BatchJob> &jobs, const BatchConvertFn &convert, std::ostream &out, std::ostream &err)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+
+    std::vector<BatchResult> results(jobs.size());
+    m_workers = static_cast<unsigned>(std::min<size_t>(m_threads, jobs.size()));
+    if (m_workers == 0)
+    {
+        m_seconds = 0;
+        return results;
+    }
+
+    // Deal the jobs out largest first, so the big captures start early and the small ones fill the gaps.
+    // A single worker keeps the input order.
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    if (m_workers > 1)
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return jobs[a].memoryCost > jobs[b].memoryCost; });
+
+    std::vector<WorkQueue> queues(m_workers);
+    for (size_t i = 0; i < order.size(); ++i)
+        queues[i % m_workers].jobs.push_back(order[i]);
+
+    // No jobs are added once the workers run, so a worker is done when every queue is empty
+    auto take = [&](unsigned self, size_t &index)
+    {
+        for (unsigned k = 0; k < m_workers; ++k)
+        {
+            WorkQueue                  &q = queues[(self + k) % m_workers];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.jobs.empty())
+                continue;
+            if (k == 0)
+            {
+                index = q.jobs.front();
+                q.jobs.pop_front();
+            }
+            else
+            {
+                index = q.jobs.back();
+                q.jobs.pop_back();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    MemoryBudget budget(m_memoryBudget);
+    std::mutex   outputMutex;
+    auto         worker = [&](unsigned self)
+    {
+        size_t index;
+        while (take(self, index))
+        {
+            const BatchJob &job = jobs[index];
+            BatchResult    &res = results[index];
+
+            budget.acquire(job.memoryCost);
+            const auto         jobStart = Clock::now();
+            std::ostringstream log;
+            try
+            {
+                res.success = convert(job, log);
+            }
+            catch (const std::exception &e)
+            {
+                log << "  Error: " << e.what() << "\n";
+                res.success = false;
+            }
+            res.seconds = std::chrono::duration<double>(Clock::now() - jobStart).count();
+            budget.release(job.memoryCost);
+
+            res.log = log.str();
+            std::lock_guard<std::mutex> lock(outputMutex);
+            (res.success ? out : err) << res.log << std::flush;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < m_workers; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &t : pool)
+        t.join();
+
+    m_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return results;
+}
+
+void BatchRunner::printReport(const std::vector<BatchJob> &jobs, const std::vector<BatchResult> &results, std::ostream &out) const
+{
+    size_t successCount = 0;
+    for (const auto &res : results)
+        successCount += res.success ? 1 : 0;
+
+    if (jobs.size() > 1)
+    {
+        out << "\nPer-file timings:\n" << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < jobs.size(); ++i)
+            out << "  " << std::setw(8) << results[i].seconds << " s  " << (results[i].success ? "ok    " : "FAILED") << "  " << jobs[i].inputPath << "\n";
+        out << std::defaultfloat;
+    }
+
+    out << "\nConverted " << successCount << "/" << jobs.size() << " file(s)";
+    if (jobs.size() > 1)
+        out << " in " << std::fixed << std::setprecision(2) << m_seconds << " s (" << m_workers << " thread" << (m_workers == 1 ? "" : "s") << ")" << std::defaultfloat;
+    out << ".\n";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// One file of a batch conversion
+struct BatchJob
+{
+    std::string inputPath;
+    std::string outputPath;
+    uint64_t    memoryCost = 0; // estimated peak memory while converting (bytes)
+};
+
+// Outcome of a BatchJob
+struct BatchResult
+{
+    bool        success = false;
+    double      seconds = 0;
+    std::string log; // console output of the conversion
+};
+
+// Converts one file, writing its console output to `log`
+using BatchConvertFn = std::function<bool(const BatchJob &job, std::ostream &log)>;
+
+// Runs the jobs of a batch conversion on a work-stealing thread pool.
+// The jobs are dealt out largest first, one deque per worker; a worker takes from the front
+// of its own deque and, once that is empty, steals from the back of another one. Jobs only
+// start while the memory cost of the running jobs stays within the budget (a job that does
+// not fit on its own still runs, alone), so several large captures are not loaded at once.
+// Each job's console output is buffered and printed in one piece when the job finishes.
+class BatchRunner
+{
+  public:
+    // threads: 0 = one per core. memoryBudget: bytes, 0 = unlimited.
+    BatchRunner(unsigned threads, uint64_t memoryBudget);
+
+    // Results in job order. Logs of successful jobs go to `out`, the others to `err`.
+    std::vector<BatchResult> run(const std::vector<BatchJob> &jobs, const BatchConvertFn &convert, std::ostream &out, std::ostream &err);
+
+    // Per-file timings of the last run() followed by the "Converted n/m file(s)." line
+    void printReport(const std::vector<BatchJob> &jobs, const std::vector<BatchResult> &results, std::ostream &out) const;
+
+  private:
+    unsigned m_threads;
+    uint64_t m_memoryBudget;
+    unsigned m_workers = 0; // threads used by the last run()
+    double   m_seconds = 0; // wall time of the last run()
+};
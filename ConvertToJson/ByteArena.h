@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ByteView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+
+// Conversion-scoped byte storage for decoded frames.
+// Copies are carved from a monotonic buffer (an inline block first, then geometrically growing
+// heap blocks) and released all at once, instead of one heap allocation per frame.
+class ByteArena
+{
+  public:
+    ByteArena() : m_resource(m_inline, sizeof(m_inline)) {}
+
+    ByteArena(const ByteArena &)            = delete;
+    ByteArena &operator=(const ByteArena &) = delete;
+
+    // Copy `n` bytes into the arena. The view stays valid until release() or destruction.
+    ByteView copy(const uint8_t *p, size_t n)
+    {
+        if (n == 0)
+            return ByteView();
+        uint8_t *dst = static_cast<uint8_t *>(m_resource.allocate(n, 1));
+        std::memcpy(dst, p, n);
+        return ByteView(dst, n);
+    }
+    ByteView copy(ByteView v) { return copy(v.data(), v.size()); }
+
+    // Drop everything copied so far; heap blocks are freed and the inline block is reused.
+    void release() { m_resource.release(); }
+
+  private:
+    // Larger than any IRP record (at most 10000 bytes), so per-record use never touches the heap
+    alignas(16) uint8_t m_inline[16 * 1024];
+    std::pmr::monotonic_buffer_resource m_resource;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Non-owning view of a contiguous byte range.
+// Used for payloads that point directly into a memory-mapped capture file; the
+// view is only valid while the owner of the underlying memory is alive.
+struct ByteView
+{
+    const uint8_t *ptr = nullptr;
+    size_t         len = 0;
+
+    ByteView() = default;
+    ByteView(const uint8_t *p, size_t n) : ptr(p), len(n) {}
+
+    const uint8_t *data() const { return ptr; }
+    size_t         size() const { return len; }
+    bool           empty() const { return len == 0; }
+    const uint8_t *begin() const { return ptr; }
+    const uint8_t *end() const { return ptr + len; }
+    uint8_t        operator[](size_t i) const { return ptr[i]; }
+};
@@ -0,0 +1,85 @@
+#include "ColumnarFile.h"
+#include "FileFormat.h"
+
+#include <cstring>
+#include <iostream>
+
+bool ColumnarFile::open(const std::string &path)
+{
+    close();
+    if (!m_file.open(path))
+        return false;
+
+    const uint8_t *data = m_file.data();
+    const uint64_t size = m_file.size();
+    auto           fail = [&](const char *what)
+    {
+        std::cerr << "Error: " << path << " is not a valid .phxcol file (" << what << ")\n";
+        close();
+        return false;
+    };
+
+    if (size < Columnar::kHeaderSize + Columnar::kFooterSize + Columnar::kTrailerSize)
+        return fail("too small");
+    if (std::memcmp(data, Columnar::kMagic, sizeof(Columnar::kMagic)) != 0 || getLE(data + 8, 4) != Columnar::kVersion)
+        return fail("header");
+
+    const uint8_t *trailer = data + size - Columnar::kTrailerSize;
+    uint64_t       footerAt = getLE(trailer, 8);
+    if (std::memcmp(trailer + 8, Columnar::kTrailerMagic, sizeof(Columnar::kTrailerMagic)) != 0 || footerAt < Columnar::kHeaderSize ||
+        footerAt > size - Columnar::kTrailerSize - Columnar::kFooterSize)
+        return fail("trailer");
+
+    const uint8_t *footer      = data + footerAt;
+    uint64_t       columnCount = getLE(footer + 32, 4);
+    if (std::memcmp(footer, Columnar::kFooterMagic, sizeof(Columnar::kFooterMagic)) != 0 || getLE(footer + 36, 4) != Columnar::kColumnEntrySize ||
+        columnCount > (size - Columnar::kTrailerSize - footerAt - Columnar::kFooterSize) / Columnar::kColumnEntrySize)
+        return fail("footer");
+
+    m_sessionTimestamp = getLE(footer + 8, 8);
+    m_dataSetCount     = getLE(footer + 16, 8);
+    m_eventCount       = getLE(footer + 24, 8);
+
+    for (uint64_t i = 0; i < columnCount; ++i)
+    {
+        const uint8_t *entry  = footer + Columnar::kFooterSize + i * Columnar::kColumnEntrySize;
+        auto           type   = static_cast<Columnar::Type>(getLE(entry + 32, 4));
+        uint32_t       elem   = Columnar::elementSize(type);
+        uint64_t       offset = getLE(entry + 40, 8);
+        uint64_t       count  = getLE(entry + 48, 8);
+        if (elem == 0 || getLE(entry + 36, 4) != elem || offset % 8 != 0 || offset > footerAt || count > (footerAt - offset) / elem)
+            return fail("column entry");
+
+        size_t nameLength = 0;
+        while (nameLength < Columnar::kNameSize && entry[nameLength] != 0)
+            ++nameLength;
+        m_columns.push_back({std::string(reinterpret_cast<const char *>(entry), nameLength), type, data + offset, count});
+    }
+    return true;
+}
+
+void ColumnarFile::close()
+{
+    m_file.close();
+    m_columns.clear();
+    m_sessionTimestamp = 0;
+    m_dataSetCount     = 0;
+    m_eventCount       = 0;
+}
+
+const ColumnarFile::Column *ColumnarFile::find(std::string_view name) const
+{
+    for (const auto &c : m_columns)
+    {
+        if (c.name == name)
+            return &c;
+    }
+    return nullptr;
+}
+
+std::string ColumnarFile::text(std::string_view name) const
+{
+    uint64_t    count = 0;
+    const char *p     = column<char>(name, count);
+    return p ? std::string(p, static_cast<size_t>(count)) : std::string();
+}
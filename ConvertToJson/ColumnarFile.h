@@ -0,0 +1,119 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Columnar export of a decoded capture (".phxcol"), little-endian throughout:
+//
+//   char[8]  magic "PHXCOL\0\0"
+//   uint32   version
+//   uint32   reserved
+//   column data, each column 8-byte aligned
+//   footer:
+//     char[8]  magic "PHXFOOT\0"
+//     uint64   session timestamp (FILETIME)
+//     uint64   data-set rows
+//     uint64   event rows
+//     uint32   column count
+//     uint32   column entry size (56)
+//     column entries: char[32] name (NUL-padded), uint32 type, uint32 element size,
+//                     uint64 offset of the column data, uint64 element count
+//   trailer: uint64 footer offset, char[8] magic "PHXEND\0\0"
+//
+// Tables:
+//   dataSet.* - one row per data set: irpTimestamp (u64 FILETIME), timestamp_us (u32),
+//               x/y/z (i32, 10 um units), status (u32 status word), ledId (u8), tcmId (u8)
+//   event.*   - one row per other frame: irpTimestamp (u64), type (u8 PhoenixFrameType),
+//               direction (u8, 1 = TX), code (u8), index (u8), payloadOffset (u64, rows + 1 entries)
+//               into payload (u8: the raw frame bytes)
+//   meta.*    - sourceFile, device, portConfig as u8 text
+//
+// The column data is stored exactly as it is used in memory, so a reader maps the file and
+// points at the columns without decoding anything.
+namespace Columnar
+{
+    enum class Type : uint32_t
+    {
+        U8  = 1,
+        U32 = 2,
+        I32 = 3,
+        U64 = 4,
+    };
+
+    constexpr uint32_t kVersion         = 1;
+    constexpr size_t   kHeaderSize      = 16;
+    constexpr size_t   kFooterSize      = 40; // without the column entries
+    constexpr size_t   kColumnEntrySize = 56;
+    constexpr size_t   kNameSize        = 32;
+    constexpr size_t   kTrailerSize     = 16;
+
+    inline constexpr char kMagic[8]        = {'P', 'H', 'X', 'C', 'O', 'L', 0, 0};
+    inline constexpr char kFooterMagic[8]  = {'P', 'H', 'X', 'F', 'O', 'O', 'T', 0};
+    inline constexpr char kTrailerMagic[8] = {'P', 'H', 'X', 'E', 'N', 'D', 0, 0};
+
+    constexpr uint32_t elementSize(Type type)
+    {
+        switch (type)
+        {
+            case Type::U8:
+                return 1;
+            case Type::U32:
+            case Type::I32:
+                return 4;
+            case Type::U64:
+                return 8;
+        }
+        return 0;
+    }
+} // namespace Columnar
+
+// Read-only view of a .phxcol file. Columns point straight into the memory mapping.
+class ColumnarFile
+{
+  public:
+    struct Column
+    {
+        std::string    name;
+        Columnar::Type type;
+        const void    *data;
+        uint64_t       count;
+    };
+
+    // Map and validate the file (magic, version, column bounds and alignment)
+    bool open(const std::string &path);
+    void close();
+
+    uint64_t sessionTimestamp() const { return m_sessionTimestamp; }
+    uint64_t dataSetCount() const { return m_dataSetCount; }
+    uint64_t eventCount() const { return m_eventCount; }
+
+    const std::vector<Column> &columns() const { return m_columns; }
+
+    // Column by name, or nullptr
+    const Column *find(std::string_view name) const;
+
+    // Typed column data; nullptr if the column is missing or has another element type
+    template <typename T> const T *column(std::string_view name, uint64_t &count) const
+    {
+        const Column *c = find(name);
+        if (!c || Columnar::elementSize(c->type) != sizeof(T))
+            return nullptr;
+        count = c->count;
+        return static_cast<const T *>(c->data);
+    }
+
+    // Text of a meta.* column
+    std::string text(std::string_view name) const;
+
+  private:
+    MappedFile          m_file;
+    std::vector<Column> m_columns;
+    uint64_t            m_sessionTimestamp = 0;
+    uint64_t            m_dataSetCount     = 0;
+    uint64_t            m_eventCount       = 0;
+};
@@ -0,0 +1,273 @@
+#include "ColumnarWriter.h"
+#include "FileFormat.h"
+
+#include <cstring>
+
+// Column buffer size before its values are moved to the spill file
+static const size_t kSpillSize = 256 * 1024;
+
+// Columns in file order
+enum ColumnId
+{
+    DataSetIrpTimestamp,
+    DataSetTimestampUs,
+    DataSetX,
+    DataSetY,
+    DataSetZ,
+    DataSetStatus,
+    DataSetLedId,
+    DataSetTcmId,
+    EventIrpTimestamp,
+    EventType,
+    EventDirection,
+    EventCode,
+    EventIndex,
+    EventPayloadOffset,
+    EventPayload,
+    MetaSourceFile,
+    MetaDevice,
+    MetaPortConfig,
+    kColumnCount
+};
+
+static const struct
+{
+    const char    *name;
+    Columnar::Type type;
+} kColumns[kColumnCount] = {
+    {"dataSet.irpTimestamp", Columnar::Type::U64},
+    {"dataSet.timestamp_us", Columnar::Type::U32},
+    {"dataSet.x", Columnar::Type::I32},
+    {"dataSet.y", Columnar::Type::I32},
+    {"dataSet.z", Columnar::Type::I32},
+    {"dataSet.status", Columnar::Type::U32},
+    {"dataSet.ledId", Columnar::Type::U8},
+    {"dataSet.tcmId", Columnar::Type::U8},
+    {"event.irpTimestamp", Columnar::Type::U64},
+    {"event.type", Columnar::Type::U8},
+    {"event.direction", Columnar::Type::U8},
+    {"event.code", Columnar::Type::U8},
+    {"event.index", Columnar::Type::U8},
+    {"event.payloadOffset", Columnar::Type::U64},
+    {"event.payload", Columnar::Type::U8},
+    {"meta.sourceFile", Columnar::Type::U8},
+    {"meta.device", Columnar::Type::U8},
+    {"meta.portConfig", Columnar::Type::U8},
+};
+
+ColumnarWriter::ColumnarWriter()
+{
+    m_columns.resize(kColumnCount);
+    for (size_t i = 0; i < kColumnCount; ++i)
+    {
+        m_columns[i].name = kColumns[i].name;
+        m_columns[i].type = kColumns[i].type;
+    }
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    discard();
+}
+
+bool ColumnarWriter::write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const FrameSource &source)
+{
+    if (!begin(outputPath, header, sourceFile))
+        return false;
+    source([this](const PhoenixFrame &f) { writeFrame(f); });
+    return end();
+}
+
+bool ColumnarWriter::begin(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile)
+{
+    discard();
+    m_outputPath       = outputPath;
+    m_error.clear();
+    m_sessionTimestamp = header.sessionTimestamp;
+    m_counts           = PhoenixFrameCounts();
+    m_payloadBytes     = 0;
+    m_failed           = false;
+    m_open             = true;
+
+    for (size_t i = 0; i < m_columns.size(); ++i)
+        m_columns[i].spillPath = outputPath + "." + std::to_string(i) + ".tmp";
+
+    append(m_columns[EventPayloadOffset], m_payloadBytes);
+    append(m_columns[MetaSourceFile], sourceFile.data(), sourceFile.size());
+    append(m_columns[MetaDevice], header.deviceName.data(), header.deviceName.size());
+    append(m_columns[MetaPortConfig], header.portConfig.data(), header.portConfig.size());
+    return true;
+}
+
+void ColumnarWriter::writeFrame(const PhoenixFrame &f)
+{
+    if (!m_open)
+        return;
+    m_counts.add(f);
+
+    if (f.type == PhoenixFrameType::DataSet)
+    {
+        const auto &ds = f.dataSet;
+        append(m_columns[DataSetIrpTimestamp], f.irpTimestamp);
+        append(m_columns[DataSetTimestampUs], ds.timestamp_us);
+        append(m_columns[DataSetX], ds.x);
+        append(m_columns[DataSetY], ds.y);
+        append(m_columns[DataSetZ], ds.z);
+        append(m_columns[DataSetStatus], ds.statusWord);
+        append(m_columns[DataSetLedId], ds.ledId);
+        append(m_columns[DataSetTcmId], ds.tcmId);
+        return;
+    }
+
+    uint8_t code  = 0;
+    uint8_t index = 0;
+    if (f.type == PhoenixFrameType::Command)
+    {
+        code  = static_cast<uint8_t>(f.command.commandCode);
+        index = static_cast<uint8_t>(f.command.commandIndex);
+    }
+    else if (f.type == PhoenixFrameType::Message)
+    {
+        code  = static_cast<uint8_t>(f.message.commandCode);
+        index = static_cast<uint8_t>(f.message.commandIndex);
+    }
+
+    append(m_columns[EventIrpTimestamp], f.irpTimestamp);
+    append(m_columns[EventType], static_cast<uint8_t>(f.type));
+    append(m_columns[EventDirection], static_cast<uint8_t>(f.isTx ? 1 : 0));
+    append(m_columns[EventCode], code);
+    append(m_columns[EventIndex], index);
+    append(m_columns[EventPayload], f.rawBytes.data(), f.rawBytes.size());
+    m_payloadBytes += f.rawBytes.size();
+    append(m_columns[EventPayloadOffset], m_payloadBytes);
+}
+
+void ColumnarWriter::append(Column &c, const void *data, size_t size)
+{
+    if (size == 0)
+        return;
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    c.buffer.insert(c.buffer.end(), p, p + size);
+    if (c.buffer.size() >= kSpillSize && !spill(c))
+        m_failed = true;
+}
+
+bool ColumnarWriter::spill(Column &c)
+{
+    if (!c.spill)
+    {
+        c.spill = std::fopen(c.spillPath.c_str(), "w+b");
+        if (!c.spill)
+            return false;
+    }
+    if (std::fwrite(c.buffer.data(), 1, c.buffer.size(), c.spill) != c.buffer.size())
+        return false;
+    c.spilled += c.buffer.size();
+    c.buffer.clear();
+    return true;
+}
+
+// Spilled values first, then the buffered ones
+bool ColumnarWriter::copyColumn(Column &c, std::FILE *out)
+{
+    if (c.spill)
+    {
+        std::vector<uint8_t> block(kSpillSize);
+        std::rewind(c.spill);
+        uint64_t left = c.spilled;
+        while (left > 0)
+        {
+            size_t n = left < block.size() ? static_cast<size_t>(left) : block.size();
+            if (std::fread(block.data(), 1, n, c.spill) != n || std::fwrite(block.data(), 1, n, out) != n)
+                return false;
+            left -= n;
+        }
+    }
+    return std::fwrite(c.buffer.data(), 1, c.buffer.size(), out) == c.buffer.size();
+}
+
+bool ColumnarWriter::end()
+{
+    if (!m_open)
+        return false;
+    m_open = false;
+
+    if (m_failed)
+    {
+        m_error = "cannot write temporary column file next to " + m_outputPath;
+        discard();
+        return false;
+    }
+
+    std::FILE *out = std::fopen(m_outputPath.c_str(), "wb");
+    if (!out)
+    {
+        m_error = "cannot create output file: " + m_outputPath;
+        discard();
+        return false;
+    }
+
+    uint8_t header[Columnar::kHeaderSize] = {};
+    std::memcpy(header, Columnar::kMagic, sizeof(Columnar::kMagic));
+    putLE(header + 8, Columnar::kVersion, 4);
+    bool ok = std::fwrite(header, 1, sizeof(header), out) == sizeof(header);
+
+    // Column data, each column starting on an 8-byte boundary
+    std::vector<uint8_t> footer(Columnar::kFooterSize + m_columns.size() * Columnar::kColumnEntrySize);
+    uint64_t             offset = Columnar::kHeaderSize;
+    for (size_t i = 0; i < m_columns.size() && ok; ++i)
+    {
+        Column       &c       = m_columns[i];
+        const uint8_t zero[8] = {};
+        size_t        padding = static_cast<size_t>((8 - offset % 8) % 8);
+        ok = std::fwrite(zero, 1, padding, out) == padding && copyColumn(c, out);
+        offset += padding;
+
+        uint8_t *entry = footer.data() + Columnar::kFooterSize + i * Columnar::kColumnEntrySize;
+        std::strncpy(reinterpret_cast<char *>(entry), c.name, Columnar::kNameSize - 1);
+        putLE(entry + 32, static_cast<uint32_t>(c.type), 4);
+        putLE(entry + 36, Columnar::elementSize(c.type), 4);
+        putLE(entry + 40, offset, 8);
+        putLE(entry + 48, c.bytes() / Columnar::elementSize(c.type), 8);
+        offset += c.bytes();
+    }
+
+    std::memcpy(footer.data(), Columnar::kFooterMagic, sizeof(Columnar::kFooterMagic));
+    putLE(footer.data() + 8, m_sessionTimestamp, 8);
+    putLE(footer.data() + 16, m_counts.dataSets, 8);
+    putLE(footer.data() + 24, m_counts.total - m_counts.dataSets, 8);
+    putLE(footer.data() + 32, m_columns.size(), 4);
+    putLE(footer.data() + 36, Columnar::kColumnEntrySize, 4);
+
+    uint8_t trailer[Columnar::kTrailerSize];
+    putLE(trailer, offset, 8);
+    std::memcpy(trailer + 8, Columnar::kTrailerMagic, sizeof(Columnar::kTrailerMagic));
+
+    ok = ok && std::fwrite(footer.data(), 1, footer.size(), out) == footer.size();
+    ok = ok && std::fwrite(trailer, 1, sizeof(trailer), out) == sizeof(trailer);
+    ok = (std::fclose(out) == 0) && ok;
+    discard();
+
+    if (!ok)
+    {
+        m_error = "write failed for " + m_outputPath;
+        return false;
+    }
+    return true;
+}
+
+// Drop buffered values and remove the spill files
+void ColumnarWriter::discard()
+{
+    for (auto &c : m_columns)
+    {
+        if (c.spill)
+        {
+            std::fclose(c.spill);
+            std::remove(c.spillPath.c_str());
+            c.spill = nullptr;
+        }
+        c.buffer.clear();
+        c.spilled = 0;
+    }
+}
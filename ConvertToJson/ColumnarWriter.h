@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ColumnarFile.h"
+#include "DmsLogReader.h"
+#include "JsonWriter.h"
+#include "PhoenixDecoder.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Writes decoded frames as a columnar .phxcol file (layout in ColumnarFile.h).
+// Column values are buffered per column and spilled to temporary files next to the output
+// once a buffer fills up, so memory use stays constant however long the capture is; end()
+// concatenates the columns and appends the footer index.
+class ColumnarWriter
+{
+  public:
+    ColumnarWriter();
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter &)            = delete;
+    ColumnarWriter &operator=(const ColumnarWriter &) = delete;
+
+    // Single pass over `source`, same as JsonWriter::write
+    bool write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const FrameSource &source);
+
+    // Incremental output: begin(), writeFrame() per frame, end()
+    bool begin(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile);
+    void writeFrame(const PhoenixFrame &f);
+    bool end();
+
+    // Frame counts of the last write()
+    const PhoenixFrameCounts &counts() const { return m_counts; }
+
+    // Why the last write() / end() failed, for the caller to report
+    const std::string &error() const { return m_error; }
+
+  private:
+    struct Column
+    {
+        const char          *name;
+        Columnar::Type       type;
+        std::vector<uint8_t> buffer;            // values not yet spilled
+        std::string          spillPath;         // temporary file with the earlier values
+        std::FILE           *spill   = nullptr;
+        uint64_t             spilled = 0;       // bytes in `spill`
+
+        uint64_t bytes() const { return spilled + buffer.size(); }
+    };
+
+    template <typename T> void append(Column &c, T value) { append(c, &value, sizeof(T)); }
+    void                       append(Column &c, const void *data, size_t size);
+    bool                       spill(Column &c);
+    bool                       copyColumn(Column &c, std::FILE *out);
+    void                       discard();
+
+    std::vector<Column> m_columns;
+    PhoenixFrameCounts  m_counts;
+    std::string         m_outputPath;
+    std::string         m_error;
+    uint64_t            m_sessionTimestamp = 0;
+    uint64_t            m_payloadBytes     = 0;
+    bool                m_failed           = false; // a spill file could not be written
+    bool                m_open             = false;
+};
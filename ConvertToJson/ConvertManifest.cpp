@@ -0,0 +1,246 @@
+#include "ConvertManifest.h"
+#include "FileFormat.h"
+#include "MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+// Manifest layout (little-endian):
+//   char[8]  magic "PHXMAN\0\0"
+//   uint32   manifest version
+//   uint32   converter version (kConverterVersion)
+//   uint64   entry count
+//   entries: uint64 capture size, int64 capture modification time, uint64 capture hash,
+//            uint64 output size, then capture path, output path and settings, each as
+//            uint32 length + bytes (paths relative to the directory, '/' separated)
+static const char     kManifestMagic[8]   = {'P', 'H', 'X', 'M', 'A', 'N', 0, 0};
+static const uint32_t kManifestVersion    = 3;
+static const size_t   kManifestHeaderSize = 24;
+static const size_t   kEntryFixedSize     = 32;
+static const char     kManifestName[]     = ".phxmanifest";
+
+// Helper: rotate left by `r` bits.
+static uint64_t rotl(uint64_t v, int r)
+{
+    return (v << r) | (v >> (64 - r));
+}
+
+// Helper: hash of `n` bytes and their count. Four 64-bit lanes of multiply-rotate rounds over
+// 32-byte stripes (the tail zero-padded into one more stripe), folded and mixed with the size.
+// Words are loaded in native order; every supported target is little-endian.
+static uint64_t hashBytes(const uint8_t *p, uint64_t n)
+{
+    const uint64_t kPrime1  = 0x9E3779B185EBCA87ULL;
+    const uint64_t kPrime2  = 0xC2B2AE3D27D4EB4FULL;
+    uint64_t       lanes[4] = {kPrime1, kPrime2, ~kPrime1, ~kPrime2};
+
+    auto stripe = [&](const uint8_t *s)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            uint64_t word;
+            std::memcpy(&word, s + 8 * k, sizeof(word));
+            lanes[k] = rotl(lanes[k] + word * kPrime2, 31) * kPrime1;
+        }
+    };
+
+    uint64_t pos = 0;
+    for (; n - pos >= 32; pos += 32)
+        stripe(p + pos);
+    if (pos < n)
+    {
+        uint8_t tail[32] = {};
+        std::memcpy(tail, p + pos, static_cast<size_t>(n - pos));
+        stripe(tail);
+    }
+
+    uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    h ^= n * kPrime1;
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime1;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string ConvertManifest::manifestPath(const std::string &directory)
+{
+    return (std::filesystem::path(directory) / kManifestName).string();
+}
+
+bool ConvertManifest::contentHash(const std::string &path, uint64_t size, uint64_t &hash)
+{
+    MappedFile file;
+    if (!file.open(path) || file.size() != size)
+        return false;
+    hash = hashBytes(file.data(), file.size());
+    return true;
+}
+
+SourceFingerprint ConvertManifest::fingerprint(const std::string &path)
+{
+    std::error_code   ec;
+    SourceFingerprint fingerprint;
+    fingerprint.size    = std::filesystem::file_size(path, ec);
+    fingerprint.modTime = fileModificationTime(path);
+    if (ec)
+        fingerprint.size = 0;
+    return fingerprint;
+}
+
+bool ConvertManifest::load(const std::string &directory)
+{
+    m_directory = directory;
+    m_entries.clear();
+
+    std::ifstream file(manifestPath(directory), std::ios::binary);
+    if (!file.is_open())
+        return false;
+    std::vector<uint8_t> raw((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (raw.size() < kManifestHeaderSize || std::memcmp(raw.data(), kManifestMagic, sizeof(kManifestMagic)) != 0 ||
+        getLE(raw.data() + 8, 4) != kManifestVersion || getLE(raw.data() + 12, 4) != kConverterVersion)
+        return false;
+
+    const uint64_t count = getLE(raw.data() + 16, 8);
+    size_t         pos   = kManifestHeaderSize;
+    auto           text  = [&](std::string &s)
+    {
+        if (raw.size() - pos < 4)
+            return false;
+        uint64_t n = getLE(raw.data() + pos, 4);
+        if (raw.size() - pos - 4 < n)
+            return false;
+        s.assign(reinterpret_cast<const char *>(raw.data() + pos + 4), static_cast<size_t>(n));
+        pos += 4 + static_cast<size_t>(n);
+        return true;
+    };
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (raw.size() - pos < kEntryFixedSize)
+            break;
+        Entry          e;
+        const uint8_t *p = raw.data() + pos;
+        e.source.size    = getLE(p, 8);
+        e.source.modTime = static_cast<int64_t>(getLE(p + 8, 8));
+        e.source.hash    = getLE(p + 16, 8);
+        e.outputSize     = getLE(p + 24, 8);
+        pos += kEntryFixedSize;
+
+        std::string capture, output;
+        if (!text(capture) || !text(output) || !text(e.settings))
+            break;
+        m_entries[{capture, output}] = e;
+    }
+    if (m_entries.size() != count)
+    {
+        m_entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ConvertManifest::save() const
+{
+    std::vector<uint8_t> raw(kManifestHeaderSize);
+    std::memcpy(raw.data(), kManifestMagic, sizeof(kManifestMagic));
+    putLE(raw.data() + 8, kManifestVersion, 4);
+    putLE(raw.data() + 12, kConverterVersion, 4);
+
+    auto text = [&](const std::string &s)
+    {
+        size_t at = raw.size();
+        raw.resize(at + 4 + s.size());
+        putLE(raw.data() + at, s.size(), 4);
+        std::memcpy(raw.data() + at + 4, s.data(), s.size());
+    };
+
+    uint64_t        count = 0;
+    std::error_code ec;
+    for (const auto &[paths, e] : m_entries)
+    {
+        if (!std::filesystem::exists(std::filesystem::path(m_directory) / paths.first, ec))
+            continue;
+        size_t at = raw.size();
+        raw.resize(at + kEntryFixedSize);
+        putLE(raw.data() + at, e.source.size, 8);
+        putLE(raw.data() + at + 8, static_cast<uint64_t>(e.source.modTime), 8);
+        putLE(raw.data() + at + 16, e.source.hash, 8);
+        putLE(raw.data() + at + 24, e.outputSize, 8);
+        text(paths.first);
+        text(paths.second);
+        text(e.settings);
+        ++count;
+    }
+    putLE(raw.data() + 16, count, 8);
+
+    // Written next to the manifest and renamed, so an interrupted run leaves the old one intact
+    const std::string path = manifestPath(m_directory);
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char *>(raw.data()), static_cast<std::streamsize>(raw.size()));
+        if (!file.good())
+            return false;
+    }
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::pair<std::string, std::string> ConvertManifest::key(const BatchJob &job) const
+{
+    auto relative = [&](const std::string &p) { return std::filesystem::path(p).lexically_relative(m_directory).generic_string(); };
+    return {relative(job.inputPath), relative(job.outputPath)};
+}
+
+bool ConvertManifest::isCurrent(const BatchJob &job, const std::string &settings, const SourceFingerprint &fingerprint)
+{
+    auto it = m_entries.find(key(job));
+    if (it == m_entries.end())
+        return false;
+    Entry &entry = it->second;
+    if (entry.settings != settings || entry.source.size != fingerprint.size)
+        return false;
+
+    std::error_code ec;
+    uint64_t        outputSize = std::filesystem::file_size(job.outputPath, ec);
+    if (ec || outputSize != entry.outputSize)
+        return false;
+
+    if (entry.source.modTime == fingerprint.modTime)
+        return true;
+
+    // Touched or copied: current only with the same contents, then under the new modification time
+    uint64_t hash = 0;
+    if (!contentHash(job.inputPath, fingerprint.size, hash) || hash != entry.source.hash)
+        return false;
+    entry.source.modTime = fingerprint.modTime;
+    return true;
+}
+
+void ConvertManifest::record(const BatchJob &job, const std::string &settings, const SourceFingerprint &fingerprint)
+{
+    SourceFingerprint now = ConvertManifest::fingerprint(job.inputPath);
+    if (now.size != fingerprint.size || now.modTime != fingerprint.modTime)
+        return;
+
+    std::error_code ec;
+    Entry           e;
+    e.source     = fingerprint;
+    e.outputSize = std::filesystem::file_size(job.outputPath, ec);
+    e.settings   = settings;
+    if (!ec && fingerprint.hash != 0)
+        m_entries[key(job)] = e;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "BatchRunner.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+// Bump when the decoder or the writers change their output, so existing outputs are regenerated.
+constexpr uint32_t kConverterVersion = 1;
+
+// Identity of a capture as recorded in the manifest
+struct SourceFingerprint
+{
+    uint64_t size    = 0;
+    int64_t  modTime = 0; // file-clock ticks
+    uint64_t hash    = 0; // contentHash(), 0 = not computed
+};
+
+// Record of the outputs a batch conversion wrote, stored in the converted directory (".phxmanifest").
+// An output is current while it still has the size it was written with, the converter version and
+// output settings are unchanged, and its capture has the recorded size and modification time. A
+// capture whose modification time changed (e.g. copied to another disk) is still current when a
+// hash of its whole contents matches; the new time is recorded on the next save().
+class ConvertManifest
+{
+  public:
+    // Manifest path for a directory
+    static std::string manifestPath(const std::string &directory);
+
+    // Hash of the size and every byte of the file, read through a memory mapping. False when the
+    // file cannot be mapped or no longer has `size` bytes.
+    static bool contentHash(const std::string &path, uint64_t size, uint64_t &hash);
+
+    // Size and modification time of a capture, taken before it is converted (no hash)
+    static SourceFingerprint fingerprint(const std::string &path);
+
+    // Load the manifest of `directory`. A missing or damaged manifest, or one written by another
+    // converter version, gives an empty manifest (and false).
+    bool load(const std::string &directory);
+
+    // Write the manifest back, dropping entries whose capture no longer exists
+    bool save() const;
+
+    // True when job.outputPath was written from the current contents of job.inputPath with `settings`.
+    // `fingerprint` is the capture's fingerprint(); the capture is only read (hashed) when its
+    // modification time differs from the recorded one.
+    bool isCurrent(const BatchJob &job, const std::string &settings, const SourceFingerprint &fingerprint);
+
+    // Remember a successful conversion of the capture as it was at `fingerprint`, whose hash the caller
+    // filled in with contentHash() (batch conversions do so on the worker, right after converting).
+    // Nothing is recorded without a hash or when the capture changed since `fingerprint` was taken,
+    // so it is converted again next time.
+    void record(const BatchJob &job, const std::string &settings, const SourceFingerprint &fingerprint);
+
+  private:
+    struct Entry
+    {
+        SourceFingerprint source;
+        uint64_t          outputSize = 0;
+        std::string       settings;
+    };
+
+    // Paths relative to the manifest directory
+    std::pair<std::string, std::string> key(const BatchJob &job) const;
+
+    std::string                                          m_directory;
+    std::map<std::pair<std::string, std::string>, Entry> m_entries; // (capture, output) -> entry
+};
@@ -0,0 +1,355 @@
+#include "DataSetBatch.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DATASET_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define DATASET_TARGET(isa)
+#else
+// GCC/Clang only allow the intrinsics in functions compiled for the instruction set
+#define DATASET_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+static const size_t kRecordSize = 19;
+
+// Output pointers for one record index
+struct ColumnPtrs
+{
+    uint32_t *timestamp_us;
+    int32_t  *x;
+    int32_t  *y;
+    int32_t  *z;
+    uint32_t *statusWord;
+    uint8_t  *ledId;
+    uint8_t  *tcmId;
+    uint8_t  *endOfFrame;
+    uint8_t  *coordStatus;
+    uint8_t  *ambientLight;
+    uint8_t  *rightEyeSignal;
+    uint8_t  *rightEyeStatus;
+    uint8_t  *centerEyeSignal;
+    uint8_t  *centerEyeStatus;
+    uint8_t  *leftEyeSignal;
+    uint8_t  *leftEyeStatus;
+    uint8_t  *triggerIndex;
+
+    void advance(size_t n)
+    {
+        timestamp_us += n;
+        x += n;
+        y += n;
+        z += n;
+        statusWord += n;
+        ledId += n;
+        tcmId += n;
+        endOfFrame += n;
+        coordStatus += n;
+        ambientLight += n;
+        rightEyeSignal += n;
+        rightEyeStatus += n;
+        centerEyeSignal += n;
+        centerEyeStatus += n;
+        leftEyeSignal += n;
+        leftEyeStatus += n;
+        triggerIndex += n;
+    }
+};
+
+void DataSetColumns::resize(size_t n)
+{
+    timestamp_us.resize(n);
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    statusWord.resize(n);
+    ledId.resize(n);
+    tcmId.resize(n);
+    endOfFrame.resize(n);
+    coordStatus.resize(n);
+    ambientLight.resize(n);
+    rightEyeSignal.resize(n);
+    rightEyeStatus.resize(n);
+    centerEyeSignal.resize(n);
+    centerEyeStatus.resize(n);
+    leftEyeSignal.resize(n);
+    leftEyeStatus.resize(n);
+    triggerIndex.resize(n);
+}
+
+// ---- Scalar kernel (reference) ----
+
+static uint32_t readU32BE(const uint8_t *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+static int32_t readS24BE(const uint8_t *p)
+{
+    int32_t val = (int32_t(p[0]) << 16) | (int32_t(p[1]) << 8) | int32_t(p[2]);
+    if (val & 0x800000)
+        val |= static_cast<int32_t>(0xFF000000); // sign-extend
+    return val;
+}
+
+static void decodeScalar(const uint8_t *records, size_t count, ColumnPtrs c)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t *p  = records + i * kRecordSize;
+        uint32_t       s  = readU32BE(p + 13);
+        c.timestamp_us[i] = readU32BE(p);
+        c.x[i]            = readS24BE(p + 4);
+        c.y[i]            = readS24BE(p + 7);
+        c.z[i]            = readS24BE(p + 10);
+        c.statusWord[i]   = s;
+        c.ledId[i]        = p[17] & 0x7F;
+        c.tcmId[i]        = p[18] & 0x0F;
+
+        // Status word: E|HHH|mmmm  ???|La|AAAA  TTT|Lb|BBBB  TTT|Lc|CCCC
+        c.endOfFrame[i]      = (s >> 31) & 0x01;
+        c.coordStatus[i]     = (s >> 28) & 0x07;
+        c.ambientLight[i]    = (s >> 24) & 0x0F;
+        c.rightEyeSignal[i]  = (s >> 20) & 0x01;
+        c.rightEyeStatus[i]  = (s >> 16) & 0x0F;
+        c.centerEyeSignal[i] = (s >> 12) & 0x01;
+        c.centerEyeStatus[i] = (s >> 8) & 0x0F;
+        c.leftEyeSignal[i]   = (s >> 4) & 0x01;
+        c.leftEyeStatus[i]   = s & 0x0F;
+        c.triggerIndex[i]    = static_cast<uint8_t>((((s >> 13) & 0x07) << 3) | ((s >> 5) & 0x07));
+    }
+}
+
+#ifdef DATASET_X86
+
+// ---- SSE4.1 kernel: 4 records per step ----
+//
+// Per record, two unaligned 16-byte loads (bytes 0-15 and 3-18) are byte-shuffled into
+// little-endian dwords: [ts, X<<8, Y<<8, Z<<8] and [status, LED | TCM<<8, -, -].
+// A 4x4 transpose turns these into one vector per column; the 24-bit coordinates are
+// sign-extended with an arithmetic shift and the status fields are extracted 4 at a time.
+
+DATASET_TARGET("sse4.1") static void storeBytes4(uint8_t *dst, __m128i v)
+{
+    __m128i packed = _mm_packus_epi16(_mm_packus_epi32(v, v), _mm_setzero_si128());
+    int32_t bytes  = _mm_cvtsi128_si32(packed);
+    std::memcpy(dst, &bytes, 4);
+}
+
+DATASET_TARGET("sse4.1") static __m128i field4(__m128i s, int shift, int mask)
+{
+    return _mm_and_si128(_mm_srl_epi32(s, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(mask));
+}
+
+DATASET_TARGET("sse4.1") static size_t decodeSse41(const uint8_t *records, size_t count, ColumnPtrs c)
+{
+    const __m128i coordShuffle  = _mm_setr_epi8(3, 2, 1, 0, -1, 6, 5, 4, -1, 9, 8, 7, -1, 12, 11, 10);
+    const __m128i statusShuffle = _mm_setr_epi8(13, 12, 11, 10, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    size_t done = 0;
+    for (; done + 4 <= count; done += 4)
+    {
+        const uint8_t *p = records + done * kRecordSize;
+        __m128i        a[4], b[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            a[k] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + k * kRecordSize)), coordShuffle);
+            b[k] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + k * kRecordSize + 3)), statusShuffle);
+        }
+
+        __m128i t0 = _mm_unpacklo_epi32(a[0], a[1]);
+        __m128i t1 = _mm_unpacklo_epi32(a[2], a[3]);
+        __m128i t2 = _mm_unpackhi_epi32(a[0], a[1]);
+        __m128i t3 = _mm_unpackhi_epi32(a[2], a[3]);
+        __m128i u0 = _mm_unpacklo_epi32(b[0], b[1]);
+        __m128i u1 = _mm_unpacklo_epi32(b[2], b[3]);
+
+        __m128i ts = _mm_unpacklo_epi64(t0, t1);
+        __m128i xs = _mm_srai_epi32(_mm_unpackhi_epi64(t0, t1), 8);
+        __m128i ys = _mm_srai_epi32(_mm_unpacklo_epi64(t2, t3), 8);
+        __m128i zs = _mm_srai_epi32(_mm_unpackhi_epi64(t2, t3), 8);
+        __m128i s  = _mm_unpacklo_epi64(u0, u1);
+        __m128i lt = _mm_unpackhi_epi64(u0, u1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c.timestamp_us + done), ts);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c.x + done), xs);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c.y + done), ys);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c.z + done), zs);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(c.statusWord + done), s);
+
+        storeBytes4(c.ledId + done, field4(lt, 0, 0x7F));
+        storeBytes4(c.tcmId + done, field4(lt, 8, 0x0F));
+        storeBytes4(c.endOfFrame + done, field4(s, 31, 0x01));
+        storeBytes4(c.coordStatus + done, field4(s, 28, 0x07));
+        storeBytes4(c.ambientLight + done, field4(s, 24, 0x0F));
+        storeBytes4(c.rightEyeSignal + done, field4(s, 20, 0x01));
+        storeBytes4(c.rightEyeStatus + done, field4(s, 16, 0x0F));
+        storeBytes4(c.centerEyeSignal + done, field4(s, 12, 0x01));
+        storeBytes4(c.centerEyeStatus + done, field4(s, 8, 0x0F));
+        storeBytes4(c.leftEyeSignal + done, field4(s, 4, 0x01));
+        storeBytes4(c.leftEyeStatus + done, field4(s, 0, 0x0F));
+        storeBytes4(c.triggerIndex + done, _mm_or_si128(_mm_slli_epi32(field4(s, 13, 0x07), 3), field4(s, 5, 0x07)));
+    }
+    return done;
+}
+
+// ---- AVX2 kernel: 8 records per step ----
+//
+// Same scheme with records k and k+4 in the two 128-bit lanes, so the in-lane transpose
+// directly yields columns in record order.
+
+DATASET_TARGET("avx2") static void storeBytes8(uint8_t *dst, __m256i v)
+{
+    __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(v, v), _mm256_setzero_si256());
+    packed         = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(packed));
+}
+
+DATASET_TARGET("avx2") static __m256i field8(__m256i s, int shift, int mask)
+{
+    return _mm256_and_si256(_mm256_srl_epi32(s, _mm_cvtsi32_si128(shift)), _mm256_set1_epi32(mask));
+}
+
+DATASET_TARGET("avx2") static __m256i loadPair(const uint8_t *lo, const uint8_t *hi)
+{
+    __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lo));
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(l), h, 1);
+}
+
+DATASET_TARGET("avx2") static size_t decodeAvx2(const uint8_t *records, size_t count, ColumnPtrs c)
+{
+    const __m256i coordShuffle  = _mm256_setr_epi8(3, 2, 1, 0, -1, 6, 5, 4, -1, 9, 8, 7, -1, 12, 11, 10, 3, 2, 1, 0, -1, 6, 5, 4, -1, 9, 8, 7, -1, 12, 11, 10);
+    const __m256i statusShuffle = _mm256_setr_epi8(13, 12, 11, 10, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, 12, 11, 10, 14, 15, -1, -1, -1, -1, -1, -1, -1,
+                                                   -1, -1, -1);
+
+    size_t done = 0;
+    for (; done + 8 <= count; done += 8)
+    {
+        const uint8_t *p = records + done * kRecordSize;
+        __m256i        a[4], b[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            const uint8_t *lo = p + k * kRecordSize;
+            const uint8_t *hi = p + (k + 4) * kRecordSize;
+            a[k]              = _mm256_shuffle_epi8(loadPair(lo, hi), coordShuffle);
+            b[k]              = _mm256_shuffle_epi8(loadPair(lo + 3, hi + 3), statusShuffle);
+        }
+
+        __m256i t0 = _mm256_unpacklo_epi32(a[0], a[1]);
+        __m256i t1 = _mm256_unpacklo_epi32(a[2], a[3]);
+        __m256i t2 = _mm256_unpackhi_epi32(a[0], a[1]);
+        __m256i t3 = _mm256_unpackhi_epi32(a[2], a[3]);
+        __m256i u0 = _mm256_unpacklo_epi32(b[0], b[1]);
+        __m256i u1 = _mm256_unpacklo_epi32(b[2], b[3]);
+
+        __m256i ts = _mm256_unpacklo_epi64(t0, t1);
+        __m256i xs = _mm256_srai_epi32(_mm256_unpackhi_epi64(t0, t1), 8);
+        __m256i ys = _mm256_srai_epi32(_mm256_unpacklo_epi64(t2, t3), 8);
+        __m256i zs = _mm256_srai_epi32(_mm256_unpackhi_epi64(t2, t3), 8);
+        __m256i s  = _mm256_unpacklo_epi64(u0, u1);
+        __m256i lt = _mm256_unpackhi_epi64(u0, u1);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c.timestamp_us + done), ts);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c.x + done), xs);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c.y + done), ys);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c.z + done), zs);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(c.statusWord + done), s);
+
+        storeBytes8(c.ledId + done, field8(lt, 0, 0x7F));
+        storeBytes8(c.tcmId + done, field8(lt, 8, 0x0F));
+        storeBytes8(c.endOfFrame + done, field8(s, 31, 0x01));
+        storeBytes8(c.coordStatus + done, field8(s, 28, 0x07));
+        storeBytes8(c.ambientLight + done, field8(s, 24, 0x0F));
+        storeBytes8(c.rightEyeSignal + done, field8(s, 20, 0x01));
+        storeBytes8(c.rightEyeStatus + done, field8(s, 16, 0x0F));
+        storeBytes8(c.centerEyeSignal + done, field8(s, 12, 0x01));
+        storeBytes8(c.centerEyeStatus + done, field8(s, 8, 0x0F));
+        storeBytes8(c.leftEyeSignal + done, field8(s, 4, 0x01));
+        storeBytes8(c.leftEyeStatus + done, field8(s, 0, 0x0F));
+        storeBytes8(c.triggerIndex + done, _mm256_or_si256(_mm256_slli_epi32(field8(s, 13, 0x07), 3), field8(s, 5, 0x07)));
+    }
+    return done;
+}
+
+static DataSetKernel detectKernel()
+{
+#ifdef _MSC_VER
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41   = (info[2] & (1 << 19)) != 0;
+    const bool osYmm   = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE + AVX, YMM state enabled
+    bool       avx2    = false;
+    if (maxLeaf >= 7 && osYmm)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1");
+    const bool avx2  = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+        return DataSetKernel::Avx2;
+    if (sse41)
+        return DataSetKernel::Sse41;
+    return DataSetKernel::Scalar;
+}
+
+#endif // DATASET_X86
+
+DataSetKernel bestDataSetKernel()
+{
+#ifdef DATASET_X86
+    static const DataSetKernel best = detectKernel();
+    return best;
+#else
+    return DataSetKernel::Scalar;
+#endif
+}
+
+void decodeDataSets(const uint8_t *records, size_t count, DataSetColumns &out)
+{
+    decodeDataSets(records, count, out, bestDataSetKernel());
+}
+
+void decodeDataSets(const uint8_t *records, size_t count, DataSetColumns &out, DataSetKernel kernel)
+{
+    if (count == 0)
+        return;
+
+    const size_t first = out.size();
+    out.resize(first + count);
+
+    ColumnPtrs c = {out.timestamp_us.data(),   out.x.data(),
+                    out.y.data(),              out.z.data(),
+                    out.statusWord.data(),     out.ledId.data(),
+                    out.tcmId.data(),          out.endOfFrame.data(),
+                    out.coordStatus.data(),    out.ambientLight.data(),
+                    out.rightEyeSignal.data(), out.rightEyeStatus.data(),
+                    out.centerEyeSignal.data(), out.centerEyeStatus.data(),
+                    out.leftEyeSignal.data(),  out.leftEyeStatus.data(),
+                    out.triggerIndex.data()};
+    c.advance(first);
+
+    if (kernel > bestDataSetKernel())
+        kernel = bestDataSetKernel();
+
+    size_t done = 0;
+#ifdef DATASET_X86
+    if (kernel == DataSetKernel::Avx2)
+        done = decodeAvx2(records, count, c);
+    else if (kernel == DataSetKernel::Sse41)
+        done = decodeSse41(records, count, c);
+#endif
+
+    // Tail (and CPUs without SIMD support)
+    c.advance(done);
+    decodeScalar(records + done * kRecordSize, count - done, c);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Batch decoding of contiguous 19-byte Phoenix data-set records into structure-of-arrays columns.
+// Bit-exact with PhoenixDecoder::decodeDataSet and ParseRecord in Measure_HHD.cpp; the SSE4.1 and
+// AVX2 kernels are selected at run time and fall back to a scalar loop on other CPUs.
+
+// Record layout (big-endian, byte offsets):
+//   0-3 timestamp_us | 4-6 X | 7-9 Y | 10-12 Z (signed 24-bit, 10um) | 13-16 status word | 17 LED | 18 TCM
+struct DataSetColumns
+{
+    std::vector<uint32_t> timestamp_us;
+    std::vector<int32_t>  x; // units of 10um
+    std::vector<int32_t>  y;
+    std::vector<int32_t>  z;
+    std::vector<uint32_t> statusWord;
+    std::vector<uint8_t>  ledId; // 1-64
+    std::vector<uint8_t>  tcmId; // 1-8
+
+    // Status word fields
+    std::vector<uint8_t> endOfFrame;      // E
+    std::vector<uint8_t> coordStatus;     // HHH
+    std::vector<uint8_t> ambientLight;    // mmmm
+    std::vector<uint8_t> rightEyeSignal;  // La
+    std::vector<uint8_t> rightEyeStatus;  // AAAA
+    std::vector<uint8_t> centerEyeSignal; // Lb
+    std::vector<uint8_t> centerEyeStatus; // BBBB
+    std::vector<uint8_t> leftEyeSignal;   // Lc
+    std::vector<uint8_t> leftEyeStatus;   // CCCC
+    std::vector<uint8_t> triggerIndex;    // TTT:TTT
+
+    size_t size() const { return timestamp_us.size(); }
+    void   resize(size_t n);
+    void   clear() { resize(0); }
+};
+
+enum class DataSetKernel
+{
+    Scalar,
+    Sse41, // 4 records per step: pshufb gather, 4x4 transpose, vector field extraction
+    Avx2   // 8 records per step
+};
+
+// Fastest kernel the CPU supports
+DataSetKernel bestDataSetKernel();
+
+// Append `count` records starting at `records` (count * 19 bytes) to `out`.
+void decodeDataSets(const uint8_t *records, size_t count, DataSetColumns &out);
+
+// Same with an explicit kernel (lowered to bestDataSetKernel() if unsupported); used to cross-check the kernels.
+void decodeDataSets(const uint8_t *records, size_t count, DataSetColumns &out, DataSetKernel kernel);
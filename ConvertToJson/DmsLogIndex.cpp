@@ -0,0 +1,109 @@
+#include "DmsLogIndex.h"
+#include "FileFormat.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// Sidecar layout (little-endian):
+//   char[8]  magic "DMSIDX\0\0"
+//   uint32   version
+//   uint32   entry size (17)
+//   uint64   capture size in bytes
+//   int64    capture modification time
+//   uint64   entry count
+//   entries: uint64 offset, uint64 FILETIME, uint8 TX flag
+static const char     kIndexMagic[8]   = {'D', 'M', 'S', 'I', 'D', 'X', 0, 0};
+static const uint32_t kIndexVersion    = 1;
+static const uint32_t kIndexEntrySize  = 17;
+static const size_t   kIndexHeaderSize = 40;
+
+std::string DmsLogIndex::sidecarPath(const std::string &capturePath)
+{
+    size_t dotPos = capturePath.rfind(".dmslog");
+    if (dotPos != std::string::npos)
+        return capturePath.substr(0, dotPos) + ".dmsidx";
+    return capturePath + ".dmsidx";
+}
+
+bool DmsLogIndex::load(const std::string &indexPath, uint64_t sourceSize, int64_t sourceTime)
+{
+    clear();
+
+    std::ifstream file(indexPath, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    uint8_t hdr[kIndexHeaderSize];
+    if (!file.read(reinterpret_cast<char *>(hdr), sizeof(hdr)))
+        return false;
+    if (std::memcmp(hdr, kIndexMagic, sizeof(kIndexMagic)) != 0 || getLE(hdr + 8, 4) != kIndexVersion || getLE(hdr + 12, 4) != kIndexEntrySize)
+        return false;
+    if (getLE(hdr + 16, 8) != sourceSize || static_cast<int64_t>(getLE(hdr + 24, 8)) != sourceTime)
+        return false;
+
+    // Every serial record is at least 42 bytes in the capture, which bounds a sane entry count
+    uint64_t count = getLE(hdr + 32, 8);
+    if (count > sourceSize / 42)
+        return false;
+
+    std::vector<uint8_t> raw(static_cast<size_t>(count) * kIndexEntrySize);
+    if (!file.read(reinterpret_cast<char *>(raw.data()), static_cast<std::streamsize>(raw.size())))
+        return false;
+
+    m_entries.reserve(static_cast<size_t>(count));
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t *p = raw.data() + i * kIndexEntrySize;
+        add(getLE(p, 8), getLE(p + 8, 8), p[16] != 0);
+    }
+    return true;
+}
+
+bool DmsLogIndex::save(const std::string &indexPath, uint64_t sourceSize, int64_t sourceTime) const
+{
+    std::vector<uint8_t> raw(kIndexHeaderSize + m_entries.size() * kIndexEntrySize);
+    uint8_t             *p = raw.data();
+    std::memcpy(p, kIndexMagic, sizeof(kIndexMagic));
+    putLE(p + 8, kIndexVersion, 4);
+    putLE(p + 12, kIndexEntrySize, 4);
+    putLE(p + 16, sourceSize, 8);
+    putLE(p + 24, static_cast<uint64_t>(sourceTime), 8);
+    putLE(p + 32, m_entries.size(), 8);
+
+    p += kIndexHeaderSize;
+    for (const auto &e : m_entries)
+    {
+        putLE(p, e.offset, 8);
+        putLE(p + 8, e.timestamp, 8);
+        p[16] = e.isTx;
+        p += kIndexEntrySize;
+    }
+
+    std::ofstream file(indexPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file.write(reinterpret_cast<const char *>(raw.data()), static_cast<std::streamsize>(raw.size()));
+    return file.good();
+}
+
+void DmsLogIndex::clear()
+{
+    m_entries.clear();
+    m_sorted = true;
+}
+
+void DmsLogIndex::add(uint64_t offset, uint64_t timestamp, bool isTx)
+{
+    if (!m_entries.empty() && timestamp < m_entries.back().timestamp)
+        m_sorted = false;
+    m_entries.push_back({offset, timestamp, static_cast<uint8_t>(isTx ? 1 : 0)});
+}
+
+size_t DmsLogIndex::lowerBound(uint64_t filetime) const
+{
+    auto before = [filetime](const DmsLogIndexEntry &e) { return e.timestamp < filetime; };
+    if (m_sorted)
+        return static_cast<size_t>(std::partition_point(m_entries.begin(), m_entries.end(), before) - m_entries.begin());
+    return static_cast<size_t>(std::find_if_not(m_entries.begin(), m_entries.end(), before) - m_entries.begin());
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One serial data record in a .dmsidx index.
+struct DmsLogIndexEntry
+{
+    uint64_t offset;    // file offset of the IRP record header
+    uint64_t timestamp; // Windows FILETIME of the record
+    uint8_t  isTx;      // 1 = TX (WRITE REQUEST), 0 = RX (READ COMPLETION)
+};
+
+// Record index stored as a sidecar next to a capture ("<name>.dmsidx").
+// The sidecar records the size and modification time of the capture it was built from
+// and is ignored when either no longer matches.
+class DmsLogIndex
+{
+  public:
+    // Sidecar path for a capture: the .dmslog* extension is replaced by .dmsidx
+    static std::string sidecarPath(const std::string &capturePath);
+
+    // Load the sidecar; fails if it is missing, damaged or stale.
+    bool load(const std::string &indexPath, uint64_t sourceSize, int64_t sourceTime);
+    bool save(const std::string &indexPath, uint64_t sourceSize, int64_t sourceTime) const;
+
+    void clear();
+    void add(uint64_t offset, uint64_t timestamp, bool isTx);
+
+    const std::vector<DmsLogIndexEntry> &entries() const { return m_entries; }
+
+    // True when timestamps never decrease in file order (binary search is possible)
+    bool isSorted() const { return m_sorted; }
+
+    // Index of the first entry in file order with timestamp >= `filetime` (entries().size() if none)
+    size_t lowerBound(uint64_t filetime) const;
+
+  private:
+    std::vector<DmsLogIndexEntry> m_entries;
+    bool                          m_sorted = true;
+};
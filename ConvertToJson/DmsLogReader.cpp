@@ -1,8 +1,17 @@
 #include "DmsLogReader.h"
+#include "FileFormat.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
-#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DMSLOG_SCAN_SSE2 1
+#endif
 
 // Expected file-format GUID: {3423D0D9-F6E4-49E9-9F1C-E2D7953CA8EA}
 static const uint8_t kFileGuid[16] = {0xD9, 0xD0, 0x23, 0x34, 0xE4, 0xF6, 0xE9, 0x49, 0x9F, 0x1C, 0xE2, 0xD7, 0x95, 0x3C, 0xA8, 0xEA};
@@ -28,6 +37,28 @@ static bool tsHighMatches(uint32_t candidate, uint32_t session, uint32_t toleran
     return diff <= tolerance;
 }
 
+// Helper: check the fixed fields of a 24-byte IRP record header.
+static bool isRecordHeader(const uint8_t *p, uint32_t tsHigh)
+{
+    uint32_t tsAHi   = readU32LE(p + 4);
+    uint32_t recSize = readU32LE(p + 8);
+    uint32_t recType = readU32LE(p + 12) & 0x7FFFFFFF;
+    return tsHighMatches(tsAHi, tsHigh) && recSize >= 24 && recSize <= 10000 && recType >= 1 && recType <= 3;
+}
+
+// Resync gives up when no record header follows within this many bytes.
+static const uint64_t kResyncWindow = 5000;
+
+// One byte range of a parallel parse and the speculative walk through it.
+struct ParseChunk
+{
+    uint64_t               begin = 0;
+    uint64_t               end   = 0;
+    uint64_t               exit  = 0; // walk position after leaving the range (file size at end of data)
+    std::vector<uint64_t>  steps;     // walk positions inside the range, ascending
+    std::vector<IrpRecord> records;
+};
+
 // Helper: read a UTF-16LE string of given char count from a byte buffer.
 static std::string utf16leToAscii(const uint8_t *p, size_t charCount)
 {
@@ -49,39 +80,76 @@ static std::string utf16leToAscii(const uint8_t *p, size_t charCount)
 bool DmsLogReader::open(const std::string &path)
 {
     m_path = path;
-    m_file.open(path, std::ios::binary);
-    if (!m_file.is_open())
+    m_error.clear();
+    if (m_map.open(path))
     {
-        std::cerr << "Error: cannot open file: " << path << "\n";
-        return false;
+        m_data     = m_map.data();
+        m_fileSize = m_map.size();
+    }
+    else
+    {
+        // Mapping failed (e.g. unsupported file system) - fall back to reading the whole file
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+        {
+            m_error = "cannot open file: " + path;
+            return false;
+        }
+        m_fileSize = static_cast<uint64_t>(file.tellg());
+        m_buffer.resize(static_cast<size_t>(m_fileSize));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+        if (!file.good())
+        {
+            m_error = "cannot read file: " + path;
+            return false;
+        }
+        m_data = m_buffer.data();
     }
 
-    m_file.seekg(0, std::ios::end);
-    m_fileSize = static_cast<uint64_t>(m_file.tellg());
-    m_file.seekg(0);
+    return readHeader();
+}
 
-    if (!readHeader())
-        return false;
-    readSessionMetadata();
-    scanForPortConfig();
-    return true;
+const DmsLogHeader &DmsLogReader::header()
+{
+    deviceName();
+    portConfig();
+    return m_header;
+}
+
+const std::string &DmsLogReader::deviceName()
+{
+    if (!m_deviceNameLoaded)
+    {
+        m_deviceNameLoaded = true;
+        readSessionMetadata();
+    }
+    return m_header.deviceName;
+}
+
+const std::string &DmsLogReader::portConfig()
+{
+    if (!m_portConfigLoaded)
+    {
+        m_portConfigLoaded = true;
+        scanForPortConfig();
+    }
+    return m_header.portConfig;
 }
 
 bool DmsLogReader::readHeader()
 {
-    uint8_t buf[48];
-    m_file.seekg(0);
-    m_file.read(reinterpret_cast<char *>(buf), 48);
-    if (!m_file.good())
+    if (m_fileSize < 48)
     {
-        std::cerr << "Error: file too small for header\n";
+        m_error = "file too small for header";
         return false;
     }
+    const uint8_t *buf = m_data;
 
     // Validate GUID
     if (std::memcmp(buf, kFileGuid, 16) != 0)
     {
-        std::cerr << "Error: invalid dmslog8 file signature\n";
+        m_error = "invalid dmslog8 file signature";
         return false;
     }
 
@@ -100,9 +168,17 @@ bool DmsLogReader::readSessionMetadata()
     if (m_fileSize < metaOffset + 256)
         return false;
 
-    std::vector<uint8_t> buf(0x2000);
-    m_file.seekg(metaOffset);
-    m_file.read(reinterpret_cast<char *>(buf.data()), buf.size());
+    // Metadata block is at most 8 KB; missing bytes past the end of the file read as zero.
+    // Parse in place unless the file ends inside the block.
+    const size_t         metaSize = 0x2000;
+    ByteView             buf(m_data + metaOffset, metaSize);
+    std::vector<uint8_t> padded;
+    if (m_fileSize - metaOffset < metaSize)
+    {
+        padded.assign(metaSize, 0);
+        std::memcpy(padded.data(), m_data + metaOffset, static_cast<size_t>(m_fileSize - metaOffset));
+        buf = ByteView(padded.data(), padded.size());
+    }
 
     // Skip two GUIDs (32 bytes) + flags (8 bytes) + FILETIME (8 bytes) = offset 0x30
     size_t pos = 0x30;
@@ -142,21 +218,23 @@ bool DmsLogReader::scanForPortConfig()
     if (m_fileSize < scanStart + 64)
         return false;
 
-    size_t               scanLen = static_cast<size_t>(scanEnd - scanStart);
-    std::vector<uint8_t> buf(scanLen);
-    m_file.seekg(scanStart);
-    m_file.read(reinterpret_cast<char *>(buf.data()), scanLen);
+    ByteView buf(m_data + scanStart, static_cast<size_t>(scanEnd - scanStart));
 
     // Search for "parity: " in UTF-16LE as anchor - it's at the end of each config string
     // and lets us extract the full string backwards to the baud rate.
-    const uint8_t parityNeedle[] = {'p', 0, 'a', 0, 'r', 0, 'i', 0, 't', 0, 'y', 0, ':', 0, ' ', 0};
-    const size_t  needleLen      = sizeof(parityNeedle);
+    static const uint8_t parityNeedle[] = {'p', 0, 'a', 0, 'r', 0, 'i', 0, 't', 0, 'y', 0, ':', 0, ' ', 0};
+    const size_t         needleLen      = sizeof(parityNeedle);
+
+    const std::boyer_moore_horspool_searcher<const uint8_t *> searcher(parityNeedle, parityNeedle + needleLen);
 
     std::string bestConfig;
 
-    for (size_t i = 0; i + needleLen < buf.size(); i += 2)
+    // Matches must start at an even offset and leave at least one byte after the needle
+    const uint8_t *searchEnd = buf.end() - 1;
+    for (const uint8_t *hit = std::search(buf.begin(), searchEnd, searcher); hit != searchEnd; hit = std::search(hit + 1, searchEnd, searcher))
     {
-        if (std::memcmp(buf.data() + i, parityNeedle, needleLen) != 0)
+        size_t i = static_cast<size_t>(hit - buf.begin());
+        if (i % 2 != 0)
             continue;
 
         // Found "parity: " - read forward to get the parity value (e.g. "None")
@@ -209,19 +287,16 @@ bool DmsLogReader::scanForPortConfig()
         // Check if the leading digit makes the baud rate unreasonably high (>10M).
         // Standard serial baud rates are at most a few million. If >10M, the first
         // digit is likely a stray byte from the DMS structure.
-        std::string baudStr;
+        // Leading digits, ignoring thousands separators; saturates instead of overflowing.
+        uint64_t baudVal = 0;
         for (size_t k = baudStart; k < dbPos; ++k)
         {
-            if (config[k] != ',')
-                baudStr += config[k];
-        }
-        long long baudVal = 0;
-        try
-        {
-            baudVal = std::stoll(baudStr);
-        }
-        catch (...)
-        {
+            char c = config[k];
+            if (c == ',')
+                continue;
+            if (c < '0' || c > '9')
+                break;
+            baudVal = std::min<uint64_t>(baudVal * 10 + uint64_t(c - '0'), 1ULL << 40);
         }
         if (baudVal > 10000000 && baudStart < dbPos)
         {
@@ -269,143 +344,444 @@ bool DmsLogReader::scanForPortConfig()
 }
 
 bool DmsLogReader::findFirstRecord(uint64_t &outOffset)
+{
+    bool complete = false;
+    if (locateFirstRecord(outOffset, complete))
+        return true;
+
+    m_error = "could not find first IRP record";
+    return false;
+}
+
+bool DmsLogReader::locateFirstRecord(uint64_t &outOffset, bool &complete) const
 {
     // IRP records start after the device configuration block, around offset 0x13000-0x13200.
     // Scan forward from the data section looking for valid record chains.
     const uint64_t scanStart = m_header.dataOffset + 0x1000; // ~0x13000
-    const uint64_t scanEnd   = std::min(m_fileSize, scanStart + 0x2000);
+    const uint64_t scanEnd   = scanStart + 0x2000;
 
-    uint8_t buf[48];
-
-    for (uint64_t pos = scanStart; pos < scanEnd; ++pos)
+    if (findRecordHeader(scanStart, std::min(m_fileSize, scanEnd), outOffset))
     {
-        m_file.seekg(pos);
-        m_file.read(reinterpret_cast<char *>(buf), 48);
-        if (!m_file.good())
-            break;
-
-        uint64_t tsA       = readU64LE(buf);
-        uint32_t recSize   = readU32LE(buf + 8);
-        uint32_t typeFlags = readU32LE(buf + 12);
-        uint32_t tsAHi     = static_cast<uint32_t>(tsA >> 32);
-        uint32_t recType   = typeFlags & 0x7FFFFFFF;
+        complete = successorWritten(outOffset);
+        return true;
+    }
+    complete = scanEnd + 23 <= m_fileSize;
+    return false;
+}
 
-        if (!tsHighMatches(tsAHi, m_tsHigh) || recSize < 24 || recSize > 10000 || recType < 1 || recType > 3)
-            continue;
+bool DmsLogReader::successorWritten(uint64_t pos) const
+{
+    return pos + readU32LE(m_data + pos + 8) + 24 <= m_fileSize;
+}
 
-        // Validate: the next record at pos+recSize should also be valid
-        uint64_t nextPos = pos + recSize;
-        if (nextPos + 24 > m_fileSize)
-            continue;
+bool DmsLogReader::isChainedRecord(uint64_t pos) const
+{
+    const uint8_t *hdr = m_data + pos;
+    if (!isRecordHeader(hdr, m_tsHigh))
+        return false;
 
-        m_file.seekg(nextPos);
-        m_file.read(reinterpret_cast<char *>(buf), 24);
-        if (!m_file.good())
-            continue;
+    // The record must be followed by another valid header, or run into the end of the data
+    uint64_t nextPos = pos + readU32LE(hdr + 8);
+    return nextPos + 24 > m_fileSize || isRecordHeader(m_data + nextPos, m_tsHigh);
+}
 
-        uint64_t tsA2       = readU64LE(buf);
-        uint32_t recSize2   = readU32LE(buf + 8);
-        uint32_t typeFlags2 = readU32LE(buf + 12);
-        uint32_t recType2   = typeFlags2 & 0x7FFFFFFF;
+bool DmsLogReader::findRecordHeader(uint64_t from, uint64_t limit, uint64_t &outOffset) const
+{
+    if (m_fileSize < 24)
+        return false;
+    limit        = std::min(limit, m_fileSize - 23); // a header needs 24 bytes
+    uint64_t pos = from;
+
+#ifdef DMSLOG_SCAN_SSE2
+    // Candidate filter, 16 offsets per step: bytes 6-7 of a header are the upper 16 bits of the
+    // timestamp high word (at most two values within the tolerance), byte 11 is the top byte of
+    // the record size (always 0). Only candidates get the full header check and chain confirmation.
+    const uint32_t tsLow  = m_tsHigh >= 2 ? m_tsHigh - 2 : 0;
+    const uint32_t tsHigh = m_tsHigh + 2;
+    const __m128i  lo6    = _mm_set1_epi8(static_cast<char>(tsLow >> 16));
+    const __m128i  lo7    = _mm_set1_epi8(static_cast<char>(tsLow >> 24));
+    const __m128i  hi6    = _mm_set1_epi8(static_cast<char>(tsHigh >> 16));
+    const __m128i  hi7    = _mm_set1_epi8(static_cast<char>(tsHigh >> 24));
+    const __m128i  zero   = _mm_setzero_si128();
+
+    for (; pos + 16 <= limit; pos += 16)
+    {
+        const uint8_t *p     = m_data + pos;
+        __m128i        b6    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 6));
+        __m128i        b7    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 7));
+        __m128i        b11   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 11));
+        __m128i        isLo  = _mm_and_si128(_mm_cmpeq_epi8(b6, lo6), _mm_cmpeq_epi8(b7, lo7));
+        __m128i        isHi  = _mm_and_si128(_mm_cmpeq_epi8(b6, hi6), _mm_cmpeq_epi8(b7, hi7));
+        __m128i        match = _mm_and_si128(_mm_or_si128(isLo, isHi), _mm_cmpeq_epi8(b11, zero));
+
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(match));
+        for (unsigned bit = 0; mask != 0; ++bit, mask >>= 1)
+        {
+            if ((mask & 1) && isChainedRecord(pos + bit))
+            {
+                outOffset = pos + bit;
+                return true;
+            }
+        }
+    }
+#endif
 
-        if (tsHighMatches(static_cast<uint32_t>(tsA2 >> 32), m_tsHigh) && recSize2 >= 24 && recSize2 <= 10000 && recType2 >= 1 && recType2 <= 3)
+    for (; pos < limit; ++pos)
+    {
+        if (isChainedRecord(pos))
         {
             outOffset = pos;
             return true;
         }
     }
-
-    std::cerr << "Error: could not find first IRP record\n";
     return false;
 }
 
-bool DmsLogReader::readRecords(std::vector<IrpRecord> &records)
+RecordCursor::RecordCursor(const DmsLogReader &reader, uint64_t startOffset, bool valid, bool follow)
+    : m_reader(&reader), m_pos(startOffset), m_done(!valid && !follow), m_follow(follow), m_located(valid)
+{
+}
+
+bool RecordCursor::next(IrpRecord &rec)
 {
-    uint64_t pos;
-    if (!findFirstRecord(pos))
+    if (m_done)
         return false;
 
-    std::vector<uint8_t> buf;
+    if (!m_located)
+    {
+        // Follow mode: wait until the first record and its successor are written
+        bool complete = false;
+        bool found    = m_reader->locateFirstRecord(m_pos, complete);
+        if (!complete)
+            return false;
+        if (!found)
+        {
+            m_reader->m_error = "could not find first IRP record";
+            m_done            = true;
+            return false;
+        }
+        m_located = true;
+    }
+
+    switch (m_reader->nextRecord(m_pos, rec, m_follow))
+    {
+        case DmsLogReader::StepResult::Record:
+            return true;
+        case DmsLogReader::StepResult::End:
+            m_done = true;
+            return false;
+        default:
+            return false; // Incomplete - resume here after refresh()
+    }
+}
 
-    while (pos + 24 <= m_fileSize)
+RecordCursor DmsLogReader::cursor()
+{
+    if (!m_firstRecordSearch)
     {
-        uint8_t hdr[24];
-        m_file.seekg(pos);
-        m_file.read(reinterpret_cast<char *>(hdr), 24);
-        if (!m_file.good())
+        m_firstRecordSearch = true;
+        m_firstRecordFound  = findFirstRecord(m_firstRecord);
+    }
+    return RecordCursor(*this, m_firstRecord, m_firstRecordFound);
+}
+
+RecordCursor DmsLogReader::followCursor()
+{
+    return RecordCursor(*this, 0, false, true);
+}
+
+bool DmsLogReader::refresh()
+{
+    std::error_code ec;
+    uint64_t        size = std::filesystem::file_size(m_path, ec);
+    if (ec || size <= m_fileSize)
+        return false;
+
+    if (m_map.isOpen())
+    {
+        // Map the grown file first so the old mapping stays valid if that fails
+        MappedFile grown;
+        if (!grown.open(m_path) || grown.size() <= m_fileSize)
+            return false;
+        m_map.swap(grown);
+        m_data     = m_map.data();
+        m_fileSize = m_map.size();
+    }
+    else
+    {
+        // Fallback storage - read just the appended bytes
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        std::vector<uint8_t> tail(static_cast<size_t>(size - m_fileSize));
+        file.seekg(static_cast<std::streamoff>(m_fileSize));
+        file.read(reinterpret_cast<char *>(tail.data()), static_cast<std::streamsize>(tail.size()));
+        tail.resize(static_cast<size_t>(file.gcount()));
+        if (tail.empty())
+            return false;
+        m_buffer.insert(m_buffer.end(), tail.begin(), tail.end());
+        m_data     = m_buffer.data();
+        m_fileSize = m_buffer.size();
+    }
+
+    // Results derived from the shorter file are stale
+    m_indexLoaded = false;
+    if (!m_firstRecordFound)
+        m_firstRecordSearch = false;
+    return true;
+}
+
+size_t DmsLogReader::forEachRecord(const std::function<bool(const IrpRecord &)> &fn)
+{
+    RecordCursor cur   = cursor();
+    size_t       count = 0;
+    IrpRecord    rec;
+    while (cur.next(rec))
+    {
+        ++count;
+        if (!fn(rec))
             break;
+    }
+    return count;
+}
 
-        uint64_t tsA          = readU64LE(hdr);
-        uint32_t recSize      = readU32LE(hdr + 8);
-        uint32_t typeFlags    = readU32LE(hdr + 12);
-        uint64_t tsB          = readU64LE(hdr + 16);
-        uint32_t tsAHi        = static_cast<uint32_t>(tsA >> 32);
-        uint32_t recType      = typeFlags & 0x7FFFFFFF;
-        bool     isCompletion = (typeFlags >> 31) & 1;
+bool DmsLogReader::readRecords(std::vector<IrpRecord> &records)
+{
+    forEachRecord(
+        [&](const IrpRecord &rec)
+        {
+            records.push_back(rec);
+            return true;
+        });
+    return !records.empty();
+}
 
-        if (tsHighMatches(tsAHi, m_tsHigh) && recSize >= 24 && recSize <= 10000 && recType >= 1 && recType <= 3)
+bool DmsLogReader::loadIndex()
+{
+    if (m_indexLoaded)
+        return !m_index.entries().empty();
+
+    const std::string indexPath = DmsLogIndex::sidecarPath(m_path);
+    const int64_t     modTime   = fileModificationTime(m_path);
+    if (!m_index.load(indexPath, m_fileSize, modTime))
+    {
+        // Missing or stale - rebuild with one pass. Failing to save (e.g. read-only folder) is not an error.
+        m_index.clear();
+        forEachRecord(
+            [this](const IrpRecord &rec)
+            {
+                m_index.add(rec.fileOffset, rec.timestamp, rec.isTx());
+                return true;
+            });
+        m_index.save(indexPath, m_fileSize, modTime);
+    }
+    m_indexLoaded = true;
+    return !m_index.entries().empty();
+}
+
+RecordCursor DmsLogReader::seek(uint64_t filetime)
+{
+    if (!loadIndex())
+        return RecordCursor(*this, m_fileSize, false);
+
+    const auto  &entries = m_index.entries();
+    const size_t i       = m_index.lowerBound(filetime);
+    if (i == entries.size())
+        return RecordCursor(*this, m_fileSize, false);
+    return RecordCursor(*this, entries[i].offset, true);
+}
+
+bool DmsLogReader::readRange(uint64_t t0, uint64_t t1, std::vector<IrpRecord> &records)
+{
+    if (!loadIndex())
+        return false;
+
+    const auto &entries = m_index.entries();
+    size_t      i       = m_index.lowerBound(t0);
+    IrpRecord   rec;
+    for (; i < entries.size(); ++i)
+    {
+        const auto &e = entries[i];
+        if (e.timestamp >= t1)
         {
-            // Valid record
-            uint32_t payloadSize = recSize - 24;
-            buf.resize(payloadSize);
-            m_file.read(reinterpret_cast<char *>(buf.data()), payloadSize);
+            if (m_index.isSorted())
+                break;
+            continue;
+        }
+        if (e.timestamp < t0)
+            continue;
+
+        uint64_t pos = e.offset;
+        if (parseStep(pos, rec) == StepResult::Record)
+            records.push_back(rec);
+    }
+    return !records.empty();
+}
+
+bool DmsLogReader::readRecordsParallel(std::vector<IrpRecord> &records, unsigned threadCount, uint64_t minChunkBytes)
+{
+    cursor(); // locates the first record once
+    if (!m_firstRecordFound)
+        return false;
 
-            if (recType == 1 && payloadSize > 17)
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    const uint64_t first      = m_firstRecord;
+    const uint64_t span       = m_fileSize - first;
+    const size_t   chunkCount = static_cast<size_t>(std::min<uint64_t>(uint64_t(threadCount) * 4, span / std::max<uint64_t>(minChunkBytes, 1)));
+    if (threadCount == 1 || chunkCount < 2)
+        return readRecords(records);
+
+    std::vector<ParseChunk> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        chunks[i].begin = first + span * i / chunkCount;
+        chunks[i].end   = first + span * (i + 1) / chunkCount;
+    }
+
+    // Walk every range independently. The first range starts at the known first record; the others
+    // resync at their start and may begin off the serial walk, which the stitching below corrects.
+    std::atomic<size_t> nextChunk(0);
+    auto                worker = [&]()
+    {
+        for (size_t i = nextChunk++; i < chunkCount; i = nextChunk++)
+        {
+            ParseChunk &chunk = chunks[i];
+            uint64_t    pos   = chunk.begin;
+            if (i > 0 && !findRecordHeader(chunk.begin, chunk.end, pos))
             {
-                uint32_t funcCode  = readU32LE(buf.data() + 5);
-                size_t   serialLen = payloadSize - 17;
+                chunk.exit = chunk.end;
+                continue;
+            }
+
+            IrpRecord rec;
+            while (pos < chunk.end)
+            {
+                chunk.steps.push_back(pos);
+                if (parseStep(pos, rec) == StepResult::Record)
+                    chunk.records.push_back(rec);
+            }
+            chunk.exit = pos;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < std::min<size_t>(threadCount, chunkCount); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads)
+        t.join();
+
+    // Stitch: follow the serial walk through the ranges. The walk is deterministic, so once it lands
+    // on a position a range walk visited, the rest of that range's records are exactly the serial ones.
+    uint64_t  pos = first;
+    IrpRecord rec;
+    for (const ParseChunk &chunk : chunks)
+    {
+        while (pos < chunk.end && !std::binary_search(chunk.steps.begin(), chunk.steps.end(), pos))
+        {
+            if (parseStep(pos, rec) == StepResult::Record)
+                records.push_back(rec);
+        }
+        if (pos >= chunk.end)
+            continue;
+
+        auto from = std::lower_bound(chunk.records.begin(), chunk.records.end(), pos, [](const IrpRecord &r, uint64_t off) { return r.fileOffset < off; });
+        records.insert(records.end(), from, chunk.records.end());
+        pos = chunk.exit;
+    }
+
+    return !records.empty();
+}
+
+DmsLogReader::StepResult DmsLogReader::nextRecord(uint64_t &pos, IrpRecord &rec, bool follow) const
+{
+    for (;;)
+    {
+        StepResult result = parseStep(pos, rec, follow);
+        if (result != StepResult::Skipped)
+            return result;
+    }
+}
 
-                bool isTx          = (funcCode == 4 && !isCompletion && serialLen > 0);
-                bool isRx          = (funcCode == 3 && isCompletion && serialLen > 0);
+DmsLogReader::StepResult DmsLogReader::parseStep(uint64_t &pos, IrpRecord &rec, bool follow) const
+{
+    if (pos + 24 <= m_fileSize)
+    {
+        const uint8_t *hdr          = m_data + pos;
+        uint64_t       tsA          = readU64LE(hdr);
+        uint32_t       recSize      = readU32LE(hdr + 8);
+        uint32_t       typeFlags    = readU32LE(hdr + 12);
+        uint64_t       tsB          = readU64LE(hdr + 16);
+        uint32_t       tsAHi        = static_cast<uint32_t>(tsA >> 32);
+        uint32_t       recType      = typeFlags & 0x7FFFFFFF;
+        bool           isCompletion = (typeFlags >> 31) & 1;
 
-                if (isTx || isRx)
+        if (tsHighMatches(tsAHi, m_tsHigh) && recSize >= 24 && recSize <= 10000 && recType >= 1 && recType <= 3)
+        {
+            // Valid record - stop at a record truncated by the end of the file
+            if (pos + recSize <= m_fileSize)
+            {
+                uint32_t       payloadSize = recSize - 24;
+                const uint8_t *payload     = hdr + 24;
+
+                if (recType == 1 && payloadSize > 17)
                 {
-                    IrpRecord rec;
-                    rec.timestamp    = tsA;
-                    rec.recordSize   = recSize;
-                    rec.typeFlags    = typeFlags;
-                    rec.timestampB   = tsB;
-                    rec.recordType   = static_cast<int>(recType);
-                    rec.isCompletion = isCompletion;
-                    rec.ntstatus     = readU32LE(buf.data());
-                    rec.infoByte     = buf[4];
-                    rec.functionCode = funcCode;
-                    rec.serialData.assign(buf.begin() + 9, buf.begin() + 9 + serialLen);
-                    records.push_back(std::move(rec));
+                    uint32_t funcCode  = readU32LE(payload + 5);
+                    size_t   serialLen = payloadSize - 17;
+
+                    bool isTx          = (funcCode == 4 && !isCompletion && serialLen > 0);
+                    bool isRx          = (funcCode == 3 && isCompletion && serialLen > 0);
+
+                    if (isTx || isRx)
+                    {
+                        rec.fileOffset   = pos;
+                        rec.timestamp    = tsA;
+                        rec.recordSize   = recSize;
+                        rec.typeFlags    = typeFlags;
+                        rec.timestampB   = tsB;
+                        rec.recordType   = static_cast<int>(recType);
+                        rec.isCompletion = isCompletion;
+                        rec.ntstatus     = readU32LE(payload);
+                        rec.infoByte     = payload[4];
+                        rec.functionCode = funcCode;
+                        rec.serialData   = ByteView(payload + 9, serialLen);
+                        pos += recSize;
+                        return StepResult::Record;
+                    }
                 }
-            }
 
-            pos += recSize;
+                pos += recSize;
+                return StepResult::Skipped;
+            }
         }
         else
         {
             // Not a valid record header - scan forward for next valid record.
             // This handles metadata gaps and 8-byte sequence markers.
-            bool     found     = false;
-            uint64_t scanLimit = std::min(pos + 5000, m_fileSize - 24);
-            for (uint64_t scan = pos + 1; scan < scanLimit; ++scan)
+            uint64_t next = 0;
+            if (findRecordHeader(pos + 1, pos + kResyncWindow, next))
             {
-                m_file.seekg(scan);
-                m_file.read(reinterpret_cast<char *>(hdr), 24);
-                if (!m_file.good())
-                    break;
-
-                uint64_t tsCheck = readU64LE(hdr);
-                uint32_t rsCheck = readU32LE(hdr + 8);
-                uint32_t tfCheck = readU32LE(hdr + 12);
-                uint32_t rtCheck = tfCheck & 0x7FFFFFFF;
-
-                if (tsHighMatches(static_cast<uint32_t>(tsCheck >> 32), m_tsHigh) && rsCheck >= 24 && rsCheck <= 10000 && rtCheck >= 1 && rtCheck <= 3)
-                {
-                    pos   = scan;
-                    found = true;
-                    break;
-                }
+                // When following, a candidate confirmed only by the end of the data is not final yet
+                if (follow && !successorWritten(next))
+                    return StepResult::Incomplete;
+                pos = next;
+                return StepResult::Skipped;
             }
-            if (!found)
-                break;
+            if (follow && pos + kResyncWindow + 23 > m_fileSize)
+                return StepResult::Incomplete;
+
+            pos = m_fileSize;
+            return StepResult::End;
         }
     }
 
-    return !records.empty();
+    // Header or record cut off by the end of the data; when following, the rest may still be written
+    if (follow)
+        return StepResult::Incomplete;
+
+    // Park the position at the end so further calls return immediately
+    pos = m_fileSize;
+    return StepResult::End;
 }
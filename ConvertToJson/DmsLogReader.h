@@ -1,14 +1,19 @@
 #pragma once
 
+#include "ByteView.h"
+#include "DmsLogIndex.h"
+#include "MappedFile.h"
+
 #include <cstdint>
-#include <fstream>
+#include <functional>
 #include <string>
 #include <vector>
 
 // A single IRP record extracted from a dmslog8 file.
 struct IrpRecord
 {
-    uint64_t timestamp; // Windows FILETIME (100ns intervals since 1601-01-01)
+    uint64_t fileOffset; // offset of the record header in the file
+    uint64_t timestamp;  // Windows FILETIME (100ns intervals since 1601-01-01)
     uint32_t recordSize;
     uint32_t typeFlags;
     uint64_t timestampB;
@@ -18,10 +23,13 @@ struct IrpRecord
     bool isCompletion; // false=REQUEST, true=COMPLETION
 
     // Parsed from payload (valid when recordType==1 and payload is large enough)
-    uint32_t             ntstatus;
-    uint8_t              infoByte;
-    uint32_t             functionCode; // 3=IRP_MJ_READ, 4=IRP_MJ_WRITE (for type 1)
-    std::vector<uint8_t> serialData;
+    uint32_t ntstatus;
+    uint8_t  infoByte;
+    uint32_t functionCode; // 3=IRP_MJ_READ, 4=IRP_MJ_WRITE (for type 1)
+    ByteView serialData;   // points into the reader's file mapping; valid while the reader is open
+
+    // TX = WRITE REQUEST (host -> device); everything else returned by the reader is an RX READ COMPLETION
+    bool isTx() const { return functionCode == 4 && !isCompletion; }
 };
 
 // Metadata from the dmslog8 file header.
@@ -34,30 +42,133 @@ struct DmsLogHeader
     std::string portConfig; // e.g. "2,500,000, data bits: 8, stop bits: 1, parity: None"
 };
 
+class DmsLogReader;
+
+// Pull-style iterator over the serial data records of an open DmsLogReader.
+// Yields the same records as readRecords(), one at a time and in file order,
+// without materializing them. Copies are cheap; each copy iterates independently.
+//
+// A follow cursor (DmsLogReader::followCursor()) treats the end of the data as "not written yet":
+// next() returns false without finishing and resumes from the last complete record after
+// DmsLogReader::refresh() has picked up appended bytes.
+class RecordCursor
+{
+  public:
+    RecordCursor(const DmsLogReader &reader, uint64_t startOffset, bool valid, bool follow = false);
+
+    // Advance to the next TX/RX record. Returns false at the end of the data.
+    bool next(IrpRecord &rec);
+
+    // True once the walk cannot continue, even if the file grows
+    bool finished() const { return m_done; }
+
+  private:
+    const DmsLogReader *m_reader;
+    uint64_t            m_pos;
+    bool                m_done;
+    bool                m_follow;
+    bool                m_located; // m_pos is on the record walk (follow cursors locate the first record lazily)
+};
+
 class DmsLogReader
 {
   public:
-    // Open a dmslog8 file and parse header/metadata.
+    // Open a dmslog8 file and parse the fixed header.
+    // The whole file is memory-mapped once; records are parsed directly from the mapping.
+    // Device name and port config are only decoded when first asked for.
     bool open(const std::string &path);
 
     // Read all IRP records from the file.
     // Only returns Type 1 (serial data) records that carry actual serial bytes:
     //   - WRITE REQUESTs (TX: host -> device)
     //   - READ COMPLETIONs (RX: device -> host)
+    // Record payloads are views into the mapping, so the reader must outlive `records`.
     bool readRecords(std::vector<IrpRecord> &records);
 
-    const DmsLogHeader &header() const { return m_header; }
+    // Smallest byte range handed to a parser thread by readRecordsParallel(), unless told otherwise
+    static constexpr uint64_t kParallelChunkBytes = 4ULL << 20;
+
+    // Same result as readRecords(), but the file is split into byte ranges of at least
+    // `minChunkBytes` that are parsed on `threadCount` threads (0 = all hardware threads). Ranges
+    // resync independently and are then stitched at their boundaries, so the output is identical
+    // to the serial path. Captures too small for two ranges are read serially.
+    bool readRecordsParallel(std::vector<IrpRecord> &records, unsigned threadCount = 0, uint64_t minChunkBytes = kParallelChunkBytes);
+
+    // Cursor positioned at the first IRP record (an exhausted cursor if none is found).
+    RecordCursor cursor();
+
+    // Follow mode, for captures that are still being written: a cursor that waits at the end of
+    // the data instead of finishing, and refresh() to pick up appended bytes. refresh() returns
+    // true if the file grew; record payloads obtained before that point are no longer valid.
+    RecordCursor followCursor();
+    bool         refresh();
+
+    // Invoke `fn` for each serial data record in file order; `fn` returns false to stop early.
+    // Returns the number of records visited.
+    size_t forEachRecord(const std::function<bool(const IrpRecord &)> &fn);
+
+    // Time-based access through the record index sidecar (see DmsLogIndex). The index is loaded on
+    // first use, or built with one pass over the file and saved next to it, so later queries on the
+    // same capture skip the scan.
+    //
+    // Cursor at the first serial data record with timestamp >= `filetime` (file order).
+    RecordCursor seek(uint64_t filetime);
+    // Serial data records with t0 <= timestamp < t1, in file order.
+    bool readRange(uint64_t t0, uint64_t t1, std::vector<IrpRecord> &records);
+    // Load or build the index; false when the capture has no serial data records.
+    bool loadIndex();
+
+    // Header including device name and port config (decoded on first access, then cached)
+    const DmsLogHeader &header();
+    const std::string  &deviceName();
+    const std::string  &portConfig();
     const std::string  &filePath() const { return m_path; }
+    uint64_t            fileSize() const { return m_fileSize; }
+
+    // Why the last call failed ("" if nothing failed), for the caller to report
+    const std::string &error() const { return m_error; }
 
   private:
+    friend class RecordCursor;
+
+    enum class StepResult
+    {
+        Record,     // a TX/RX record was parsed into `rec`
+        Skipped,    // a non-serial record or a gap was skipped
+        Incomplete, // follow mode: the step needs bytes that are not written yet; `pos` is unchanged
+        End         // end of data; `pos` is parked at the file size
+    };
+
     bool readHeader();
     bool findFirstRecord(uint64_t &outOffset);
+    // Search window for the first record; `complete` is set once the window and its chain are fully written.
+    bool locateFirstRecord(uint64_t &outOffset, bool &complete) const;
+    // First offset in [from, limit) holding a record header confirmed by the header that follows it.
+    bool findRecordHeader(uint64_t from, uint64_t limit, uint64_t &outOffset) const;
+    bool isChainedRecord(uint64_t pos) const;
+    // The header following the record at `pos` lies within the data (the record's chain check was not by end of data)
+    bool successorWritten(uint64_t pos) const;
+    // Parse records starting at `pos` until the next TX/RX record (Record), the end of the data (End)
+    // or, when following, data that is not written yet (Incomplete).
+    StepResult nextRecord(uint64_t &pos, IrpRecord &rec, bool follow) const;
+    // One step of the record walk at `pos`: parse one header or resync past one gap.
+    StepResult parseStep(uint64_t &pos, IrpRecord &rec, bool follow = false) const;
     bool readSessionMetadata();
     bool scanForPortConfig();
 
-    std::string   m_path;
-    std::ifstream m_file;
-    DmsLogHeader  m_header;
-    uint64_t      m_fileSize = 0;
-    uint32_t      m_tsHigh   = 0; // high 32 bits of the session FILETIME for validation
+    std::string          m_path;
+    mutable std::string  m_error;                       // see error(); also set by the const record walk
+    MappedFile           m_map;
+    std::vector<uint8_t> m_buffer;                      // fallback storage when the file cannot be mapped
+    const uint8_t       *m_data              = nullptr; // start of the file contents (mapping or m_buffer)
+    DmsLogHeader         m_header;
+    uint64_t             m_fileSize          = 0;
+    uint32_t             m_tsHigh            = 0;     // high 32 bits of the session FILETIME for validation
+    uint64_t             m_firstRecord       = 0;     // offset of the first IRP record (cached by cursor())
+    bool                 m_firstRecordSearch = false; // findFirstRecord() has run
+    bool                 m_firstRecordFound  = false;
+    DmsLogIndex          m_index;                     // .dmsidx record index (see loadIndex())
+    bool                 m_indexLoaded       = false;
+    bool                 m_deviceNameLoaded  = false; // readSessionMetadata() has run
+    bool                 m_portConfigLoaded  = false; // scanForPortConfig() has run
 };
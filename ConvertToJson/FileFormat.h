@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Helpers for the files the converter writes itself (index sidecar, columnar file, manifest):
+// little-endian fields, and the capture modification time they are stamped with.
+
+// Store the low `n` bytes of `v` at `p`, least significant first.
+inline void putLE(uint8_t *p, uint64_t v, int n)
+{
+    for (int i = 0; i < n; ++i)
+        p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+// Load a little-endian integer of `n` bytes.
+inline uint64_t getLE(const uint8_t *p, int n)
+{
+    uint64_t v = 0;
+    for (int i = n - 1; i >= 0; --i)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+// Modification time of a file in file-clock ticks (0 if unavailable).
+inline int64_t fileModificationTime(const std::string &path)
+{
+    std::error_code ec;
+    auto            t = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : static_cast<int64_t>(t.time_since_epoch().count());
+}
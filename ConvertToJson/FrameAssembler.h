@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// One flash of a Target Flashing Sequence (TFS) entry
+struct FrameSlot
+{
+    uint8_t tcmId;
+    uint8_t ledId;
+    uint8_t flashIndex; // 0 .. flashCount-1
+};
+
+// The data sets of one tracker frame, one per TFS slot
+template <typename Sample> struct AssembledFrame
+{
+    std::vector<Sample>  samples;              // in slot order; valid where present[i] != 0
+    std::vector<uint8_t> present;              // 0 = marker missing in this frame
+    size_t               presentCount = 0;     // filled slots
+    size_t               unexpected   = 0;     // samples whose (tcmId, ledId) is not in the TFS
+    uint32_t             timestamp_us = 0;     // first sample of the frame
+    uint8_t              triggerIndex = 0;     // first sample of the frame
+    bool                 complete     = false; // closed by an end-of-frame sample (false: the next frame began first)
+
+    size_t missingCount() const { return present.size() - presentCount; }
+};
+
+// Groups data sets into tracker frames using the programmed TFS.
+// configure() allocates one slot per flash of every TFS entry; add() places a sample by
+// (tcmId, ledId, flash index) through a lookup table and hands each finished frame to the
+// handler, which sees explicit missing-marker flags. The frame storage is reused, so nothing
+// is allocated per sample or per frame.
+//
+// Sample: a data-set type with timestamp_us, tcmId, ledId, endOfFrame and triggerIndex
+// (HHD_MeasurementSample, PhoenixDataSet).
+template <typename Sample> class FrameAssembler
+{
+  public:
+    using Frame        = AssembledFrame<Sample>;
+    using FrameHandler = std::function<void(const Frame &)>;
+
+    FrameAssembler() = default;
+    template <typename TfsEntry> explicit FrameAssembler(const std::vector<TfsEntry> &tfs) { configure(tfs); }
+
+    // Build the slot layout from TFS entries (tcmId, ledId, flashCount), in TFS order.
+    // Discards any partially assembled frame.
+    template <typename TfsEntry> void configure(const std::vector<TfsEntry> &tfs)
+    {
+        m_slots.clear();
+        m_pairs.clear();
+        m_pairOffset.assign(kPairCount + 1, 0);
+        m_pairCount.assign(kPairCount, 0);
+
+        for (const auto &entry : tfs)
+        {
+            uint8_t flashes = entry.flashCount >= 1 ? entry.flashCount : 1;
+            for (uint8_t f = 0; f < flashes; ++f)
+                m_slots.push_back({entry.tcmId, entry.ledId, f});
+        }
+
+        // Slot indices grouped per (tcmId, ledId), so a sample finds its next free flash slot directly
+        for (const auto &slot : m_slots)
+            ++m_pairOffset[pairKey(slot.tcmId, slot.ledId) + 1];
+        for (size_t k = 0; k < kPairCount; ++k)
+        {
+            if (m_pairOffset[k + 1] != 0)
+                m_pairs.push_back(static_cast<uint16_t>(k));
+            m_pairOffset[k + 1] += m_pairOffset[k];
+        }
+        m_pairSlots.resize(m_slots.size());
+        std::vector<uint32_t> fill(m_pairOffset.begin(), m_pairOffset.end() - 1);
+        for (size_t i = 0; i < m_slots.size(); ++i)
+            m_pairSlots[fill[pairKey(m_slots[i].tcmId, m_slots[i].ledId)]++] = static_cast<uint32_t>(i);
+
+        m_frame.samples.assign(m_slots.size(), Sample{});
+        m_frame.present.assign(m_slots.size(), 0);
+        startFrame();
+    }
+
+    const std::vector<FrameSlot> &slots() const { return m_slots; }
+
+    // Place one sample; completed frames go to `onFrame`.
+    void add(const Sample &s, const FrameHandler &onFrame)
+    {
+        size_t   key   = pairKey(s.tcmId, s.ledId);
+        uint32_t first = m_pairOffset.empty() ? 0 : m_pairOffset[key];
+        uint32_t last  = m_pairOffset.empty() ? 0 : m_pairOffset[key + 1];
+
+        // All flashes of this marker already arrived: the previous frame's end-of-frame sample was lost
+        if (first != last && m_pairCount[key] == last - first)
+            emit(false, onFrame);
+
+        if (!m_open)
+        {
+            m_open               = true;
+            m_frame.timestamp_us = s.timestamp_us;
+            m_frame.triggerIndex = s.triggerIndex;
+        }
+
+        if (first == last)
+        {
+            ++m_frame.unexpected;
+        }
+        else
+        {
+            uint32_t slot         = m_pairSlots[first + m_pairCount[key]++];
+            m_frame.samples[slot] = s;
+            m_frame.present[slot] = 1;
+            ++m_frame.presentCount;
+        }
+
+        if (s.endOfFrame)
+            emit(true, onFrame);
+    }
+
+    // Emit a partially assembled frame (e.g. when measurement stops)
+    void flush(const FrameHandler &onFrame)
+    {
+        if (m_open)
+            emit(false, onFrame);
+    }
+
+  private:
+    static constexpr size_t kPairCount = 16 * 128; // 4-bit TCM ID x 7-bit LED ID
+
+    static size_t pairKey(uint8_t tcmId, uint8_t ledId) { return (size_t(tcmId & 0x0F) << 7) | (ledId & 0x7F); }
+
+    void emit(bool complete, const FrameHandler &onFrame)
+    {
+        m_frame.complete = complete;
+        if (onFrame)
+            onFrame(m_frame);
+        startFrame();
+    }
+
+    void startFrame()
+    {
+        std::fill(m_frame.present.begin(), m_frame.present.end(), uint8_t(0));
+        for (uint16_t key : m_pairs)
+            m_pairCount[key] = 0;
+        m_frame.presentCount = 0;
+        m_frame.unexpected   = 0;
+        m_frame.timestamp_us = 0;
+        m_frame.triggerIndex = 0;
+        m_frame.complete     = false;
+        m_open               = false;
+    }
+
+    std::vector<FrameSlot> m_slots;        // TFS order
+    std::vector<uint32_t>  m_pairOffset;   // per (tcmId, ledId): range in m_pairSlots
+    std::vector<uint32_t>  m_pairSlots;    // slot indices grouped by (tcmId, ledId), flash order
+    std::vector<uint16_t>  m_pairCount;    // flashes of each pair received in the current frame
+    std::vector<uint16_t>  m_pairs;        // pairs present in the TFS
+    Frame                  m_frame;        // reused for every frame
+    bool                   m_open = false; // a sample of the current frame has arrived
+};
@@ -0,0 +1,196 @@
+#include "JsonBuffer.h"
+
+#include <ctime>
+#include <ostream>
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+// Two decimal digits per entry: "00", "01", ... "99"
+struct DigitPairs
+{
+    char text[200];
+
+    constexpr DigitPairs() : text()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            text[2 * i]     = static_cast<char>('0' + i / 10);
+            text[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+static constexpr DigitPairs kDigitPairs;
+
+static char *writeDigits(char *p, uint32_t value, int count)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        p[i]   = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return p + count;
+}
+
+size_t Iso8601Formatter::format(uint64_t filetime, char *out)
+{
+    // Windows FILETIME: 100ns intervals since 1601-01-01
+    // Convert to Unix epoch: subtract 116444736000000000 (100ns intervals between 1601 and 1970)
+    const uint64_t kUnixEpochDiff = 116444736000000000ULL;
+    if (filetime < kUnixEpochDiff)
+    {
+        static const char kEpoch[] = "1970-01-01T00:00:00Z";
+        std::memcpy(out, kEpoch, sizeof(kEpoch) - 1);
+        return sizeof(kEpoch) - 1;
+    }
+
+    uint64_t unixTime100ns = filetime - kUnixEpochDiff;
+    int64_t  unixSeconds   = static_cast<int64_t>(unixTime100ns / 10000000ULL);
+    uint32_t microseconds  = static_cast<uint32_t>((unixTime100ns % 10000000ULL) / 10);
+
+    if (unixSeconds != m_second)
+    {
+        time_t    t = static_cast<time_t>(unixSeconds);
+        struct tm tm_buf{};
+#ifdef _WIN32
+        gmtime_s(&tm_buf, &t);
+#else
+        gmtime_r(&t, &tm_buf);
+#endif
+        uint32_t year = static_cast<uint32_t>(tm_buf.tm_year + 1900);
+        char    *p    = writeDigits(m_prefix, year, year > 9999 ? 5 : 4);
+        *p++          = '-';
+        p             = writeDigits(p, static_cast<uint32_t>(tm_buf.tm_mon + 1), 2);
+        *p++          = '-';
+        p             = writeDigits(p, static_cast<uint32_t>(tm_buf.tm_mday), 2);
+        *p++          = 'T';
+        p             = writeDigits(p, static_cast<uint32_t>(tm_buf.tm_hour), 2);
+        *p++          = ':';
+        p             = writeDigits(p, static_cast<uint32_t>(tm_buf.tm_min), 2);
+        *p++          = ':';
+        p             = writeDigits(p, static_cast<uint32_t>(tm_buf.tm_sec), 2);
+        *p++          = '.';
+
+        m_prefixLength = static_cast<size_t>(p - m_prefix);
+        m_second       = unixSeconds;
+    }
+
+    std::memcpy(out, m_prefix, m_prefixLength);
+    char *p = writeDigits(out + m_prefixLength, microseconds, 6);
+    *p++    = 'Z';
+    return static_cast<size_t>(p - out);
+}
+
+JsonBuffer::JsonBuffer(std::ostream &out, size_t blockSize) : m_out(out), m_buffer(blockSize) {}
+
+void JsonBuffer::grow(size_t n)
+{
+    flush();
+    if (m_buffer.size() < n)
+        m_buffer.resize(n);
+}
+
+void JsonBuffer::flush()
+{
+    if (m_size == 0)
+        return;
+    m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+    m_size = 0;
+}
+
+JsonBuffer &JsonBuffer::operator<<(const JsonEscaped &e)
+{
+    // Runs of plain characters are copied as a block; only the characters that need escaping are expanded
+    std::string_view s     = e.text;
+    size_t           start = 0;
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        *this << s.substr(start, i - start);
+        start = i + 1;
+        switch (c)
+        {
+            case '"':
+                *this << "\\\"";
+                break;
+            case '\\':
+                *this << "\\\\";
+                break;
+            case '\n':
+                *this << "\\n";
+                break;
+            case '\r':
+                *this << "\\r";
+                break;
+            case '\t':
+                *this << "\\t";
+                break;
+            default:
+            {
+                char *p = reserve(6);
+                p[0]    = '\\';
+                p[1]    = 'u';
+                p[2]    = '0';
+                p[3]    = '0';
+                p[4]    = kHexDigits[c >> 4];
+                p[5]    = kHexDigits[c & 0x0F];
+                m_size += 6;
+                break;
+            }
+        }
+    }
+    return *this << s.substr(start);
+}
+
+void JsonBuffer::writeHex(const uint8_t *data, size_t len)
+{
+    char *p = reserve(2 * len);
+    for (size_t i = 0; i < len; ++i)
+    {
+        p[2 * i]     = kHexDigits[data[i] >> 4];
+        p[2 * i + 1] = kHexDigits[data[i] & 0x0F];
+    }
+    m_size += 2 * len;
+}
+
+void JsonBuffer::writeHex32(uint32_t value)
+{
+    char *p = reserve(8);
+    for (int i = 7; i >= 0; --i)
+    {
+        p[i]    = kHexDigits[value & 0x0F];
+        value >>= 4;
+    }
+    m_size += 8;
+}
+
+void JsonBuffer::writeLeftAligned(uint64_t value, std::string_view suffix, size_t width)
+{
+    size_t start = m_size;
+    *this << value << suffix;
+    size_t n = m_size - start;
+    if (n >= width)
+        return;
+    std::memset(reserve(width - n), ' ', width - n);
+    m_size += width - n;
+}
+
+void JsonBuffer::writeHundredths(int32_t value)
+{
+    // value * 0.01 is within 1e-11 of value / 100, far from a rounding boundary of "%.2f",
+    // so the decimal digits of the integer are exactly what the stream would print
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    if (value < 0)
+        *this << '-';
+    *this << magnitude / 100 << '.';
+    *this << std::string_view(kDigitPairs.text + 2 * (magnitude % 100), 2);
+}
+
+void JsonBuffer::writeTimestamp(uint64_t filetime)
+{
+    char  *p = reserve(Iso8601Formatter::kMaxLength);
+    size_t n = m_timestamps.format(filetime, p);
+    m_size  += n;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Text to be written as a JSON string body (escaped on output)
+struct JsonEscaped
+{
+    std::string_view text;
+};
+
+// FILETIME -> "YYYY-MM-DDTHH:MM:SS.ffffffZ" (UTC).
+// The "YYYY-MM-DDTHH:MM:SS." part is kept for the last second seen, so consecutive frames
+// only format their microseconds; the calendar conversion runs once per second of capture.
+class Iso8601Formatter
+{
+  public:
+    static constexpr size_t kMaxLength = 32;
+
+    // Writes at most kMaxLength characters to `out`; returns the length
+    size_t format(uint64_t filetime, char *out);
+
+  private:
+    int64_t m_second = -1; // Unix second of m_prefix
+    char    m_prefix[kMaxLength];
+    size_t  m_prefixLength = 0;
+};
+
+// Output buffer of the JSON writer.
+// Values are formatted in place (std::to_chars, lookup tables) and handed to the stream
+// in large blocks, so no iostream formatting or temporary strings are involved per field.
+class JsonBuffer
+{
+  public:
+    static constexpr size_t kDefaultBlockSize = 1 << 20;
+
+    explicit JsonBuffer(std::ostream &out, size_t blockSize = kDefaultBlockSize);
+    ~JsonBuffer() { flush(); }
+
+    JsonBuffer(const JsonBuffer &)            = delete;
+    JsonBuffer &operator=(const JsonBuffer &) = delete;
+
+    JsonBuffer &operator<<(std::string_view s)
+    {
+        std::memcpy(reserve(s.size()), s.data(), s.size());
+        m_size += s.size();
+        return *this;
+    }
+    JsonBuffer &operator<<(const char *s) { return *this << std::string_view(s); }
+    JsonBuffer &operator<<(char c)
+    {
+        *reserve(1) = c;
+        ++m_size;
+        return *this;
+    }
+    JsonBuffer &operator<<(const JsonEscaped &e);
+
+    // Integers in decimal
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>>>
+    JsonBuffer &operator<<(T value)
+    {
+        char *p = reserve(24);
+        m_size  = static_cast<size_t>(std::to_chars(p, p + 24, value).ptr - m_buffer.data());
+        return *this;
+    }
+
+    // Lowercase hex, two digits per byte
+    void writeHex(const uint8_t *data, size_t len);
+
+    // Lowercase hex, eight digits
+    void writeHex32(uint32_t value);
+
+    // Decimal followed by `suffix`, padded with trailing spaces to `width` characters
+    void writeLeftAligned(uint64_t value, std::string_view suffix, size_t width);
+
+    // value / 100 with two decimals (what "%.2f" prints for value * 0.01)
+    void writeHundredths(int32_t value);
+
+    // FILETIME as ISO 8601, see Iso8601Formatter
+    void writeTimestamp(uint64_t filetime);
+
+    // Hand the buffered text to the stream
+    void flush();
+
+  private:
+    // Room for `n` more characters at the end of the buffer
+    char *reserve(size_t n)
+    {
+        if (m_buffer.size() - m_size < n)
+            grow(n);
+        return m_buffer.data() + m_size;
+    }
+    void grow(size_t n);
+
+    std::ostream     &m_out;
+    std::vector<char> m_buffer;
+    size_t            m_size = 0;
+    Iso8601Formatter  m_timestamps;
+};
@@ -1,288 +1,560 @@
 #include "JsonWriter.h"
 
-#include <ctime>
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 
-std::string JsonWriter::escapeJson(const std::string &s)
+// Field names accepted by --fields
+static const struct
 {
-    std::string result;
-    result.reserve(s.size() + 10);
-    for (char c : s)
+    const char *name;
+    uint32_t    fields;
+} kFieldNames[] = {
+    {"index", JsonField::Index},
+    {"timestamp", JsonField::Timestamp},
+    {"direction", JsonField::Direction},
+    {"type", JsonField::Type},
+    {"rawHex", JsonField::RawHex},
+    {"timestamp_us", JsonField::TimestampUs},
+    {"x", JsonField::X},
+    {"x_mm", JsonField::X},
+    {"y", JsonField::Y},
+    {"y_mm", JsonField::Y},
+    {"z", JsonField::Z},
+    {"z_mm", JsonField::Z},
+    {"ledId", JsonField::LedId},
+    {"tcmId", JsonField::TcmId},
+    {"endOfFrame", JsonField::EndOfFrame},
+    {"status", JsonField::Status},
+    {"dataSet", JsonField::DataSet},
+    {"command", JsonField::Command},
+    {"message", JsonField::Message},
+    {"initMessage", JsonField::InitMessage},
+};
+
+bool JsonOptions::parseProfile(const std::string &name, JsonProfile &profile)
+{
+    for (JsonProfile p : {JsonProfile::Full, JsonProfile::Compact, JsonProfile::DataSetsOnly, JsonProfile::CommandsOnly})
     {
-        switch (c)
+        if (name == profileName(p))
         {
-            case '"':
-                result += "\\\"";
-                break;
-            case '\\':
-                result += "\\\\";
-                break;
-            case '\n':
-                result += "\\n";
-                break;
-            case '\r':
-                result += "\\r";
-                break;
-            case '\t':
-                result += "\\t";
-                break;
-            default:
-                if (static_cast<unsigned char>(c) < 0x20)
-                {
-                    char buf[8];
-                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
-                    result += buf;
-                }
-                else
-                {
-                    result += c;
-                }
+            profile = p;
+            return true;
         }
     }
-    return result;
+    std::cerr << "Error: unknown profile '" << name << "' (full, compact, datasets-only, commands-only)\n";
+    return false;
 }
 
-std::string JsonWriter::hexString(const uint8_t *data, size_t len)
+const char *JsonOptions::profileName(JsonProfile profile)
 {
-    std::ostringstream ss;
-    for (size_t i = 0; i < len; ++i)
+    switch (profile)
     {
-        ss << std::hex << std::setw(2) << std::setfill('0') << int(data[i]);
+        case JsonProfile::Full:
+            return "full";
+        case JsonProfile::Compact:
+            return "compact";
+        case JsonProfile::DataSetsOnly:
+            return "datasets-only";
+        case JsonProfile::CommandsOnly:
+            return "commands-only";
     }
-    return ss.str();
+    return "full";
 }
 
-std::string JsonWriter::filetimeToIso8601(uint64_t filetime)
+bool JsonOptions::parseFields(const std::string &list, uint32_t &fields)
 {
-    // Windows FILETIME: 100ns intervals since 1601-01-01
-    // Convert to Unix epoch: subtract 116444736000000000 (100ns intervals between 1601 and 1970)
-    const uint64_t kUnixEpochDiff = 116444736000000000ULL;
-    if (filetime < kUnixEpochDiff)
-        return "1970-01-01T00:00:00Z";
-
-    uint64_t unixTime100ns = filetime - kUnixEpochDiff;
-    time_t   unixSeconds   = static_cast<time_t>(unixTime100ns / 10000000ULL);
-    uint32_t microseconds  = static_cast<uint32_t>((unixTime100ns % 10000000ULL) / 10);
-
-    struct tm tm_buf{};
-#ifdef _WIN32
-    gmtime_s(&tm_buf, &unixSeconds);
-#else
-    gmtime_r(&unixSeconds, &tm_buf);
-#endif
-
-    char buf[64];
-    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%06uZ", tm_buf.tm_year + 1900, tm_buf.tm_mon + 1, tm_buf.tm_mday, tm_buf.tm_hour, tm_buf.tm_min,
-             tm_buf.tm_sec, microseconds);
-    return std::string(buf);
-}
+    uint32_t selected = 0;
+    size_t   start    = 0;
+    while (start <= list.size())
+    {
+        size_t      end  = std::min(list.find(',', start), list.size());
+        std::string name = list.substr(start, end - start);
+        start            = end + 1;
+        if (name.empty())
+            continue;
 
-bool JsonWriter::write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const std::vector<PhoenixFrame> &frames)
-{
-    std::ofstream out(outputPath);
-    if (!out.is_open())
+        bool known = false;
+        for (const auto &entry : kFieldNames)
+        {
+            if (name == entry.name)
+            {
+                selected |= entry.fields;
+                known     = true;
+                break;
+            }
+        }
+        if (!known)
+        {
+            std::cerr << "Error: unknown field '" << name << "' (" << fieldNames() << ")\n";
+            return false;
+        }
+    }
+    if (selected == 0)
     {
-        std::cerr << "Error: cannot create output file: " << outputPath << "\n";
+        std::cerr << "Error: no fields selected\n";
         return false;
     }
+    fields = selected;
+    return true;
+}
 
-    // Count frame types for summary
-    int commandCount = 0, dataSetCount = 0, messageCount = 0, initCount = 0, unknownCount = 0;
-    for (const auto &f : frames)
+const char *JsonOptions::fieldNames()
+{
+    return "index, timestamp, direction, type, rawHex, timestamp_us, x, y, z, ledId, tcmId, endOfFrame, status, dataSet, command, message, "
+           "initMessage";
+}
+
+std::string JsonOptions::settingsKey() const
+{
+    std::string key = profileName(profile);
+    if (profile != JsonProfile::Full)
     {
-        switch (f.type)
-        {
-            case PhoenixFrameType::Command:
-                ++commandCount;
-                break;
-            case PhoenixFrameType::DataSet:
-                ++dataSetCount;
-                break;
-            case PhoenixFrameType::Message:
-                ++messageCount;
-                break;
-            case PhoenixFrameType::InitMessage:
-                ++initCount;
-                break;
-            case PhoenixFrameType::Unknown:
-                ++unknownCount;
-                break;
-        }
+        char hex[16];
+        std::snprintf(hex, sizeof(hex), "%x", static_cast<unsigned>(fields));
+        key += std::string(" fields=") + hex;
     }
+    return key;
+}
 
-    out << "{\n";
+static const char *frameTypeName(PhoenixFrameType type)
+{
+    switch (type)
+    {
+        case PhoenixFrameType::Command:
+            return "command";
+        case PhoenixFrameType::DataSet:
+            return "dataSet";
+        case PhoenixFrameType::Message:
+            return "message";
+        case PhoenixFrameType::InitMessage:
+            return "initMessage";
+        case PhoenixFrameType::Unknown:
+            return "unknown";
+    }
+    return "unknown";
+}
 
-    // Metadata
-    out << "  \"metadata\": {\n";
-    out << "    \"sourceFile\": \"" << escapeJson(sourceFile) << "\",\n";
-    out << "    \"sessionTimestamp\": \"" << filetimeToIso8601(header.sessionTimestamp) << "\",\n";
-    out << "    \"device\": \"" << escapeJson(header.deviceName) << "\",\n";
-    out << "    \"portConfig\": \"" << escapeJson(header.portConfig) << "\",\n";
-    out << "    \"protocol\": \"Phoenix Visualeyez VZK10 RS-422\"\n";
-    out << "  },\n";
+// Start a member of a compact object: separator (none before the first member) and key
+static JsonBuffer &member(JsonBuffer &out, bool &first, const char *key)
+{
+    if (!first)
+        out << ',';
+    first = false;
+    return out << '"' << key << "\":";
+}
 
-    // Summary
-    out << "  \"summary\": {\n";
-    out << "    \"totalFrames\": " << frames.size() << ",\n";
-    out << "    \"commands\": " << commandCount << ",\n";
-    out << "    \"dataSets\": " << dataSetCount << ",\n";
-    out << "    \"messages\": " << messageCount << ",\n";
-    out << "    \"initMessages\": " << initCount << ",\n";
-    out << "    \"unknownFrames\": " << unknownCount << "\n";
-    out << "  },\n";
+std::string JsonWriter::filetimeToIso8601(uint64_t filetime)
+{
+    char             buf[Iso8601Formatter::kMaxLength];
+    Iso8601Formatter formatter;
+    return std::string(buf, formatter.format(filetime, buf));
+}
 
-    // Frames
-    out << "  \"frames\": [\n";
+void JsonWriter::formatFrame(JsonBuffer &out, const PhoenixFrame &f, size_t index)
+{
+    out << "    {\n";
+    out << "      \"index\": " << index << ",\n";
+    out << "      \"timestamp\": \"";
+    out.writeTimestamp(f.irpTimestamp);
+    out << "\",\n";
+    out << "      \"direction\": \"" << (f.isTx ? "TX" : "RX") << "\",\n";
 
-    for (size_t i = 0; i < frames.size(); ++i)
+    switch (f.type)
     {
-        const auto &f = frames[i];
-        out << "    {\n";
-        out << "      \"index\": " << i << ",\n";
-        out << "      \"timestamp\": \"" << filetimeToIso8601(f.irpTimestamp) << "\",\n";
-        out << "      \"direction\": \"" << (f.isTx ? "TX" : "RX") << "\",\n";
-
-        switch (f.type)
+        case PhoenixFrameType::Command:
         {
-            case PhoenixFrameType::Command:
+            const auto &cmd = f.command;
+            out << "      \"type\": \"command\",\n";
+            out << "      \"command\": {\n";
+            out << "        \"code\": \"" << escapeJson(std::string_view(&cmd.commandCode, 1)) << "\",\n";
+            out << "        \"index\": \"" << escapeJson(std::string_view(&cmd.commandIndex, 1)) << "\",\n";
+            out << "        \"name\": \"" << escapeJson(PhoenixDecoder::commandName(cmd.commandCode)) << "\",\n";
+            out << "        \"bytesPerParam\": " << int(cmd.bytesPerParam) << ",\n";
+            out << "        \"numParams\": " << int(cmd.numParams) << ",\n";
+            out << "        \"description\": \"" << escapeJson(cmd.description()) << "\"";
+            if (!cmd.params.empty())
             {
-                const auto &cmd = f.command;
-                out << "      \"type\": \"command\",\n";
-                out << "      \"command\": {\n";
-                out << "        \"code\": \"" << escapeJson(std::string(1, cmd.commandCode)) << "\",\n";
-                out << "        \"index\": \"" << escapeJson(std::string(1, cmd.commandIndex)) << "\",\n";
-                out << "        \"name\": \"" << escapeJson(PhoenixDecoder::commandName(cmd.commandCode)) << "\",\n";
-                out << "        \"bytesPerParam\": " << int(cmd.bytesPerParam) << ",\n";
-                out << "        \"numParams\": " << int(cmd.numParams) << ",\n";
-                out << "        \"description\": \"" << escapeJson(cmd.description()) << "\"";
-                if (!cmd.params.empty())
+                out << ",\n        \"params\": [";
+                for (size_t j = 0; j < cmd.params.size(); ++j)
                 {
-                    out << ",\n        \"params\": [";
-                    for (size_t j = 0; j < cmd.params.size(); ++j)
-                    {
-                        if (j > 0)
-                            out << ", ";
-                        out << int(cmd.params[j]);
-                    }
-                    out << "]";
+                    if (j > 0)
+                        out << ", ";
+                    out << int(cmd.params[j]);
+                }
+                out << "]";
 
-                    // Decode multi-byte parameter values
-                    if (cmd.bytesPerParam > 1 && cmd.numParams > 0)
+                // Decode multi-byte parameter values
+                if (cmd.bytesPerParam > 1 && cmd.numParams > 0)
+                {
+                    out << ",\n        \"paramValues\": [";
+                    for (int pi = 0; pi < cmd.numParams; ++pi)
                     {
-                        out << ",\n        \"paramValues\": [";
-                        for (int pi = 0; pi < cmd.numParams; ++pi)
+                        if (pi > 0)
+                            out << ", ";
+                        size_t   offset = pi * cmd.bytesPerParam;
+                        uint32_t val    = 0;
+                        for (int bi = 0; bi < cmd.bytesPerParam && offset + bi < cmd.params.size(); ++bi)
                         {
-                            if (pi > 0)
-                                out << ", ";
-                            size_t   offset = pi * cmd.bytesPerParam;
-                            uint32_t val    = 0;
-                            for (int bi = 0; bi < cmd.bytesPerParam && offset + bi < cmd.params.size(); ++bi)
-                            {
-                                val = (val << 8) | cmd.params[offset + bi];
-                            }
-                            out << val;
+                            val = (val << 8) | cmd.params[offset + bi];
                         }
-                        out << "]";
+                        out << val;
                     }
+                    out << "]";
                 }
-                out << "\n      }";
-                break;
             }
+            out << "\n      }";
+            break;
+        }
 
-            case PhoenixFrameType::DataSet:
-            {
-                const auto &ds = f.dataSet;
-                out << "      \"type\": \"dataSet\",\n";
-                out << "      \"dataSet\": {\n";
-                out << "        \"timestamp_us\": " << ds.timestamp_us << ",\n";
-                out << std::fixed << std::setprecision(2);
-                out << "        \"x_mm\": " << ds.x_mm() << ",\n";
-                out << "        \"y_mm\": " << ds.y_mm() << ",\n";
-                out << "        \"z_mm\": " << ds.z_mm() << ",\n";
-                out << "        \"ledId\": " << int(ds.ledId) << ",\n";
-                out << "        \"tcmId\": " << int(ds.tcmId) << ",\n";
-                out << "        \"endOfFrame\": " << (ds.endOfFrame ? "true" : "false") << ",\n";
-
-                out << "        \"status\": {\n";
-                out << "          \"raw\": \"0x" << std::hex << std::setw(8) << std::setfill('0') << ds.statusWord << std::dec << "\",\n";
-                out << "          \"coordStatus\": " << int(ds.coordStatus) << ",\n";
-                out << "          \"ambientLight\": " << int(ds.ambientLight) << ",\n";
-                out << "          \"triggerIndex\": " << int(ds.triggerIndex) << ",\n";
-                out << "          \"rightEye\": {\n";
-                out << "            \"signalLow\": " << (ds.rightEyeSignal ? "true" : "false") << ",\n";
-                out << "            \"status\": " << int(ds.rightEyeStatus) << ",\n";
-                out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.rightEyeStatus)) << "\"\n";
-                out << "          },\n";
-                out << "          \"centerEye\": {\n";
-                out << "            \"signalLow\": " << (ds.centerEyeSignal ? "true" : "false") << ",\n";
-                out << "            \"status\": " << int(ds.centerEyeStatus) << ",\n";
-                out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.centerEyeStatus)) << "\"\n";
-                out << "          },\n";
-                out << "          \"leftEye\": {\n";
-                out << "            \"signalLow\": " << (ds.leftEyeSignal ? "true" : "false") << ",\n";
-                out << "            \"status\": " << int(ds.leftEyeStatus) << ",\n";
-                out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.leftEyeStatus)) << "\"\n";
-                out << "          }\n";
-                out << "        }\n";
-                out << "      }";
+        case PhoenixFrameType::DataSet:
+        {
+            const auto &ds = f.dataSet;
+            out << "      \"type\": \"dataSet\",\n";
+            out << "      \"dataSet\": {\n";
+            out << "        \"timestamp_us\": " << ds.timestamp_us << ",\n";
+            out << "        \"x_mm\": ";
+            out.writeHundredths(ds.x); // x_mm()
+            out << ",\n        \"y_mm\": ";
+            out.writeHundredths(ds.y);
+            out << ",\n        \"z_mm\": ";
+            out.writeHundredths(ds.z);
+            out << ",\n";
+            out << "        \"ledId\": " << int(ds.ledId) << ",\n";
+            out << "        \"tcmId\": " << int(ds.tcmId) << ",\n";
+            out << "        \"endOfFrame\": " << (ds.endOfFrame ? "true" : "false") << ",\n";
+
+            out << "        \"status\": {\n";
+            out << "          \"raw\": \"0x";
+            out.writeHex32(ds.statusWord);
+            out << "\",\n";
+            out << "          \"coordStatus\": " << int(ds.coordStatus) << ",\n";
+            out << "          \"ambientLight\": " << int(ds.ambientLight) << ",\n";
+            out << "          \"triggerIndex\": " << int(ds.triggerIndex) << ",\n";
+            out << "          \"rightEye\": {\n";
+            out << "            \"signalLow\": " << (ds.rightEyeSignal ? "true" : "false") << ",\n";
+            out << "            \"status\": " << int(ds.rightEyeStatus) << ",\n";
+            out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.rightEyeStatus)) << "\"\n";
+            out << "          },\n";
+            out << "          \"centerEye\": {\n";
+            out << "            \"signalLow\": " << (ds.centerEyeSignal ? "true" : "false") << ",\n";
+            out << "            \"status\": " << int(ds.centerEyeStatus) << ",\n";
+            out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.centerEyeStatus)) << "\"\n";
+            out << "          },\n";
+            out << "          \"leftEye\": {\n";
+            out << "            \"signalLow\": " << (ds.leftEyeSignal ? "true" : "false") << ",\n";
+            out << "            \"status\": " << int(ds.leftEyeStatus) << ",\n";
+            out << "            \"description\": \"" << escapeJson(PhoenixDecoder::eyeStatusDescription(ds.leftEyeStatus)) << "\"\n";
+            out << "          }\n";
+            out << "        }\n";
+            out << "      }";
+            break;
+        }
+
+        case PhoenixFrameType::Message:
+        {
+            const auto &msg = f.message;
+            out << "      \"type\": \"message\",\n";
+            out << "      \"message\": {\n";
+            out << "        \"commandCode\": \"" << escapeJson(std::string_view(&msg.commandCode, 1)) << "\",\n";
+            out << "        \"commandIndex\": \"" << escapeJson(std::string_view(&msg.commandIndex, 1)) << "\",\n";
+            out << "        \"commandName\": \"" << escapeJson(PhoenixDecoder::commandName(msg.commandCode)) << "\",\n";
+            out << "        \"isAck\": " << (msg.isAck() ? "true" : "false") << ",\n";
+            out << "        \"messageId\": " << int(msg.messageId) << ",\n";
+            out << "        \"messageParam\": " << int(msg.messageParam) << "\n";
+            out << "      }";
+            break;
+        }
+
+        case PhoenixFrameType::InitMessage:
+        {
+            const auto &init = f.initMessage;
+            out << "      \"type\": \"initMessage\",\n";
+            out << "      \"initMessage\": {\n";
+            out << "        \"serialNumber\": \"";
+            out.writeHex(init.serialNumber, sizeof(init.serialNumber));
+            out << "\",\n";
+            out << "        \"status\": " << int(init.statusByte) << ",\n";
+            out << "        \"initialized\": " << (init.statusByte == 0x01 ? "true" : "false") << "\n";
+            out << "      }";
+            break;
+        }
+
+        case PhoenixFrameType::Unknown:
+        {
+            out << "      \"type\": \"unknown\",\n";
+            out << "      \"rawHex\": \"";
+            out.writeHex(f.rawBytes.data(), f.rawBytes.size());
+            out << "\"";
+            break;
+        }
+    }
+
+    if (!f.rawBytes.empty() && f.type != PhoenixFrameType::Unknown)
+    {
+        out << ",\n      \"rawHex\": \"";
+        out.writeHex(f.rawBytes.data(), f.rawBytes.size());
+        out << "\"";
+    }
+
+    out << "\n    }";
+}
+
+// One frame on one line: the fields selected in m_options.fields, without pretty-printing or
+// strings derived from the frame (command names, descriptions, decoded parameter values)
+void JsonWriter::formatCompactFrame(JsonBuffer &out, const PhoenixFrame &f, size_t index) const
+{
+    const uint32_t fields = m_options.fields;
+    bool           first  = true;
+
+    out << '{';
+    if (fields & JsonField::Index)
+        member(out, first, "index") << index;
+    if (fields & JsonField::Timestamp)
+    {
+        member(out, first, "timestamp") << '"';
+        out.writeTimestamp(f.irpTimestamp);
+        out << '"';
+    }
+    if (fields & JsonField::Direction)
+        member(out, first, "direction") << (f.isTx ? "\"TX\"" : "\"RX\"");
+    if (fields & JsonField::Type)
+        member(out, first, "type") << '"' << frameTypeName(f.type) << '"';
+
+    switch (f.type)
+    {
+        case PhoenixFrameType::Command:
+        {
+            if (!(fields & JsonField::Command))
                 break;
+            const auto &cmd = f.command;
+            member(out, first, "command") << "{\"code\":\"" << escapeJson(std::string_view(&cmd.commandCode, 1)) << "\",\"index\":\""
+                                          << escapeJson(std::string_view(&cmd.commandIndex, 1)) << "\",\"bytesPerParam\":" << int(cmd.bytesPerParam)
+                                          << ",\"numParams\":" << int(cmd.numParams);
+            if (!cmd.params.empty())
+            {
+                out << ",\"params\":[";
+                for (size_t j = 0; j < cmd.params.size(); ++j)
+                {
+                    if (j > 0)
+                        out << ',';
+                    out << int(cmd.params[j]);
+                }
+                out << ']';
             }
+            out << '}';
+            break;
+        }
 
-            case PhoenixFrameType::Message:
-            {
-                const auto &msg = f.message;
-                out << "      \"type\": \"message\",\n";
-                out << "      \"message\": {\n";
-                out << "        \"commandCode\": \"" << escapeJson(std::string(1, msg.commandCode)) << "\",\n";
-                out << "        \"commandIndex\": \"" << escapeJson(std::string(1, msg.commandIndex)) << "\",\n";
-                out << "        \"commandName\": \"" << escapeJson(PhoenixDecoder::commandName(msg.commandCode)) << "\",\n";
-                out << "        \"isAck\": " << (msg.isAck() ? "true" : "false") << ",\n";
-                out << "        \"messageId\": " << int(msg.messageId) << ",\n";
-                out << "        \"messageParam\": " << int(msg.messageParam) << "\n";
-                out << "      }";
+        case PhoenixFrameType::DataSet:
+        {
+            if (!(fields & JsonField::DataSet))
                 break;
+            const auto &ds    = f.dataSet;
+            bool        inner = true;
+            member(out, first, "dataSet") << '{';
+            if (fields & JsonField::TimestampUs)
+                member(out, inner, "timestamp_us") << ds.timestamp_us;
+            if (fields & JsonField::X)
+                member(out, inner, "x_mm").writeHundredths(ds.x);
+            if (fields & JsonField::Y)
+                member(out, inner, "y_mm").writeHundredths(ds.y);
+            if (fields & JsonField::Z)
+                member(out, inner, "z_mm").writeHundredths(ds.z);
+            if (fields & JsonField::LedId)
+                member(out, inner, "ledId") << int(ds.ledId);
+            if (fields & JsonField::TcmId)
+                member(out, inner, "tcmId") << int(ds.tcmId);
+            if (fields & JsonField::EndOfFrame)
+                member(out, inner, "endOfFrame") << (ds.endOfFrame ? "true" : "false");
+            if (fields & JsonField::Status)
+            {
+                member(out, inner, "status") << "{\"raw\":\"0x";
+                out.writeHex32(ds.statusWord);
+                out << "\",\"coordStatus\":" << int(ds.coordStatus) << ",\"ambientLight\":" << int(ds.ambientLight) << ",\"triggerIndex\":" << int(ds.triggerIndex);
+                out << ",\"rightEye\":{\"signalLow\":" << (ds.rightEyeSignal ? "true" : "false") << ",\"status\":" << int(ds.rightEyeStatus) << '}';
+                out << ",\"centerEye\":{\"signalLow\":" << (ds.centerEyeSignal ? "true" : "false") << ",\"status\":" << int(ds.centerEyeStatus) << '}';
+                out << ",\"leftEye\":{\"signalLow\":" << (ds.leftEyeSignal ? "true" : "false") << ",\"status\":" << int(ds.leftEyeStatus) << "}}";
             }
+            out << '}';
+            break;
+        }
 
-            case PhoenixFrameType::InitMessage:
-            {
-                const auto &init = f.initMessage;
-                out << "      \"type\": \"initMessage\",\n";
-                out << "      \"initMessage\": {\n";
-                out << "        \"serialNumber\": \"" << init.serialNumberHex() << "\",\n";
-                out << "        \"status\": " << int(init.statusByte) << ",\n";
-                out << "        \"initialized\": " << (init.statusByte == 0x01 ? "true" : "false") << "\n";
-                out << "      }";
+        case PhoenixFrameType::Message:
+        {
+            if (!(fields & JsonField::Message))
                 break;
-            }
+            const auto &msg = f.message;
+            member(out, first, "message") << "{\"commandCode\":\"" << escapeJson(std::string_view(&msg.commandCode, 1)) << "\",\"commandIndex\":\""
+                                          << escapeJson(std::string_view(&msg.commandIndex, 1)) << "\",\"isAck\":" << (msg.isAck() ? "true" : "false")
+                                          << ",\"messageId\":" << int(msg.messageId) << ",\"messageParam\":" << int(msg.messageParam) << '}';
+            break;
+        }
 
-            case PhoenixFrameType::Unknown:
-            {
-                out << "      \"type\": \"unknown\",\n";
-                out << "      \"rawHex\": \"" << hexString(f.rawBytes.data(), f.rawBytes.size()) << "\"";
+        case PhoenixFrameType::InitMessage:
+        {
+            if (!(fields & JsonField::InitMessage))
                 break;
-            }
+            const auto &init = f.initMessage;
+            member(out, first, "initMessage") << "{\"serialNumber\":\"";
+            out.writeHex(init.serialNumber, sizeof(init.serialNumber));
+            out << "\",\"status\":" << int(init.statusByte) << '}';
+            break;
         }
 
-        if (!f.rawBytes.empty() && f.type != PhoenixFrameType::Unknown)
+        case PhoenixFrameType::Unknown:
         {
-            out << ",\n      \"rawHex\": \"" << hexString(f.rawBytes.data(), f.rawBytes.size()) << "\"";
+            // The raw bytes are all an unknown frame has
+            member(out, first, "rawHex") << '"';
+            out.writeHex(f.rawBytes.data(), f.rawBytes.size());
+            out << '"';
+            break;
         }
+    }
 
-        out << "\n    }";
-        if (i + 1 < frames.size())
-            out << ",";
-        out << "\n";
+    if ((fields & JsonField::RawHex) && !f.rawBytes.empty() && f.type != PhoenixFrameType::Unknown)
+    {
+        member(out, first, "rawHex") << '"';
+        out.writeHex(f.rawBytes.data(), f.rawBytes.size());
+        out << '"';
+    }
+    out << '}';
+}
+
+bool JsonWriter::selected(const PhoenixFrame &f) const
+{
+    switch (m_options.profile)
+    {
+        case JsonProfile::DataSetsOnly:
+            return f.type == PhoenixFrameType::DataSet;
+        case JsonProfile::CommandsOnly:
+            return f.type == PhoenixFrameType::Command;
+        default:
+            return true;
     }
+}
 
+bool JsonWriter::write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const std::vector<PhoenixFrame> &frames)
+{
+    return write(outputPath, header, sourceFile,
+                 [&frames](const FrameSink &sink)
+                 {
+                     for (const auto &f : frames)
+                         sink(f);
+                 });
+}
+
+bool JsonWriter::write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const FrameSource &source)
+{
+    if (!begin(outputPath, header, sourceFile))
+        return false;
+    source([this](const PhoenixFrame &f) { writeFrame(f); });
+    return end();
+}
+
+// Summary with every count in a fixed-width field (trailing spaces), so the block written by begin()
+// can be overwritten in place by end()
+void JsonWriter::formatSummary(JsonBuffer &out, const PhoenixFrameCounts &counts)
+{
+    const size_t kWidth = 21; // the largest 64-bit count and its comma
+    out << "  \"summary\": {\n";
+    out << "    \"totalFrames\": ";
+    out.writeLeftAligned(counts.total, ",", kWidth);
+    out << "\n    \"commands\": ";
+    out.writeLeftAligned(counts.commands, ",", kWidth);
+    out << "\n    \"dataSets\": ";
+    out.writeLeftAligned(counts.dataSets, ",", kWidth);
+    out << "\n    \"messages\": ";
+    out.writeLeftAligned(counts.messages, ",", kWidth);
+    out << "\n    \"initMessages\": ";
+    out.writeLeftAligned(counts.initMessages, ",", kWidth);
+    out << "\n    \"unknownFrames\": ";
+    out.writeLeftAligned(counts.unknown, "", kWidth);
+    out << "\n  },\n";
+}
+
+bool JsonWriter::begin(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile)
+{
+    m_out.reset();
+    m_file.close();
+    m_file.clear();
+    m_file.open(outputPath);
+    m_error.clear();
+    if (!m_file.is_open())
+    {
+        m_error = "cannot create output file: " + outputPath;
+        return false;
+    }
+    m_outputPath = outputPath;
+    m_counts     = PhoenixFrameCounts();
+    m_written    = 0;
+
+    m_out.emplace(m_file);
+    JsonBuffer &out = *m_out;
+    out << "{\n";
+
+    // Metadata
+    out << "  \"metadata\": {\n";
+    out << "    \"sourceFile\": \"" << escapeJson(sourceFile) << "\",\n";
+    out << "    \"sessionTimestamp\": \"";
+    out.writeTimestamp(header.sessionTimestamp);
+    out << "\",\n";
+    out << "    \"device\": \"" << escapeJson(header.deviceName) << "\",\n";
+    out << "    \"portConfig\": \"" << escapeJson(header.portConfig) << "\",\n";
+    out << "    \"protocol\": \"Phoenix Visualeyez VZK10 RS-422\"";
+    if (m_options.profile != JsonProfile::Full)
+        out << ",\n    \"profile\": \"" << JsonOptions::profileName(m_options.profile) << "\"";
+    out << "\n  },\n";
+
+    // Summary placeholder, back-patched by end() once the counts are known
+    out.flush();
+    m_summaryPos = m_file.tellp();
+    formatSummary(out, m_counts);
+
+    // Frames
+    out << "  \"frames\": [\n";
+    return true;
+}
+
+void JsonWriter::writeFrame(const PhoenixFrame &f)
+{
+    if (!m_out)
+        return;
+    size_t index = m_counts.total;
+    m_counts.add(f);
+    if (!selected(f))
+        return;
+
+    if (m_written++ > 0)
+        *m_out << ",\n";
+    if (m_options.profile == JsonProfile::Full)
+        formatFrame(*m_out, f, index);
+    else
+        formatCompactFrame(*m_out, f, index);
+}
+
+bool JsonWriter::end()
+{
+    if (!m_out)
+        return false;
+
+    JsonBuffer &out = *m_out;
+    if (m_written > 0)
+        out << "\n";
     out << "  ]\n";
     out << "}\n";
+    out.flush();
+
+    m_file.seekp(m_summaryPos);
+    formatSummary(out, m_counts);
+    out.flush();
 
-    if (!out.good())
+    m_out.reset();
+    m_file.close();
+    if (m_file.fail())
     {
-        std::cerr << "Error: write failed for " << outputPath << "\n";
+        m_error = "write failed for " + m_outputPath;
         return false;
     }
 
@@ -2,23 +2,122 @@
 
 #include "PhoenixDecoder.h"
 #include "DmsLogReader.h"
+#include "JsonBuffer.h"
 
+#include <functional>
+#include <fstream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Produces the decoded frames by calling the given sink once per frame.
+using FrameSource = std::function<void(const FrameSink &)>;
+
+// What the frames array contains
+enum class JsonProfile
+{
+    Full,         // pretty-printed, every field and derived description (default)
+    Compact,      // one frame per line, no derived strings (names, descriptions, paramValues) or duplicate rawHex
+    DataSetsOnly, // compact, data-set frames only
+    CommandsOnly, // compact, command frames only
+};
+
+// Frame fields selectable with --fields (compact profiles)
+namespace JsonField
+{
+    enum : uint32_t
+    {
+        Index       = 1u << 0,
+        Timestamp   = 1u << 1, // capture time of the IRP (ISO 8601)
+        Direction   = 1u << 2,
+        Type        = 1u << 3,
+        RawHex      = 1u << 4, // raw bytes of decoded frames (unknown frames always carry rawHex)
+        TimestampUs = 1u << 5, // data set: tracker timestamp
+        X           = 1u << 6,
+        Y           = 1u << 7,
+        Z           = 1u << 8,
+        LedId       = 1u << 9,
+        TcmId       = 1u << 10,
+        EndOfFrame  = 1u << 11,
+        Status      = 1u << 12, // data set: status word and its decoded flags
+        Command     = 1u << 13,
+        Message     = 1u << 14,
+        InitMessage = 1u << 15,
+
+        DataSet     = TimestampUs | X | Y | Z | LedId | TcmId | EndOfFrame | Status,
+        All         = (1u << 16) - 1,
+    };
+}
+
+struct JsonOptions
+{
+    JsonProfile profile = JsonProfile::Full;
+    uint32_t    fields  = JsonField::All & ~JsonField::RawHex; // used by the compact profiles
+
+    // "full", "compact", "datasets-only", "commands-only"
+    static bool parseProfile(const std::string &name, JsonProfile &profile);
+
+    static const char *profileName(JsonProfile profile);
+
+    // Comma-separated field names, e.g. "timestamp,x,y,z,ledId,tcmId"
+    static bool parseFields(const std::string &list, uint32_t &fields);
+
+    // Names accepted by parseFields(), for usage text
+    static const char *fieldNames();
+
+    // Profile, and the fields where the profile uses them, e.g. "compact fields=1fbf" (for the batch manifest)
+    std::string settingsKey() const;
+};
+
 class JsonWriter
 {
   public:
+    explicit JsonWriter(const JsonOptions &options = JsonOptions()) : m_options(options) {}
+
     // Write decoded frames to a JSON file.
     // The output includes:
     //   - File metadata (source file, device, port config, session timestamp)
-    //   - Summary statistics
-    //   - All decoded frames in chronological order
+    //   - Summary statistics (of all decoded frames)
+    //   - The decoded frames in chronological order; which frames and fields, and the layout,
+    //     follow the JsonOptions profile
     bool write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const std::vector<PhoenixFrame> &frames);
 
-  private:
-    // JSON serialization helpers (no external dependency)
-    static std::string escapeJson(const std::string &s);
-    static std::string hexString(const uint8_t *data, size_t len);
+    // Streaming variant: frames are pulled from `source` in a single pass and written as they arrive,
+    // so no frame list is held in memory.
+    bool write(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile, const FrameSource &source);
+
+    // Incremental output, for callers that produce frames themselves:
+    // begin() writes the metadata and a fixed-width summary placeholder, writeFrame() appends one
+    // frame immediately, end() closes the document and back-patches the summary with the final counts.
+    bool begin(const std::string &outputPath, const DmsLogHeader &header, const std::string &sourceFile);
+    void writeFrame(const PhoenixFrame &f);
+    bool end();
+
+    // Frame counts of the last write() (or of the frames written since begin())
+    const PhoenixFrameCounts &counts() const { return m_counts; }
+
+    // Why the last write() / begin() / end() failed, for the caller to report
+    const std::string &error() const { return m_error; }
+
+    // FILETIME as "YYYY-MM-DDTHH:MM:SS.ffffffZ" (UTC)
     static std::string filetimeToIso8601(uint64_t filetime);
+
+  private:
+    static void formatFrame(JsonBuffer &out, const PhoenixFrame &f, size_t index);
+    static void formatSummary(JsonBuffer &out, const PhoenixFrameCounts &counts);
+    void        formatCompactFrame(JsonBuffer &out, const PhoenixFrame &f, size_t index) const;
+    bool        selected(const PhoenixFrame &f) const;
+
+    // Text written as a JSON string body, escaped on the fly (no temporary string)
+    static JsonEscaped escapeJson(std::string_view s) { return JsonEscaped{s}; }
+
+    JsonOptions               m_options;
+    PhoenixFrameCounts        m_counts;
+    size_t                    m_written = 0; // frames in the frames array
+    std::ofstream             m_file;
+    std::optional<JsonBuffer> m_out;        // buffer over m_file between begin() and end()
+    std::streampos            m_summaryPos; // file offset of the summary block
+    std::string               m_outputPath;
+    std::string               m_error;
 };
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+// Uses CreateFileMapping/MapViewOfFile on Windows and mmap elsewhere.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Map the file at `path`. An empty file maps successfully with data() == nullptr.
+    bool open(const std::string &path);
+    void close();
+
+    // Exchange mappings with `other` (e.g. to replace a mapping only once its successor is open)
+    void swap(MappedFile &other);
+
+    const uint8_t *data() const { return m_data; }
+    uint64_t       size() const { return m_size; }
+    bool           isOpen() const { return m_open; }
+
+  private:
+    const uint8_t *m_data = nullptr;
+    uint64_t       m_size = 0;
+    bool           m_open = false;
+#ifdef _WIN32
+    void *m_file    = nullptr; // HANDLE
+    void *m_mapping = nullptr; // HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
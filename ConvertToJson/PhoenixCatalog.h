@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+// Compile-time catalog of the PTI low-level commands and eye status codes.
+// Shared by command building (Measure_HHD BuildCommand), the decoder and the JSON writer;
+// every lookup returns a view of static storage, so naming a frame never allocates.
+
+// Wire layout of a command: '&' code index bytesPerParam numParams CR [params, MSB first]
+struct PhoenixCommandInfo
+{
+    char             code;
+    std::string_view name;
+    uint8_t          bytesPerParam; // 0: sent without parameters (or layout not used by this tool)
+    uint8_t          numParams;     // usual count; &p clears the TFS with 0 and appends with 2
+    bool             bigEndian;     // multi-byte parameters are sent MSB first
+    std::string_view description;
+};
+
+namespace PhoenixCatalog
+{
+    // clang-format off
+    inline constexpr PhoenixCommandInfo kCommands[] = {
+        // Reset
+        {'`', "Software Reset",                        0, 0, false, "Make the core processor reset the rest of the tracker hardware"},
+
+        // Settings
+        {'L', "Set Signal Quality Requirement (SQR)",  1, 1, false, "Set the Signal Quality Requirement level"},
+        {'O', "Set Minimum Signal Requirement (MSR)",  2, 1, true,  "Set the Minimum Signal Requirement level"},
+        {'P', "Enable Double Sampling",                0, 0, false, "Turn on the double sampling process"},
+        {'Q', "Enable Single Sampling",                0, 0, false, "Turn on the single sampling process (default)"},
+        {'S', "Enable Internal Triggering",            0, 0, false, "Enable sampling by internal triggering"},
+        {'U', "Set Sample Operation Time (SOT)",       1, 1, false, "Limit the time spent sampling one marker"},
+        {'V', "Set Manual Exposure",                   0, 0, false, "Set user-specified exposure values (disables automatic exposure)"},
+        {'W', "Enable Automatic Exposure",             0, 0, false, "Turn on the automatic exposure process (default)"},
+        {'X', "Set Multi-Rate Sampling Mode",          1, 8, false, "Set the multi-rate sampling option of the TCMs (SM0-SM3)"},
+        {'Y', "Set Auto-Exposure Gain",                1, 1, false, "Set the feedback gain of automatic exposure"},
+        {'6', "Set Number of Capture Cycles",          0, 0, false, "Number of frames before sampling stops (default infinite)"},
+        {'7', "Ping",                                  0, 0, false, "Do nothing, return an ACK immediately"},
+        {'u', "Toggle Marker On/Off",                  0, 0, false, "Toggle a marker on or off for visual spotting"},
+        {'v', "Set Sampling/Intermission Period",      4, 2, true,  "Set the sampling period and sequence intermission period (us)"},
+        {'^', "Enable Tether Mode",                    1, 1, false, "Enable tether-mode control of the TCMs"},
+        {'_', "Enable Tetherless Mode",                0, 0, false, "Enable tetherless-mode control of the TCMs (default)"},
+
+        // Marker control
+        {'n', "TCM Sync on First-TCMID",               0, 0, false, "Synchronize all TCMs on the first TCM ID of the TFS"},
+        {'o', "TCM Sync on End-Of-Frame",              0, 0, false, "Synchronize all TCMs on the end-of-frame signal (default)"},
+        {'p', "Target Flashing Sequence (TFS)",        1, 2, false, "Clear the TFS, or append an LED ID and flash count for TCM <index>"},
+        {'q', "Ready All TCMs",                        0, 0, false, "Make all TCMs ready to flash their first LED"},
+        {'r', "Program TFS Into TCMs",                 0, 0, false, "Upload the target flashing sequence into all TCMs"},
+        {']', "Reset All TCMs",                        0, 0, false, "Reset all TCMs to their default state"},
+
+        // Capture actions
+        {'3', "Start Periodic Sampling",               0, 0, false, "Start periodic sampling at the preset sampling period"},
+        {'5', "Stop Periodic Sampling",                0, 0, false, "Stop the periodic sampling process"},
+        {'G', "Activate Vibrator",                     0, 0, false, "Enroll a vibrator ID for activation when its marker flashes"},
+        {'N', "Wait for Pulse then Start",             0, 0, false, "Wait for an external pulse before starting periodic sampling"},
+        {'R', "Enable External Triggering",            0, 0, false, "Arm the tracker for external triggering (default)"},
+
+        // Internal/factory
+        {'=', "Return Raw Sensor Data",                0, 0, false, "Return raw sensor data as results"},
+        {'<', "Return 3D Coordinates",                 0, 0, false, "Return 3D coordinates as results (default)"},
+        {';', "Return Raw + 3D",                       0, 0, false, "Return both raw sensor data and 3D coordinates"},
+        {'9', "Enable Refraction Compensation",        0, 0, false, "Enable refraction compensation (default)"},
+        {':', "Disable Refraction Compensation",       0, 0, false, "Disable refraction compensation"},
+        {'Z', "Set Desired Signal Peak",               0, 0, false, "Set the signal peak targeted by automatic exposure"},
+        {'K', "External Start + External Trigger",     0, 0, false, "Start on an external pulse and sample on external triggers"},
+        {'J', "Fetch Misalignment Parameter",          0, 0, false, "Fetch the specified misalignment parameter"},
+        {'M', "Change Misalignment Parameter",         0, 0, false, "Temporarily change the specified misalignment parameter"},
+        {'x', "Burn Misalignment to ROM",              0, 0, false, "Burn the current misalignment parameters into ROM"},
+
+        {'?', "Query/Identify",                        0, 0, false, "Query the tracker identity"},
+    };
+
+    // Eye (lens) status codes of the data-set status word, indexed by the 4-bit code
+    inline constexpr std::array<std::string_view, 16> kEyeStatus = {{
+        "No anomaly",
+        "Unknown (1)",
+        "Raw signal weak (NUC_PEAK_LOW)",
+        "Processed signal too weak (COR_HUMP_LOW)",
+        "Raw signal saturated (NUC_PEAK_HIGH)",
+        "Processed signal out of range (COR_SPACING_RANGE)",
+        "Signal noisy (NUC_HUMPS_FEW)",
+        "Unknown (7)",
+        "Unknown (8)",
+        "LR indeterminate (COR_ID_INDETERM_LR)",
+        "UD indeterminate (COR_ID_INDETERM_UD)",
+        "Unknown (11)",
+        "No signal (NUC_NOISE_ONLY)",
+        "Unknown (13)",
+        "Center out of range (COR_CENT_OUT_RANGE)",
+        "Unknown (15)",
+    }};
+    // clang-format on
+
+    // Code byte -> index into kCommands (0xFF: not a known command)
+    constexpr std::array<uint8_t, 256> buildCommandIndex()
+    {
+        std::array<uint8_t, 256> index{};
+        for (size_t i = 0; i < index.size(); ++i)
+            index[i] = 0xFF;
+        for (size_t i = 0; i < std::size(kCommands); ++i)
+            index[static_cast<uint8_t>(kCommands[i].code)] = static_cast<uint8_t>(i);
+        return index;
+    }
+    inline constexpr std::array<uint8_t, 256> kCommandIndex = buildCommandIndex();
+
+    // "Unknown Command 'c'" for every code byte, so unknown codes need no allocation either
+    struct UnknownCommandNames
+    {
+        static constexpr size_t kLength = 19;
+        char                    text[256][kLength + 1];
+    };
+    constexpr UnknownCommandNames buildUnknownCommandNames()
+    {
+        constexpr std::string_view prefix = "Unknown Command '";
+        UnknownCommandNames        names{};
+        for (size_t c = 0; c < 256; ++c)
+        {
+            for (size_t i = 0; i < prefix.size(); ++i)
+                names.text[c][i] = prefix[i];
+            names.text[c][prefix.size()]     = static_cast<char>(c);
+            names.text[c][prefix.size() + 1] = '\'';
+        }
+        return names;
+    }
+    inline constexpr UnknownCommandNames kUnknownCommandNames = buildUnknownCommandNames();
+
+    // Catalog entry of a command code, or nullptr
+    constexpr const PhoenixCommandInfo *findCommand(char code)
+    {
+        uint8_t i = kCommandIndex[static_cast<uint8_t>(code)];
+        return i == 0xFF ? nullptr : &kCommands[i];
+    }
+
+    // Human-readable command name ("Unknown Command 'c'" for codes not in the catalog)
+    constexpr std::string_view commandName(char code)
+    {
+        const PhoenixCommandInfo *info = findCommand(code);
+        if (info)
+            return info->name;
+        return std::string_view(kUnknownCommandNames.text[static_cast<uint8_t>(code)], UnknownCommandNames::kLength);
+    }
+
+    // Eye status description; only the low 4 bits of the status are meaningful
+    constexpr std::string_view eyeStatusDescription(uint8_t status)
+    {
+        return status < kEyeStatus.size() ? kEyeStatus[status] : std::string_view("Unknown");
+    }
+
+    static_assert(findCommand('p') != nullptr && findCommand('p')->bytesPerParam == 1, "catalog lookup");
+    static_assert(commandName('v') == "Set Sampling/Intermission Period", "catalog lookup");
+    static_assert(commandName('!') == "Unknown Command '!'", "unknown command name");
+} // namespace PhoenixCatalog
@@ -2,23 +2,35 @@
 
 #include <algorithm>
 #include <cstring>
+#include <deque>
 #include <sstream>
 #include <iomanip>
 
-// Read big-endian unsigned 32-bit from buffer
-static uint32_t readU32BE(const uint8_t *p)
-{
-    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
-}
+// Streamed decode of a capture: records of one direction wait at most this many records for
+// the other direction before they are decoded (see decode(DmsLogReader &, ...))
+static const size_t kMergeWindow = 4096;
 
-// Read big-endian signed 24-bit from buffer
-static int32_t readS24BE(const uint8_t *p)
+void PhoenixFrameCounts::add(const PhoenixFrame &frame)
 {
-    int32_t val = (int32_t(p[0]) << 16) | (int32_t(p[1]) << 8) | int32_t(p[2]);
-    // Sign-extend from 24 to 32 bits
-    if (val & 0x800000)
-        val |= 0xFF000000;
-    return val;
+    ++total;
+    switch (frame.type)
+    {
+        case PhoenixFrameType::Command:
+            ++commands;
+            break;
+        case PhoenixFrameType::DataSet:
+            ++dataSets;
+            break;
+        case PhoenixFrameType::Message:
+            ++messages;
+            break;
+        case PhoenixFrameType::InitMessage:
+            ++initMessages;
+            break;
+        case PhoenixFrameType::Unknown:
+            ++unknown;
+            break;
+    }
 }
 
 std::string PhoenixInitMessage::serialNumberHex() const
@@ -33,7 +45,7 @@ std::string PhoenixInitMessage::serialNumberHex() const
 
 std::string PhoenixCommand::description() const
 {
-    std::string        name = PhoenixDecoder::commandName(commandCode);
+    std::string_view   name = PhoenixDecoder::commandName(commandCode);
     std::ostringstream ss;
     ss << "&" << commandCode << commandIndex;
     ss << " (" << name << ")";
@@ -52,181 +64,27 @@ std::string PhoenixCommand::description() const
     return ss.str();
 }
 
-std::string PhoenixDecoder::commandName(char code)
-{
-    switch (code)
-    {
-        // Reset
-        case '`':
-            return "Software Reset";
-
-        // Settings
-        case 'L':
-            return "Set Signal Quality Requirement (SQR)";
-        case 'O':
-            return "Set Minimum Signal Requirement (MSR)";
-        case 'P':
-            return "Enable Double Sampling";
-        case 'Q':
-            return "Enable Single Sampling";
-        case 'S':
-            return "Enable Internal Triggering";
-        case 'U':
-            return "Set Sample Operation Time (SOT)";
-        case 'V':
-            return "Set Manual Exposure";
-        case 'W':
-            return "Enable Automatic Exposure";
-        case 'X':
-            return "Set Multi-Rate Sampling Mode";
-        case 'Y':
-            return "Set Auto-Exposure Gain";
-        case '6':
-            return "Set Number of Capture Cycles";
-        case '7':
-            return "Ping";
-        case 'u':
-            return "Toggle Marker On/Off";
-        case 'v':
-            return "Set Sampling/Intermission Period";
-        case '^':
-            return "Enable Tether Mode";
-        case '_':
-            return "Enable Tetherless Mode";
-
-        // Marker control
-        case 'n':
-            return "TCM Sync on First-TCMID";
-        case 'o':
-            return "TCM Sync on End-Of-Frame";
-        case 'p':
-            return "Target Flashing Sequence (TFS)";
-        case 'q':
-            return "Ready All TCMs";
-        case 'r':
-            return "Program TFS Into TCMs";
-        case ']':
-            return "Reset All TCMs";
-
-        // Capture actions
-        case '3':
-            return "Start Periodic Sampling";
-        case '5':
-            return "Stop Periodic Sampling";
-        case 'G':
-            return "Activate Vibrator";
-        case 'N':
-            return "Wait for Pulse then Start";
-        case 'R':
-            return "Enable External Triggering";
-
-        // Internal/factory
-        case '=':
-            return "Return Raw Sensor Data";
-        case '<':
-            return "Return 3D Coordinates";
-        case ';':
-            return "Return Raw + 3D";
-        case '9':
-            return "Enable Refraction Compensation";
-        case ':':
-            return "Disable Refraction Compensation";
-        case 'Z':
-            return "Set Desired Signal Peak";
-        case 'K':
-            return "External Start + External Trigger";
-        case 'J':
-            return "Fetch Misalignment Parameter";
-        case 'M':
-            return "Change Misalignment Parameter";
-        case 'x':
-            return "Burn Misalignment to ROM";
-
-        case '?':
-            return "Query/Identify";
-
-        default:
-        {
-            std::string s = "Unknown Command '";
-            s += code;
-            s += "'";
-            return s;
-        }
-    }
-}
-
-std::string PhoenixDecoder::eyeStatusDescription(uint8_t status)
-{
-    switch (status)
-    {
-        case 0:
-            return "No anomaly";
-        case 2:
-            return "Raw signal weak (NUC_PEAK_LOW)";
-        case 3:
-            return "Processed signal too weak (COR_HUMP_LOW)";
-        case 4:
-            return "Raw signal saturated (NUC_PEAK_HIGH)";
-        case 5:
-            return "Processed signal out of range (COR_SPACING_RANGE)";
-        case 6:
-            return "Signal noisy (NUC_HUMPS_FEW)";
-        case 9:
-            return "LR indeterminate (COR_ID_INDETERM_LR)";
-        case 10:
-            return "UD indeterminate (COR_ID_INDETERM_UD)";
-        case 12:
-            return "No signal (NUC_NOISE_ONLY)";
-        case 14:
-            return "Center out of range (COR_CENT_OUT_RANGE)";
-        default:
-            return "Unknown (" + std::to_string(status) + ")";
-    }
-}
-
-PhoenixDataSet PhoenixDecoder::decodeDataSet(const uint8_t *p)
+// Gather one record's fields from the batch-decoded columns
+static PhoenixDataSet dataSetAt(const DataSetColumns &c, size_t i)
 {
     PhoenixDataSet ds{};
-    ds.timestamp_us    = readU32BE(p);
-    ds.x               = readS24BE(p + 4);
-    ds.y               = readS24BE(p + 7);
-    ds.z               = readS24BE(p + 10);
-    ds.statusWord      = readU32BE(p + 13);
-    ds.ledId           = p[17] & 0x7F;
-    ds.tcmId           = p[18] & 0x0F;
-
-    // Decode status word fields
-    // Byte 14 (MSB of status): E | HHH | mmmm
-    uint8_t b14        = p[13];
-    ds.endOfFrame      = (b14 >> 7) & 1;
-    ds.coordStatus     = (b14 >> 4) & 0x07;
-    ds.ambientLight    = b14 & 0x0F;
-
-    // Byte 15: 111 | La | AAAA  (but 111 are part of check pattern? No, they're status)
-    // Actually per the protocol doc:
-    // Status word is bytes 14-17 of the 19-byte frame (0-indexed: bytes 13-16)
-    // Byte 14: E_HHH_mmmm
-    // Byte 15: TTT_La_AAAA -> wait, let me re-check
-    // From the protocol doc:
-    //   Byte 14 (MSB): E | HHH | mmmm
-    //   Byte 15:        111 | La | AAAA
-    //   Byte 16:        TTT | Lb | BBBB
-    //   Byte 17 (LSB):  TTT | Lc | CCCC
-    uint8_t b15        = p[14];
-    ds.rightEyeSignal  = (b15 >> 4) & 0x01;
-    ds.rightEyeStatus  = b15 & 0x0F;
-
-    uint8_t b16        = p[15];
-    ds.centerEyeSignal = (b16 >> 4) & 0x01;
-    ds.centerEyeStatus = b16 & 0x0F;
-
-    uint8_t b17        = p[16];
-    ds.leftEyeSignal   = (b17 >> 4) & 0x01;
-    ds.leftEyeStatus   = b17 & 0x0F;
-
-    // Trigger index: upper 3 bits of byte 16 + upper 3 bits of byte 17
-    ds.triggerIndex    = ((b16 >> 5) & 0x07) << 3 | ((b17 >> 5) & 0x07);
-
+    ds.timestamp_us    = c.timestamp_us[i];
+    ds.x               = c.x[i];
+    ds.y               = c.y[i];
+    ds.z               = c.z[i];
+    ds.statusWord      = c.statusWord[i];
+    ds.ledId           = c.ledId[i];
+    ds.tcmId           = c.tcmId[i];
+    ds.endOfFrame      = c.endOfFrame[i] != 0;
+    ds.coordStatus     = c.coordStatus[i];
+    ds.ambientLight    = c.ambientLight[i];
+    ds.rightEyeSignal  = c.rightEyeSignal[i];
+    ds.rightEyeStatus  = c.rightEyeStatus[i];
+    ds.centerEyeSignal = c.centerEyeSignal[i];
+    ds.centerEyeStatus = c.centerEyeStatus[i];
+    ds.leftEyeSignal   = c.leftEyeSignal[i];
+    ds.leftEyeStatus   = c.leftEyeStatus[i];
+    ds.triggerIndex    = c.triggerIndex[i];
     return ds;
 }
 
@@ -250,10 +108,12 @@ PhoenixInitMessage PhoenixDecoder::decodeInitMessage(const uint8_t *p)
     return init;
 }
 
-void PhoenixDecoder::decodeTxRecord(uint64_t irpTimestamp, const std::vector<uint8_t> &data, std::vector<PhoenixFrame> &frames)
+void PhoenixDecoder::decodeTxRecord(uint64_t irpTimestamp, ByteView data, std::vector<PhoenixFrame> &frames)
 {
     // TX data contains one or more commands.
-    // Each command: '&' + code + index + bytesPerParam + numParams + CR + binary params
+    // Each command: '&' + code + index + bytesPerParam + numParams + CR + binary params.
+    // Frames view one arena copy of the record, so they do not depend on the caller's buffer.
+    data       = m_arena.copy(data);
     size_t pos = 0;
     while (pos < data.size())
     {
@@ -272,6 +132,7 @@ void PhoenixDecoder::decodeTxRecord(uint64_t irpTimestamp, const std::vector<uin
         frame.irpTimestamp  = irpTimestamp;
         frame.isTx          = true;
 
+        frame.command       = PhoenixCommand(); // make the command the active union member
         PhoenixCommand &cmd = frame.command;
         cmd.commandCode     = static_cast<char>(data[pos + 1]);
         cmd.commandIndex    = static_cast<char>(data[pos + 2]);
@@ -284,12 +145,12 @@ void PhoenixDecoder::decodeTxRecord(uint64_t irpTimestamp, const std::vector<uin
 
         // Collect raw bytes
         size_t rawEnd       = std::min(pos + totalLen, data.size());
-        frame.rawBytes.assign(data.begin() + pos, data.begin() + rawEnd);
+        frame.rawBytes      = ByteView(data.data() + pos, rawEnd - pos);
 
         // Extract parameter bytes
         if (paramBytes > 0 && pos + 6 + paramBytes <= data.size())
         {
-            cmd.params.assign(data.begin() + pos + 6, data.begin() + pos + 6 + paramBytes);
+            cmd.params = ByteView(data.data() + pos + 6, paramBytes);
         }
 
         frames.push_back(std::move(frame));
@@ -297,31 +158,109 @@ void PhoenixDecoder::decodeTxRecord(uint64_t irpTimestamp, const std::vector<uin
     }
 }
 
-void PhoenixDecoder::decodeRxRecord(uint64_t irpTimestamp, const std::vector<uint8_t> &data, std::vector<PhoenixFrame> &frames)
+void PhoenixDecoder::decodeRxRecord(uint64_t irpTimestamp, ByteView data, std::vector<PhoenixFrame> &frames)
+{
+    // RX data is a stream of 19-byte frames; the framer carries frames split across IRPs and
+    // re-aligns after lost bytes, so an odd-sized record no longer throws away the rest.
+    m_rxPushed += data.size();
+    m_rxOrigins.push_back({m_rxPushed, irpTimestamp, m_recordSeq});
+    m_rxFramer.push(data, [this](ByteView bytes, bool skipped) { collectRx(bytes, skipped); });
+    emitRxFrames(frames);
+}
+
+void PhoenixDecoder::flushRx(std::vector<PhoenixFrame> &frames)
+{
+    m_rxFramer.flush([this](ByteView bytes, bool skipped) { collectRx(bytes, skipped); });
+    emitRxFrames(frames);
+}
+
+void PhoenixDecoder::resetRx()
+{
+    m_rxFramer.reset();
+    m_rxFrameBytes.clear();
+    m_rxFrameOrigins.clear();
+    m_rxSkipped.clear();
+    m_rxOrigins.clear();
+    m_rxPushed  = 0;
+    m_rxEmitted = 0;
+    m_heldTx.clear();
+}
+
+PhoenixDecoder::RxOrigin PhoenixDecoder::rxOriginAt(uint64_t offset)
+{
+    // Records whose bytes have all been emitted are not asked for again
+    while (m_rxOrigins.size() > 1 && m_rxOrigins.front().end <= m_rxEmitted)
+        m_rxOrigins.pop_front();
+    for (const auto &origin : m_rxOrigins)
+    {
+        if (offset < origin.end)
+            return origin;
+    }
+    return m_rxOrigins.back();
+}
+
+void PhoenixDecoder::collectRx(ByteView bytes, bool skipped)
 {
-    // RX data contains one or more 19-byte frames.
-    // All RX packets are exact multiples of 19 bytes.
-    if (data.size() % 19 != 0)
+    if (!skipped)
     {
-        // Unexpected size - store as unknown
-        PhoenixFrame frame;
-        frame.type         = PhoenixFrameType::Unknown;
-        frame.irpTimestamp = irpTimestamp;
-        frame.isTx         = false;
-        frame.rawBytes     = data;
-        frames.push_back(std::move(frame));
+        m_rxFrameOrigins.push_back({rxOriginAt(m_rxEmitted), rxOriginAt(m_rxEmitted + bytes.size() - 1)});
+        m_rxFrameBytes.insert(m_rxFrameBytes.end(), bytes.begin(), bytes.end());
+        m_rxEmitted += bytes.size();
         return;
     }
 
-    size_t numFrames = data.size() / 19;
-    for (size_t i = 0; i < numFrames; ++i)
+    // Discarded bytes are reported per source record, each piece with its own record's timestamp
+    while (!bytes.empty())
+    {
+        RxOrigin origin = rxOriginAt(m_rxEmitted);
+        size_t   n      = static_cast<size_t>(std::min<uint64_t>(bytes.size(), origin.end - m_rxEmitted));
+        m_rxSkipped.push_back({m_rxFrameBytes.size() / PhoenixFramer::kFrameSize, m_arena.copy(bytes.data(), n), origin});
+        m_rxEmitted += n;
+        bytes        = ByteView(bytes.data() + n, bytes.size() - n);
+    }
+}
+
+void PhoenixDecoder::releaseHeldTx(uint64_t beforeSeq, std::vector<PhoenixFrame> &frames)
+{
+    size_t n = 0;
+    for (; n < m_heldTx.size() && m_heldTx[n].first < beforeSeq; ++n)
+        frames.push_back(m_heldTx[n].second);
+    m_heldTx.erase(m_heldTx.begin(), m_heldTx.begin() + n);
+}
+
+void PhoenixDecoder::emitRxFrames(std::vector<PhoenixFrame> &frames)
+{
+    // Frames view one arena copy of the framed bytes
+    ByteView data      = m_arena.copy(m_rxFrameBytes.data(), m_rxFrameBytes.size());
+    size_t   numFrames = data.size() / 19;
+
+    // Decode every frame as a data set in one SIMD batch; only the frames classified as data sets are used
+    m_columns.clear();
+    decodeDataSets(data.data(), numFrames, m_columns);
+
+    size_t skippedRun = 0;
+    for (size_t i = 0; i <= numFrames; ++i)
     {
+        // Bytes discarded while re-aligning, in stream order before frame i
+        for (; skippedRun < m_rxSkipped.size() && m_rxSkipped[skippedRun].nextFrame == i; ++skippedRun)
+        {
+            const RxSkipped &skipped = m_rxSkipped[skippedRun];
+            PhoenixFrame     frame;
+            frame.type         = PhoenixFrameType::Unknown;
+            frame.irpTimestamp = skipped.origin.timestamp;
+            frame.isTx         = false;
+            frame.rawBytes     = skipped.bytes;
+            releaseHeldTx(skipped.origin.seq, frames);
+            frames.push_back(std::move(frame));
+        }
+        if (i == numFrames)
+            break;
+
         const uint8_t *p = data.data() + i * 19;
 
         PhoenixFrame frame;
-        frame.irpTimestamp = irpTimestamp;
-        frame.isTx         = false;
-        frame.rawBytes.assign(p, p + 19);
+        frame.isTx     = false;
+        frame.rawBytes = ByteView(p, 19);
 
         // Classify the 19-byte frame:
         // 1. Init message: bytes 0-3 = {01, 02, 03, 04}
@@ -337,10 +276,10 @@ void PhoenixDecoder::decodeRxRecord(uint64_t irpTimestamp, const std::vector<uin
             frame.message = decodeMessage(p);
         }
         // 3. DATA set: byte 18 has upper nibble 0xE0 and byte 17 has bit 7 set
-        else if ((p[18] & 0xF0) == 0xE0 && (p[17] & 0x80) == 0x80)
+        else if (PhoenixFramer::isDataSet(p))
         {
             frame.type    = PhoenixFrameType::DataSet;
-            frame.dataSet = decodeDataSet(p);
+            frame.dataSet = dataSetAt(m_columns, i);
         }
         // 4. Also check for MESSAGE sets with error codes (messageId != 0x06)
         else if (p[0] >= 0x20 && p[0] < 0x7F && p[1] >= 0x20 && p[1] < 0x7F)
@@ -354,24 +293,170 @@ void PhoenixDecoder::decodeRxRecord(uint64_t irpTimestamp, const std::vector<uin
             frame.type = PhoenixFrameType::Unknown;
         }
 
+        // A frame counts as received with its last byte; an unknown frame is stamped with the
+        // record its first byte came from, so held-back line noise keeps its place in time
+        const RxOrigin &origin = frame.type == PhoenixFrameType::Unknown ? m_rxFrameOrigins[i].first : m_rxFrameOrigins[i].last;
+        frame.irpTimestamp     = origin.timestamp;
+        releaseHeldTx(origin.seq, frames);
         frames.push_back(std::move(frame));
     }
+
+    // Commands wait only for the bytes received before them that the framer still holds
+    releaseHeldTx(m_rxFramer.pending() > 0 ? rxOriginAt(m_rxEmitted).seq : UINT64_MAX, frames);
+
+    m_rxFrameBytes.clear();
+    m_rxFrameOrigins.clear();
+    m_rxSkipped.clear();
+}
+
+// Helper: visit two time-ordered record streams in merged order, TX first on equal timestamps
+// (the order a stable sort of the TX frames followed by the RX frames produces).
+template <typename Visit> static void mergeByTime(const TimedRecords &txRecords, const TimedRecords &rxRecords, Visit visit)
+{
+    size_t i = 0, j = 0;
+    while (i < txRecords.size() || j < rxRecords.size())
+    {
+        if (j == rxRecords.size() || (i < txRecords.size() && txRecords[i].first <= rxRecords[j].first))
+        {
+            visit(txRecords[i], true);
+            ++i;
+        }
+        else
+        {
+            visit(rxRecords[j], false);
+            ++j;
+        }
+    }
+}
+
+static bool isTimeOrdered(const TimedRecords &records)
+{
+    return std::is_sorted(records.begin(), records.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
 }
 
-void PhoenixDecoder::decode(const std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &txRecords,
-                            const std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &rxRecords, std::vector<PhoenixFrame> &frames)
+void PhoenixDecoder::decodeTimed(uint64_t irpTimestamp, ByteView data, bool isTx, std::vector<PhoenixFrame> &frames)
 {
+    ++m_recordSeq;
+    if (!isTx)
+    {
+        decodeRxRecord(irpTimestamp, data, frames);
+        return;
+    }
+    if (!m_holdTx || m_rxFramer.pending() == 0)
+    {
+        decodeTxRecord(irpTimestamp, data, frames);
+        return;
+    }
+
+    // The framer still holds RX bytes received before this command: the command waits until
+    // their frames are out, so it cannot get ahead of them
+    size_t first = frames.size();
+    decodeTxRecord(irpTimestamp, data, frames);
+    for (size_t i = first; i < frames.size(); ++i)
+        m_heldTx.emplace_back(m_recordSeq, frames[i]);
+    frames.resize(first);
+}
+
+void PhoenixDecoder::decodeStep(uint64_t irpTimestamp, ByteView data, bool isTx, const FrameSink &sink)
+{
+    m_scratch.clear();
+    if (m_heldTx.empty())
+        m_arena.release(); // held commands view the arena until they are passed on
+    decodeTimed(irpTimestamp, data, isTx, m_scratch);
+    for (const auto &frame : m_scratch)
+        sink(frame);
+}
+
+void PhoenixDecoder::decode(const TimedRecords &txRecords, const TimedRecords &rxRecords, std::vector<PhoenixFrame> &frames)
+{
+    resetRx();
+    if (frames.empty() && isTimeOrdered(txRecords) && isTimeOrdered(rxRecords))
+    {
+        m_holdTx = true;
+        mergeByTime(txRecords, rxRecords, [&](const std::pair<uint64_t, ByteView> &rec, bool isTx) { decodeTimed(rec.first, rec.second, isTx, frames); });
+        flushRx(frames); // end of the RX stream
+        m_holdTx = false;
+        return;
+    }
 
     for (const auto &[ts, data] : txRecords)
     {
-        decodeTxRecord(ts, data, frames);
+        decodeTimed(ts, data, true, frames);
     }
 
     for (const auto &[ts, data] : rxRecords)
     {
-        decodeRxRecord(ts, data, frames);
+        decodeTimed(ts, data, false, frames);
     }
+    flushRx(frames);
 
     // Sort all frames by IRP timestamp for chronological output
     std::stable_sort(frames.begin(), frames.end(), [](const PhoenixFrame &a, const PhoenixFrame &b) { return a.irpTimestamp < b.irpTimestamp; });
 }
+
+void PhoenixDecoder::decode(const TimedRecords &txRecords, const TimedRecords &rxRecords, const FrameSink &sink)
+{
+    if (!isTimeOrdered(txRecords) || !isTimeOrdered(rxRecords))
+    {
+        std::vector<PhoenixFrame> frames;
+        decode(txRecords, rxRecords, frames);
+        for (const auto &frame : frames)
+            sink(frame);
+        reset();
+        return;
+    }
+
+    resetRx();
+    m_holdTx = true;
+    mergeByTime(txRecords, rxRecords, [&](const std::pair<uint64_t, ByteView> &rec, bool isTx) { decodeStep(rec.first, rec.second, isTx, sink); });
+    finish(sink); // end of the RX stream
+    m_holdTx = false;
+}
+
+void PhoenixDecoder::decodeRecord(const IrpRecord &rec, const FrameSink &sink)
+{
+    decodeStep(rec.timestamp, rec.serialData, rec.isTx(), sink);
+}
+
+void PhoenixDecoder::finish(const FrameSink &sink)
+{
+    m_scratch.clear();
+    if (m_heldTx.empty())
+        m_arena.release();
+    flushRx(m_scratch);
+    for (const auto &frame : m_scratch)
+        sink(frame);
+}
+
+void PhoenixDecoder::decode(DmsLogReader &reader, const FrameSink &sink)
+{
+    resetRx();
+    m_holdTx = true;
+
+    // One pass in file order. Each direction is queued until the other direction shows which
+    // record comes first; the smaller timestamp goes next, TX first on equal timestamps (the
+    // merge of the vector decode()). Captures are written in event order, so a queue only grows
+    // while the other direction is silent, and is then drained after kMergeWindow records.
+    std::deque<IrpRecord> queued[2]; // TX, RX
+    auto                  decodeNext = [&]
+    {
+        bool       takeTx = queued[1].empty() || (!queued[0].empty() && queued[0].front().timestamp <= queued[1].front().timestamp);
+        IrpRecord &rec    = queued[takeTx ? 0 : 1].front();
+        decodeStep(rec.timestamp, rec.serialData, takeTx, sink);
+        queued[takeTx ? 0 : 1].pop_front();
+    };
+
+    RecordCursor cursor = reader.cursor();
+    IrpRecord    rec;
+    while (cursor.next(rec))
+    {
+        queued[rec.isTx() ? 0 : 1].push_back(rec);
+        while ((!queued[0].empty() && !queued[1].empty()) || queued[0].size() + queued[1].size() > kMergeWindow)
+            decodeNext();
+    }
+    while (!queued[0].empty() || !queued[1].empty())
+        decodeNext();
+
+    finish(sink); // end of the RX stream
+    m_holdTx = false;
+}
@@ -1,7 +1,18 @@
 #pragma once
 
+#include "ByteArena.h"
+#include "ByteView.h"
+#include "DataSetBatch.h"
+#include "DmsLogReader.h"
+#include "PhoenixCatalog.h"
+#include "PhoenixFramer.h"
+
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // ---- Phoenix VZK10 protocol structures ----
@@ -60,17 +71,17 @@ struct PhoenixInitMessage
 // Command sent from host to tracker
 struct PhoenixCommand
 {
-    char                 commandCode;
-    char                 commandIndex;
-    uint8_t              bytesPerParam; // ASCII digit '0'-'9' -> 0-9
-    uint8_t              numParams;     // ASCII digit '0'-'9' -> 0-9
-    std::vector<uint8_t> params;
+    char     commandCode;
+    char     commandIndex;
+    uint8_t  bytesPerParam; // ASCII digit '0'-'9' -> 0-9
+    uint8_t  numParams;     // ASCII digit '0'-'9' -> 0-9
+    ByteView params;        // binary parameter bytes (part of the frame's rawBytes)
 
     std::string description() const;
 };
 
 // Type of a decoded Phoenix frame
-enum class PhoenixFrameType
+enum class PhoenixFrameType : uint8_t
 {
     Command,     // TX: host -> tracker
     DataSet,     // RX: 3D coordinate data
@@ -79,39 +90,140 @@ enum class PhoenixFrameType
     Unknown
 };
 
-// A single decoded frame with its IRP timestamp
+// A single decoded frame with its IRP timestamp.
+// Tagged layout: `type` selects the one meaningful payload member of the union.
+// rawBytes (and a command's params) are views into the decoder's arena (see PhoenixDecoder).
 struct PhoenixFrame
 {
-    PhoenixFrameType type;
+    PhoenixFrame() : dataSet() {}
+
     uint64_t         irpTimestamp; // Windows FILETIME from the IRP record
-    bool             isTx;         // true = host->device, false = device->host
-
-    // Only one of these is populated depending on type
-    PhoenixCommand       command;
-    PhoenixDataSet       dataSet;
-    PhoenixMessage       message;
-    PhoenixInitMessage   initMessage;
-    std::vector<uint8_t> rawBytes;
+    ByteView         rawBytes;
+    PhoenixFrameType type;
+    bool             isTx; // true = host->device, false = device->host
+
+    union
+    {
+        PhoenixDataSet     dataSet;     // type == DataSet
+        PhoenixCommand     command;     // type == Command
+        PhoenixMessage     message;     // type == Message
+        PhoenixInitMessage initMessage; // type == InitMessage
+    };
 };
 
-class PhoenixDecoder
+static_assert(sizeof(PhoenixFrame) <= 64, "a decoded frame should fit in one cache line");
+
+// Receives decoded frames one at a time, in output order.
+using FrameSink = std::function<void(const PhoenixFrame &)>;
+
+// Per-type frame counts (summary statistics).
+struct PhoenixFrameCounts
 {
-  public:
-    // Decode all frames from IRP serial data records.
-    // irpRecords: pairs of (irpTimestamp, serialData) - already separated into TX/RX by DmsLogReader.
-    void decode(const std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &txRecords,
-                const std::vector<std::pair<uint64_t, std::vector<uint8_t>>> &rxRecords, std::vector<PhoenixFrame> &frames);
+    size_t total        = 0;
+    size_t commands     = 0;
+    size_t dataSets     = 0;
+    size_t messages     = 0;
+    size_t initMessages = 0;
+    size_t unknown      = 0;
+
+    void add(const PhoenixFrame &frame);
+};
 
-    // Get human-readable command name
-    static std::string commandName(char code);
+// Serial data records of one direction: pairs of (irpTimestamp, serialData).
+using TimedRecords = std::vector<std::pair<uint64_t, ByteView>>;
 
-    // Get eye status description
-    static std::string eyeStatusDescription(uint8_t status);
+class PhoenixDecoder
+{
+  public:
+    // Decode all frames from IRP serial data records, in chronological order.
+    // txRecords/rxRecords: already separated into TX/RX by DmsLogReader, each in file (time) order.
+    // The two streams are merged in O(n), TX first on equal timestamps; a stream that is not in
+    // time order falls back to a stable sort of all frames, with the same result.
+    // An RX frame is stamped with the record that delivered its last byte (an unknown frame: its
+    // first byte), and a command never gets ahead of RX frames from bytes received before it.
+    // The serial data is copied into the decoder's arena, so frames stay valid after the reader is
+    // closed, until reset() or the decoder is destroyed.
+    void decode(const TimedRecords &txRecords, const TimedRecords &rxRecords, std::vector<PhoenixFrame> &frames);
+
+    // Streaming variant: frames go to `sink` in the same order, without holding them all.
+    // Frames are only valid during the sink call.
+    void decode(const TimedRecords &txRecords, const TimedRecords &rxRecords, const FrameSink &sink);
+
+    // Decode a single serial data record (TX or RX) and pass its frames to `sink`, in file order
+    // (no merge by timestamp). Reuses the arena: frames are only valid until the next
+    // decodeRecord() call. RX frames split across records are completed by the following RX record.
+    void decodeRecord(const IrpRecord &rec, const FrameSink &sink);
+
+    // End of a decodeRecord() stream: pass the RX bytes still held by the framer to `sink`.
+    void finish(const FrameSink &sink);
+
+    // Stream-decode every record of an open capture in one pass, merged by timestamp as above.
+    // Records are queued until the other direction catches up, at most a few thousand of them
+    // (views into the mapping), so memory stays constant.
+    void decode(DmsLogReader &reader, const FrameSink &sink);
+
+    // Release the byte storage of all decoded frames at once
+    void reset() { m_arena.release(); }
+
+    // Get human-readable command name (from PhoenixCatalog; static storage, no allocation)
+    static std::string_view commandName(char code) { return PhoenixCatalog::commandName(code); }
+
+    // Get eye status description (from PhoenixCatalog)
+    static std::string_view eyeStatusDescription(uint8_t status) { return PhoenixCatalog::eyeStatusDescription(status); }
 
   private:
-    void               decodeTxRecord(uint64_t irpTimestamp, const std::vector<uint8_t> &data, std::vector<PhoenixFrame> &frames);
-    void               decodeRxRecord(uint64_t irpTimestamp, const std::vector<uint8_t> &data, std::vector<PhoenixFrame> &frames);
-    PhoenixDataSet     decodeDataSet(const uint8_t *p);
+    // The RX record that delivered a stretch of the RX byte stream: bytes up to stream offset `end`,
+    // with the record's IRP timestamp and its position `seq` among all decoded records
+    struct RxOrigin
+    {
+        uint64_t end;
+        uint64_t timestamp;
+        uint64_t seq;
+    };
+
+    // Records of the first and last byte of a framed RX frame
+    struct RxFrameOrigin
+    {
+        RxOrigin first;
+        RxOrigin last;
+    };
+
+    // Bytes discarded while re-aligning (never spanning two records)
+    struct RxSkipped
+    {
+        size_t   nextFrame; // index of the frame that follows them
+        ByteView bytes;
+        RxOrigin origin;
+    };
+
+    void               decodeTimed(uint64_t irpTimestamp, ByteView data, bool isTx, std::vector<PhoenixFrame> &frames);
+    void               decodeStep(uint64_t irpTimestamp, ByteView data, bool isTx, const FrameSink &sink);
+    void               decodeTxRecord(uint64_t irpTimestamp, ByteView data, std::vector<PhoenixFrame> &frames);
+    void               decodeRxRecord(uint64_t irpTimestamp, ByteView data, std::vector<PhoenixFrame> &frames);
+    void               flushRx(std::vector<PhoenixFrame> &frames);
+    void               resetRx();
+    RxOrigin           rxOriginAt(uint64_t offset);
+    void               collectRx(ByteView bytes, bool skipped);
+    void               emitRxFrames(std::vector<PhoenixFrame> &frames);
+    void               releaseHeldTx(uint64_t beforeSeq, std::vector<PhoenixFrame> &frames);
     PhoenixMessage     decodeMessage(const uint8_t *p);
     PhoenixInitMessage decodeInitMessage(const uint8_t *p);
+
+    ByteArena                 m_arena;   // storage for frame rawBytes/params
+    std::vector<PhoenixFrame> m_scratch; // per-record frame buffer reused by decodeRecord
+    DataSetColumns            m_columns; // batch-decoded data sets of the current RX record
+
+    // RX stream framing
+    PhoenixFramer              m_rxFramer;
+    std::vector<uint8_t>       m_rxFrameBytes;   // frames completed by the current RX record
+    std::vector<RxFrameOrigin> m_rxFrameOrigins; // per frame in m_rxFrameBytes
+    std::vector<RxSkipped>     m_rxSkipped;
+    std::deque<RxOrigin>       m_rxOrigins;      // records of the bytes not yet emitted by the framer
+    uint64_t                   m_rxPushed  = 0;  // stream offset after the last byte pushed to the framer
+    uint64_t                   m_rxEmitted = 0;  // stream offset of the next byte the framer emits
+
+    // Merged decoding: commands held back behind RX bytes received before them
+    bool                                           m_holdTx    = false;
+    uint64_t                                       m_recordSeq = 0;
+    std::vector<std::pair<uint64_t, PhoenixFrame>> m_heldTx; // (record seq, frame)
 };
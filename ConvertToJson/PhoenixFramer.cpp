@@ -0,0 +1,125 @@
+#include "PhoenixFramer.h"
+
+bool PhoenixFramer::isFrameStart(const uint8_t *p)
+{
+    if (isDataSet(p))
+        return true;
+    if (p[0] == 0x01 && p[1] == 0x02 && p[2] == 0x03 && p[3] == 0x04)
+        return true;
+    return p[14] == 0x06 && p[0] >= 0x20 && p[0] < 0x7F;
+}
+
+void PhoenixFramer::push(ByteView bytes, const Sink &sink)
+{
+    if (m_buffer.empty())
+    {
+        // Frame straight from the caller's memory; only the unframed tail is copied
+        size_t used = process(bytes.data(), bytes.size(), false, sink);
+        m_buffer.assign(bytes.begin() + used, bytes.end());
+        return;
+    }
+
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+    size_t used = process(m_buffer.data(), m_buffer.size(), false, sink);
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + used);
+}
+
+void PhoenixFramer::flush(const Sink &sink)
+{
+    size_t used = process(m_buffer.data(), m_buffer.size(), true, sink);
+    skip(m_buffer.data() + used, m_buffer.size() - used, sink);
+    m_buffer.clear();
+    m_aligned = true;
+}
+
+size_t PhoenixFramer::frame(ByteView bytes, const Sink &sink, size_t maxFrames)
+{
+    return process(bytes.data(), bytes.size(), false, sink, maxFrames);
+}
+
+void PhoenixFramer::reset()
+{
+    m_buffer.clear();
+    m_aligned      = true;
+    m_skippedBytes = 0;
+    m_resyncCount  = 0;
+}
+
+void PhoenixFramer::skip(const uint8_t *p, size_t n, const Sink &sink)
+{
+    if (n == 0)
+        return;
+    m_skippedBytes += n;
+    sink(ByteView(p, n), true);
+}
+
+// Frame as much of data[0, size) as possible; returns the number of bytes consumed.
+// `final` accepts frames that cannot be confirmed because the stream ends.
+size_t PhoenixFramer::process(const uint8_t *data, size_t size, bool final, const Sink &sink, size_t maxFrames)
+{
+    const size_t N = kFrameSize;
+
+    size_t i      = 0;
+    size_t frames = 0;
+    while (size - i >= N && frames < maxFrames)
+    {
+        const uint8_t *p = data + i;
+        if (m_aligned)
+        {
+            if (isFrameStart(p))
+            {
+                sink(ByteView(p, N), false);
+                i += N;
+                ++frames;
+                continue;
+            }
+
+            // An unrecognised frame is kept when the two frames after it are on the same alignment;
+            // otherwise bytes were lost or inserted and the stream has to be re-aligned.
+            if (size - i < 3 * N && !final)
+                break;
+            if (final || (isFrameStart(p + N) && isFrameStart(p + 2 * N)))
+            {
+                sink(ByteView(p, N), false);
+                i += N;
+                ++frames;
+                continue;
+            }
+            m_aligned = false;
+            ++m_resyncCount;
+        }
+
+        // Hunt for the next offset where two consecutive frames pass the structural checks
+        size_t j     = i;
+        bool   found = false;
+        for (; j + N <= size; ++j)
+        {
+            if (!isFrameStart(data + j))
+                continue;
+            if (j + 2 * N <= size)
+            {
+                if (isFrameStart(data + j + N))
+                {
+                    found = true;
+                    break;
+                }
+            }
+            else if (final)
+            {
+                found = true;
+                break;
+            }
+            else
+            {
+                break; // the candidate needs the next frame for confirmation
+            }
+        }
+
+        skip(data + i, j - i, sink);
+        i = j;
+        if (!found)
+            break;
+        m_aligned = true;
+    }
+    return i;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ByteView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Incremental framer for the tracker's RX byte stream (fixed 19-byte frames).
+// Bytes may arrive in arbitrary chunks (IRP payloads, serial port reads); a frame split across
+// chunks is carried over to the next push(). After a dropped or inserted byte the framer
+// re-aligns on the next position where two consecutive frames pass the structural checks
+// (data set, init message or ACK) instead of cutting every following frame at the wrong offset.
+class PhoenixFramer
+{
+  public:
+    static const size_t kFrameSize = 19;
+
+    // Receives each complete frame (kFrameSize bytes, skipped == false) and each run of bytes
+    // discarded while re-aligning (skipped == true). The view is only valid during the call.
+    using Sink = std::function<void(ByteView bytes, bool skipped)>;
+
+    // Frame the next chunk of the stream
+    void push(ByteView bytes, const Sink &sink);
+
+    // End of stream: frame what is left without waiting for confirmation, then discard the remainder
+    void flush(const Sink &sink);
+
+    // Frame in place from memory the caller keeps (a receive ring): nothing is buffered, and the
+    // return value is the number of bytes consumed. The unconsumed rest (a partial or unconfirmed
+    // frame) must be presented again at the front of the next call. Stops after `maxFrames`
+    // frames. Do not mix with push() on the same framer.
+    size_t frame(ByteView bytes, const Sink &sink, size_t maxFrames = static_cast<size_t>(-1));
+
+    void reset();
+
+    size_t   pending() const { return m_buffer.size(); }
+    bool     aligned() const { return m_aligned; }
+    uint64_t skippedBytes() const { return m_skippedBytes; }
+    uint64_t resyncCount() const { return m_resyncCount; }
+
+    // Structural invariants of a frame starting at `p` (kFrameSize bytes):
+    //   data set     byte 18 upper nibble 0xE and byte 17 bit 7 set
+    //   init message bytes 0-3 = 01 02 03 04
+    //   ACK message  byte 14 = 0x06 and a printable command code in byte 0
+    static bool isDataSet(const uint8_t *p) { return (p[18] & 0xF0) == 0xE0 && (p[17] & 0x80) == 0x80; }
+    static bool isFrameStart(const uint8_t *p);
+
+  private:
+    size_t process(const uint8_t *data, size_t size, bool final, const Sink &sink, size_t maxFrames = static_cast<size_t>(-1));
+    void   skip(const uint8_t *p, size_t n, const Sink &sink);
+
+    std::vector<uint8_t> m_buffer;           // unframed tail of the stream
+    bool                 m_aligned      = true;
+    uint64_t             m_skippedBytes = 0;
+    uint64_t             m_resyncCount  = 0;
+};
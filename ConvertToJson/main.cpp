@@ -1,14 +1,65 @@
 #include "DmsLogReader.h"
 #include "PhoenixDecoder.h"
 #include "JsonWriter.h"
+#include "ColumnarWriter.h"
+#include "BatchRunner.h"
+#include "ConvertManifest.h"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace fs = std::filesystem;
 
+// Captures at least this large are parsed with DmsLogReader::readRecordsParallel(). This trades the
+// constant memory of the streamed path for speed: every record of the capture is held until the
+// decode ends, so memory grows with the capture (see conversionMemoryCost()), where smaller captures
+// are decoded record by record.
+static const uint64_t kParallelParseThreshold = 64ULL << 20;
+
+// Batch mode: memory of a streamed conversion (output buffers), and the default budget for -j
+static const uint64_t kStreamingMemoryCost   = 16ULL << 20;
+static const uint64_t kDefaultMemoryBudgetMB = 4096;
+
+// Estimated peak memory of converting a capture: pre-parsed captures hold every record
+// (about the size of the file, twice while the parse chunks are merged)
+static uint64_t conversionMemoryCost(uint64_t fileSize)
+{
+    return kStreamingMemoryCost + (fileSize >= kParallelParseThreshold ? 2 * fileSize : 0);
+}
+
+// Output settings of a conversion
+struct ConvertOptions
+{
+    JsonOptions json;
+    bool        columnar = false; // --format=phxcol
+};
+
+// Output path for an input capture: the .dmslog* extension is replaced by .json or .phxcol
+static std::string outputPathFor(const std::string &inputPath, const ConvertOptions &options)
+{
+    const char *ext    = options.columnar ? ".phxcol" : ".json";
+    size_t      dotPos = inputPath.rfind(".dmslog");
+    if (dotPos != std::string::npos)
+        return inputPath.substr(0, dotPos) + ext;
+    return inputPath + ext;
+}
+
+// Output settings as recorded in the manifest; a change of settings makes existing outputs stale
+static std::string outputSettings(const ConvertOptions &options)
+{
+    return options.columnar ? "phxcol" : "json " + options.json.settingsKey();
+}
+
+// How often --follow checks the capture for appended bytes.
+static const std::chrono::milliseconds kFollowPollInterval(200);
+
 static void printUsage(const char *progName)
 {
     std::cerr << "PTIConvert - Phoenix Visualeyez DMS Log to JSON Converter\n\n"
@@ -16,103 +67,270 @@ static void printUsage(const char *progName)
               << "from a Phoenix Visualeyez VZK10 RS-422 serial port and converts\n"
               << "the protocol data into human-readable JSON.\n\n"
               << "Usage:\n"
-              << "  " << progName << " <input.dmslog8> [output.json]\n"
-              << "  " << progName << " <directory>   (converts all .dmslog8 files)\n\n"
+              << "  " << progName << " <input.dmslog8> [output.json|output.phxcol]\n"
+              << "  " << progName << " <directory>   (converts all .dmslog8 files)\n"
+              << "  " << progName << " --follow <input.dmslog8>   (decode a capture that is still being written)\n\n"
+              << "Options:\n"
+              << "  --format=json|phxcol   phxcol: columnar binary file (one column per data-set field,\n"
+              << "      commands and messages in an event table), readable by memory mapping\n"
+              << "  --profile=full|compact|datasets-only|commands-only\n"
+              << "      full (default): pretty-printed, with names and descriptions\n"
+              << "      compact: one frame per line, no derived strings or duplicate raw bytes\n"
+              << "      datasets-only / commands-only: compact, one frame type only\n"
+              << "  --fields=<name,...>   frame fields to write (implies compact; only data-set or only command\n"
+              << "      fields also imply datasets-only / commands-only), e.g. timestamp,x,y,z,ledId,tcmId\n"
+              << "      " << JsonOptions::fieldNames() << "\n"
+              << "  -j <N>   convert up to N files at once (directory input; -j 0 = one per core)\n"
+              << "  --max-memory=<MB>   memory budget of the files being converted at once with -j (default "
+              << kDefaultMemoryBudgetMB << ")\n"
+              << "  --force   convert every file of a directory, also those whose output is up to date\n\n"
               << "If no output path is given, the output file is created alongside\n"
-              << "the input with a .json extension.\n";
+              << "the input with a .json (or .phxcol) extension.\n"
+              << "With --follow, frames are printed one per line as they are captured\n"
+              << "until the program is stopped with Ctrl+C.\n";
 }
 
-static bool convertFile(const std::string &inputPath, const std::string &outputPath)
+static bool convertFile(const std::string &inputPath, const std::string &outputPath, const ConvertOptions &options, std::ostream &log)
 {
-    std::cout << "Converting: " << inputPath << "\n";
+    log << "Converting: " << inputPath << "\n";
 
     // 1. Read the dmslog8 file
     DmsLogReader reader;
     if (!reader.open(inputPath))
+    {
+        log << "  Error: " << reader.error() << "\n";
         return false;
+    }
 
     const auto &hdr = reader.header();
-    std::cout << "  Device: " << hdr.deviceName << "\n";
+    log << "  Device: " << hdr.deviceName << "\n";
     if (!hdr.portConfig.empty())
     {
-        std::cout << "  Port:   " << hdr.portConfig << "\n";
+        log << "  Port:   " << hdr.portConfig << "\n";
     }
 
-    // 2. Extract serial data records
+    // 2. Extract serial data records. Large captures are parsed up front on all cores and held in
+    //    memory for the decode (see kParallelParseThreshold); smaller ones are streamed record by record.
     std::vector<IrpRecord> records;
-    if (!reader.readRecords(records))
+    const bool             preParsed = reader.fileSize() >= kParallelParseThreshold;
+    // Pre-parsed records are split by direction (views into the mapping) for the merging decode
+    TimedRecords txRecords, rxRecords;
+    if (preParsed)
     {
-        std::cerr << "  Error: no serial data records found\n";
+        reader.readRecordsParallel(records);
+        for (const auto &rec : records)
+            (rec.isTx() ? txRecords : rxRecords).emplace_back(rec.timestamp, rec.serialData);
+        std::vector<IrpRecord>().swap(records);
+    }
+
+    size_t txCount = txRecords.size(), rxCount = rxRecords.size();
+    if (!preParsed)
+    {
+        reader.forEachRecord(
+            [&](const IrpRecord &rec)
+            {
+                ++(rec.isTx() ? txCount : rxCount);
+                return true;
+            });
+    }
+    if (txCount + rxCount == 0)
+    {
+        log << "  Error: " << (reader.error().empty() ? "no serial data records found" : reader.error()) << "\n";
         return false;
     }
 
-    // Separate into TX and RX
-    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> txRecords, rxRecords;
-    for (const auto &rec : records)
+    log << "  TX packets: " << txCount << "\n";
+    log << "  RX packets: " << rxCount << "\n";
+
+    // 3. Decode Phoenix protocol and 4. write JSON (or columnar) output, one record at a time
+    PhoenixDecoder decoder;
+    JsonWriter     writer(options.json);
+    ColumnarWriter columnarWriter;
+    auto           source = [&](const FrameSink &sink)
     {
-        auto entry = std::make_pair(rec.timestamp, rec.serialData);
-        if (rec.functionCode == 4 && !rec.isCompletion)
-        {
-            txRecords.push_back(std::move(entry));
-        }
+        if (preParsed)
+            decoder.decode(txRecords, rxRecords, sink);
         else
-        {
-            rxRecords.push_back(std::move(entry));
-        }
+            decoder.decode(reader, sink);
+    };
+    bool written = options.columnar ? columnarWriter.write(outputPath, hdr, inputPath, source) : writer.write(outputPath, hdr, inputPath, source);
+    if (!written)
+    {
+        log << "  Error: " << (options.columnar ? columnarWriter.error() : writer.error()) << "\n";
+        return false;
     }
 
-    std::cout << "  TX packets: " << txRecords.size() << "\n";
-    std::cout << "  RX packets: " << rxRecords.size() << "\n";
+    const auto &counts = options.columnar ? columnarWriter.counts() : writer.counts();
+    log << "  Decoded frames: " << counts.total << " (commands=" << counts.commands << ", dataSets=" << counts.dataSets << ", messages=" << counts.messages
+        << ", init=" << counts.initMessages << ")\n";
 
-    // 3. Decode Phoenix protocol
-    PhoenixDecoder            decoder;
-    std::vector<PhoenixFrame> frames;
-    decoder.decode(txRecords, rxRecords, frames);
+    log << "  Output: " << outputPath << "\n";
+    return true;
+}
 
-    // Count frame types
-    int commands = 0, dataSets = 0, messages = 0, initMsgs = 0;
-    for (const auto &f : frames)
+// One console line per frame for --follow.
+static std::string frameLine(const PhoenixFrame &f, size_t index)
+{
+    std::ostringstream line;
+    line << "[" << index << "] " << JsonWriter::filetimeToIso8601(f.irpTimestamp) << " " << (f.isTx ? "TX" : "RX") << " ";
+
+    switch (f.type)
     {
-        switch (f.type)
+        case PhoenixFrameType::Command:
+            line << "command " << f.command.commandCode << f.command.commandIndex << " " << PhoenixDecoder::commandName(f.command.commandCode) << ": "
+                 << f.command.description();
+            break;
+        case PhoenixFrameType::DataSet:
         {
-            case PhoenixFrameType::Command:
-                ++commands;
-                break;
-            case PhoenixFrameType::DataSet:
-                ++dataSets;
-                break;
-            case PhoenixFrameType::Message:
-                ++messages;
-                break;
-            case PhoenixFrameType::InitMessage:
-                ++initMsgs;
-                break;
-            default:
-                break;
+            const auto &ds = f.dataSet;
+            line << std::fixed << std::setprecision(2) << "dataSet tcm=" << int(ds.tcmId) << " led=" << int(ds.ledId) << " x=" << ds.x_mm() << " y=" << ds.y_mm()
+                 << " z=" << ds.z_mm() << (ds.endOfFrame ? " endOfFrame" : "");
+            break;
         }
+        case PhoenixFrameType::Message:
+            line << "message " << f.message.commandCode << f.message.commandIndex << " " << (f.message.isAck() ? "ACK" : "ERR") << " id=" << int(f.message.messageId)
+                 << " param=" << int(f.message.messageParam);
+            break;
+        case PhoenixFrameType::InitMessage:
+            line << "initMessage serial=" << f.initMessage.serialNumberHex() << " status=" << int(f.initMessage.statusByte);
+            break;
+        case PhoenixFrameType::Unknown:
+            line << "unknown (" << f.rawBytes.size() << " bytes)";
+            break;
     }
+    return line.str();
+}
 
-    std::cout << "  Decoded frames: " << frames.size() << " (commands=" << commands << ", dataSets=" << dataSets << ", messages=" << messages
-              << ", init=" << initMsgs << ")\n";
+// Decode a capture while Device Monitoring Studio is still writing it. Only records
+// appended since the last poll are parsed; runs until interrupted.
+static int followFile(const std::string &inputPath)
+{
+    std::cout << "Following: " << inputPath << " (Ctrl+C to stop)\n";
 
-    // 4. Write JSON output
-    JsonWriter writer;
-    if (!writer.write(outputPath, hdr, inputPath, frames))
-        return false;
+    DmsLogReader reader;
+    if (!reader.open(inputPath))
+    {
+        std::cerr << "Error: " << reader.error() << "\n";
+        return 1;
+    }
 
-    std::cout << "  Output: " << outputPath << "\n";
-    return true;
+    const auto &hdr = reader.header();
+    std::cout << "  Device: " << hdr.deviceName << "\n";
+    if (!hdr.portConfig.empty())
+        std::cout << "  Port:   " << hdr.portConfig << "\n";
+
+    PhoenixDecoder decoder;
+    RecordCursor   cursor = reader.followCursor();
+    IrpRecord      rec;
+    size_t         index  = 0;
+    for (;;)
+    {
+        while (cursor.next(rec))
+            decoder.decodeRecord(rec, [&](const PhoenixFrame &f) { std::cout << frameLine(f, index++) << "\n"; });
+        std::cout.flush();
+
+        if (cursor.finished())
+        {
+            std::cerr << "Error: " << (reader.error().empty() ? "no further records can be recovered" : reader.error()) << " in " << inputPath << "\n";
+            return 1;
+        }
+        if (!reader.refresh())
+            std::this_thread::sleep_for(kFollowPollInterval);
+    }
 }
 
 int main(int argc, char *argv[])
 {
-    if (argc < 2)
+    // Output options first; what remains are the positional arguments
+    ConvertOptions           options;
+    bool                     fieldsGiven = false;
+    bool                     force       = false;
+    unsigned                 jobCount    = 1;
+    uint64_t                 maxMemoryMB = kDefaultMemoryBudgetMB;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--profile=", 0) == 0)
+        {
+            if (!JsonOptions::parseProfile(arg.substr(10), options.json.profile))
+                return 1;
+        }
+        else if (arg.rfind("--format=", 0) == 0)
+        {
+            std::string format = arg.substr(9);
+            if (format != "json" && format != "phxcol")
+            {
+                std::cerr << "Error: unknown format '" << format << "' (json, phxcol)\n";
+                return 1;
+            }
+            options.columnar = format == "phxcol";
+        }
+        else if (arg.rfind("--fields=", 0) == 0)
+        {
+            if (!JsonOptions::parseFields(arg.substr(9), options.json.fields))
+                return 1;
+            fieldsGiven = true;
+        }
+        else if (arg == "--force")
+        {
+            force = true;
+        }
+        else if (arg.rfind("-j", 0) == 0)
+        {
+            // "-j N" or "-jN"
+            std::string value = arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++i] : "");
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+            {
+                std::cerr << "Error: -j expects a number of files\n";
+                return 1;
+            }
+            jobCount = static_cast<unsigned>(std::stoul(value));
+        }
+        else if (arg.rfind("--max-memory=", 0) == 0)
+        {
+            std::string value = arg.substr(13);
+            if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+            {
+                std::cerr << "Error: --max-memory expects a size in MB\n";
+                return 1;
+            }
+            maxMemoryMB = std::stoull(value);
+        }
+        else
+        {
+            args.push_back(arg);
+        }
+    }
+    if (fieldsGiven && options.json.profile == JsonProfile::Full)
+    {
+        // Selecting only data-set (or only command) content narrows the output to that frame type
+        uint32_t content = options.json.fields & (JsonField::DataSet | JsonField::Command | JsonField::Message | JsonField::InitMessage);
+        if (content != 0 && (content & ~uint32_t(JsonField::DataSet)) == 0)
+            options.json.profile = JsonProfile::DataSetsOnly;
+        else if (content == JsonField::Command)
+            options.json.profile = JsonProfile::CommandsOnly;
+        else
+            options.json.profile = JsonProfile::Compact;
+    }
+
+    if (args.empty())
     {
         printUsage(argv[0]);
         return 1;
     }
 
-    std::string inputArg = argv[1];
+    if (args[0] == "--follow")
+    {
+        if (args.size() < 2)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return followFile(args[1]);
+    }
+
+    std::string inputArg = args[0];
     fs::path    inputPath(inputArg);
 
     if (!fs::exists(inputPath))
@@ -121,7 +339,7 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    std::vector<std::pair<std::string, std::string>> filesToConvert;
+    std::vector<BatchJob> filesToConvert;
 
     if (fs::is_directory(inputPath))
     {
@@ -134,18 +352,7 @@ int main(int argc, char *argv[])
                 // Match .dmslog8 or similar extensions
                 if (ext.find(".dmslog") == 0)
                 {
-                    std::string outPath = entry.path().string();
-                    // Replace extension with .json
-                    size_t      dotPos  = outPath.rfind(".dmslog");
-                    if (dotPos != std::string::npos)
-                    {
-                        outPath = outPath.substr(0, dotPos) + ".json";
-                    }
-                    else
-                    {
-                        outPath += ".json";
-                    }
-                    filesToConvert.emplace_back(entry.path().string(), outPath);
+                    filesToConvert.push_back({entry.path().string(), outputPathFor(entry.path().string(), options), conversionMemoryCost(entry.file_size())});
                 }
             }
         }
@@ -159,35 +366,67 @@ int main(int argc, char *argv[])
     {
         // Single file
         std::string outPath;
-        if (argc >= 3)
+        if (args.size() >= 2)
         {
-            outPath = argv[2];
+            outPath = args[1];
         }
         else
         {
-            outPath       = inputPath.string();
-            size_t dotPos = outPath.rfind(".dmslog");
-            if (dotPos != std::string::npos)
-            {
-                outPath = outPath.substr(0, dotPos) + ".json";
-            }
-            else
-            {
-                outPath += ".json";
-            }
+            outPath = outputPathFor(inputPath.string(), options);
+        }
+        filesToConvert.push_back({inputPath.string(), outPath, 0});
+    }
+
+    // Directory conversions skip the files whose outputs are still current (see ConvertManifest)
+    ConvertManifest                manifest;
+    std::vector<SourceFingerprint> fingerprints;
+    const bool                     useManifest = fs::is_directory(inputPath);
+    const std::string              settings    = outputSettings(options);
+    if (useManifest)
+    {
+        manifest.load(inputPath.string());
+        std::vector<BatchJob> pending;
+        for (const auto &job : filesToConvert)
+        {
+            SourceFingerprint fingerprint = ConvertManifest::fingerprint(job.inputPath);
+            if (!force && manifest.isCurrent(job, settings, fingerprint))
+                continue;
+            pending.push_back(job);
+            fingerprints.push_back(fingerprint);
         }
-        filesToConvert.emplace_back(inputPath.string(), outPath);
+        if (pending.size() < filesToConvert.size())
+            std::cout << "Skipping " << filesToConvert.size() - pending.size() << " up-to-date file(s) (--force converts them again).\n";
+        filesToConvert.swap(pending);
     }
 
-    int successCount = 0;
-    for (const auto &[inFile, outFile] : filesToConvert)
+    // Each file's console output is collected and printed in one piece, so parallel conversions don't interleave
+    BatchRunner runner(jobCount, maxMemoryMB << 20);
+    auto        convert = [&](const BatchJob &job, std::ostream &log)
+    {
+        if (!convertFile(job.inputPath, job.outputPath, options, log))
+            return false;
+        // Hashed for the manifest here, on the worker, while the capture is still cached; run()
+        // hands out the jobs by reference, so the position in filesToConvert is the job's index
+        if (useManifest)
+        {
+            SourceFingerprint &fingerprint = fingerprints[static_cast<size_t>(&job - filesToConvert.data())];
+            ConvertManifest::contentHash(job.inputPath, fingerprint.size, fingerprint.hash);
+        }
+        return true;
+    };
+    auto results = runner.run(filesToConvert, convert, std::cout, std::cerr);
+    runner.printReport(filesToConvert, results, std::cout);
+
+    if (useManifest)
     {
-        if (convertFile(inFile, outFile))
+        for (size_t i = 0; i < results.size(); ++i)
         {
-            ++successCount;
+            if (results[i].success)
+                manifest.record(filesToConvert[i], settings, fingerprints[i]);
         }
+        manifest.save(); // failing to save (e.g. read-only folder) only means converting again next time
     }
 
-    std::cout << "\nConverted " << successCount << "/" << filesToConvert.size() << " file(s).\n";
-    return (successCount == static_cast<int>(filesToConvert.size())) ? 0 : 1;
+    bool allConverted = std::all_of(results.begin(), results.end(), [](const BatchResult &r) { return r.success; });
+    return allConverted ? 0 : 1;
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ByteView.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Fixed-capacity receive ring for a byte stream that is parsed in place.
+// The capacity is rounded up to a power of two and allocated once, together with `window`
+// bytes past the end that mirror the start of the ring: any run of up to `window` readable
+// bytes is then contiguous in memory, so a parser that never needs more look-ahead than
+// `window` can read across the wrap without copying. Data is written into writeSpan() and
+// committed, and read through readSpan() and consume().
+class ByteRing
+{
+  public:
+    ByteRing(size_t capacity, size_t window)
+    {
+        size_t size = 1;
+        while (size < std::max(capacity, window))
+            size <<= 1;
+        m_capacity = size;
+        m_window   = window;
+        m_bytes.resize(size + window);
+    }
+
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return m_write - m_read; }
+    size_t space() const { return m_capacity - size(); }
+    bool   empty() const { return m_write == m_read; }
+
+    // Free bytes at the write position, up to the end of the ring (see commit())
+    uint8_t *writeSpan(size_t &size)
+    {
+        const size_t pos = m_write & (m_capacity - 1);
+        size             = std::min(space(), m_capacity - pos);
+        return m_bytes.data() + pos;
+    }
+
+    // Make `n` bytes written at writeSpan() readable, mirroring any that land in the window
+    void commit(size_t n)
+    {
+        const size_t pos = m_write & (m_capacity - 1);
+        if (pos < m_window)
+            std::memcpy(m_bytes.data() + m_capacity + pos, m_bytes.data() + pos, std::min(n, m_window - pos));
+        m_write += n;
+    }
+
+    // Readable bytes from the read position; shorter than size() only when the data wraps
+    // further than the mirror reaches. Read on from the wrap after consuming.
+    ByteView readSpan() const
+    {
+        const size_t pos = m_read & (m_capacity - 1);
+        return ByteView(m_bytes.data() + pos, std::min(size(), m_capacity + m_window - pos));
+    }
+
+    void consume(size_t n) { m_read += n; }
+    void clear() { m_read = m_write = 0; }
+
+  private:
+    std::vector<uint8_t> m_bytes;        // ring followed by the mirror of its first `m_window` bytes
+    size_t               m_capacity = 0; // power of two
+    size_t               m_window   = 0;
+    size_t               m_read     = 0; // free-running positions; masked on access
+    size_t               m_write    = 0;
+};
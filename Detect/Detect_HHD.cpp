@@ -1,8 +1,12 @@
 #include "Detect_HHD.h"
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 // --------------------------------------------------------------------------
 // Internal helpers and constants
@@ -12,9 +16,9 @@ namespace
     // Configuration for each baud-rate detection pass
     struct BaudRatePass
     {
-        DWORD baudRate;
-        WORD  xonLimit1; // XonLimit for first handshake configuration
-        WORD  xonLimit2; // XonLimit for repeated handshake configuration
+        uint32_t baudRate;
+        uint16_t xonLimit1; // XonLimit for first handshake configuration
+        uint16_t xonLimit2; // XonLimit for repeated handshake configuration
     };
 
     // Baud rates and XonLimit values from the IRP capture.
@@ -45,151 +49,86 @@ namespace
     const unsigned char INIT_STATUS_BYTE         = 0x01; // byte 15: "Initialized"
     const unsigned char INIT_TRAILER[]           = {0x10, 0x11, 0x12, 0x13};
     const int           INIT_MSG_READ_TIMEOUT_MS = 2500; // time to wait for init message after reset
-    // Open the COM port with GENERIC_READ | GENERIC_WRITE, exclusive access
-    HANDLE              OpenPort(const std::string &portPath)
+
+    void SleepMs(int ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    // Open the port exclusively (read/write)
+    bool OpenPort(SerialTransport &port, const std::string &portName)
     {
-        HANDLE h = CreateFileA(portPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-        if (h == INVALID_HANDLE_VALUE)
+        if (!port.open(portName))
         {
-            std::cerr << "  [HHD] CreateFile failed for " << portPath << " (error " << GetLastError() << ")" << std::endl;
+            std::cerr << "  [HHD] Opening " << portName << " failed (error " << port.lastError() << ")" << std::endl;
+            return false;
         }
-        return h;
+        return true;
     }
 
     // Phase 3, Step 2: Toggle DTR line — device reset/wake-up pattern.
     // Sequence: CLR_DTR -> SET_DTR -> CLR_DTR -> SET_DTR with ~10ms spacing,
     // followed by a ~190ms settle delay before the next phase.
-    void ToggleDTR(HANDLE hPort)
+    void ToggleDTR(SerialTransport &port)
     {
-        EscapeCommFunction(hPort, CLRDTR);
-        Sleep(DTR_TOGGLE_DELAY_MS);
-        EscapeCommFunction(hPort, SETDTR);
-        Sleep(DTR_TOGGLE_DELAY_MS);
-        EscapeCommFunction(hPort, CLRDTR);
-        Sleep(DTR_TOGGLE_DELAY_MS);
-        EscapeCommFunction(hPort, SETDTR);
-        Sleep(DTR_SETTLE_DELAY_MS);
+        port.setDtr(false);
+        SleepMs(DTR_TOGGLE_DELAY_MS);
+        port.setDtr(true);
+        SleepMs(DTR_TOGGLE_DELAY_MS);
+        port.setDtr(false);
+        SleepMs(DTR_TOGGLE_DELAY_MS);
+        port.setDtr(true);
+        SleepMs(DTR_SETTLE_DELAY_MS);
     }
 
-    // Phase 4, Steps 3/5: Configure handshake/flow control.
-    //   ControlHandShake = 0x2D:
-    //     Bit 0 (0x01): SERIAL_DTR_CONTROL
-    //     Bit 2 (0x04): SERIAL_DTR_HANDSHAKE
-    //     Bit 3 (0x08): SERIAL_CTS_HANDSHAKE
-    //     Bit 5 (0x20): SERIAL_DSR_HANDSHAKE
-    //   FlowReplace = 0x01: SERIAL_XOFF_CONTINUE
-    bool ConfigureHandshake(HANDLE hPort, WORD xonLimit)
+    // Phase 4, Steps 3/5: Configure handshake/flow control
+    // (ControlHandShake 0x2D, FlowReplace 0x01; see SerialTransport::setHandshake)
+    bool ConfigureHandshake(SerialTransport &port, uint16_t xonLimit)
     {
-        DCB dcb       = {};
-        dcb.DCBlength = sizeof(dcb);
-        if (!GetCommState(hPort, &dcb))
-        {
-            std::cerr << "  [HHD] GetCommState failed (error " << GetLastError() << ")" << std::endl;
-            return false;
-        }
-
-        // ControlHandShake = 0x2D
-        dcb.fDtrControl       = DTR_CONTROL_ENABLE; // SERIAL_DTR_CONTROL
-        dcb.fOutxCtsFlow      = TRUE;               // SERIAL_CTS_HANDSHAKE
-        dcb.fOutxDsrFlow      = TRUE;               // SERIAL_DSR_HANDSHAKE
-        dcb.fDsrSensitivity   = TRUE;               // SERIAL_DCD_HANDSHAKE
-
-        // FlowReplace = 0x01
-        dcb.fTXContinueOnXoff = TRUE; // SERIAL_XOFF_CONTINUE
-
-        dcb.XonLim            = xonLimit;
-        dcb.XoffLim           = 0;
-
-        if (!SetCommState(hPort, &dcb))
+        if (!port.setHandshake(xonLimit))
         {
-            std::cerr << "  [HHD] SetCommState (handshake, XonLim=" << xonLimit << ") failed (error " << GetLastError() << ")" << std::endl;
+            std::cerr << "  [HHD] Setting handshake (XonLim=" << xonLimit << ") failed (error " << port.lastError() << ")" << std::endl;
             return false;
         }
         return true;
     }
 
-    // Phase 4, Step 4: Query port status (modem status, comm errors, properties).
-    // These are informational queries matching the IRP capture.
-    void QueryPortStatus(HANDLE hPort)
-    {
-        DWORD modemStatus = 0;
-        GetCommModemStatus(hPort, &modemStatus);
-
-        DWORD   errors  = 0;
-        COMSTAT comstat = {};
-        ClearCommError(hPort, &errors, &comstat);
-
-        COMMPROP commProp      = {};
-        commProp.wPacketLength = sizeof(COMMPROP);
-        GetCommProperties(hPort, &commProp);
-    }
-
     // Phase 4, Step 6: Set baud rate (separate SetCommState call)
-    bool SetBaudRate(HANDLE hPort, DWORD baudRate)
+    bool SetBaudRate(SerialTransport &port, uint32_t baudRate)
     {
-        DCB dcb       = {};
-        dcb.DCBlength = sizeof(dcb);
-        if (!GetCommState(hPort, &dcb))
-            return false;
-
-        dcb.BaudRate = baudRate;
-
-        if (!SetCommState(hPort, &dcb))
+        if (!port.setBaudRate(baudRate))
         {
-            std::cerr << "  [HHD] SetCommState (baud=" << baudRate << ") failed (error " << GetLastError() << ")" << std::endl;
+            std::cerr << "  [HHD] Setting baud=" << baudRate << " failed (error " << port.lastError() << ")" << std::endl;
             return false;
         }
         return true;
     }
 
     // Phase 4, Step 8: Set line control (8 data bits, 1 stop bit, no parity)
-    bool SetLineControl8N1(HANDLE hPort)
+    bool SetLineControl8N1(SerialTransport &port)
     {
-        DCB dcb       = {};
-        dcb.DCBlength = sizeof(dcb);
-        if (!GetCommState(hPort, &dcb))
-            return false;
-
-        dcb.ByteSize = 8;
-        dcb.StopBits = ONESTOPBIT;
-        dcb.Parity   = NOPARITY;
-
-        if (!SetCommState(hPort, &dcb))
+        if (!port.setLineControl8N1())
         {
-            std::cerr << "  [HHD] SetCommState (8N1) failed (error " << GetLastError() << ")" << std::endl;
+            std::cerr << "  [HHD] Setting 8N1 failed (error " << port.lastError() << ")" << std::endl;
             return false;
         }
         return true;
     }
 
-    // Phase 4, Step 9: Query DTR/RTS state via driver IOCTL (read-only)
-    void QueryDtrRts(HANDLE hPort)
-    {
-        DWORD dtrRts        = 0;
-        DWORD bytesReturned = 0;
-        DeviceIoControl(hPort, IOCTL_SERIAL_GET_DTRRTS, NULL, 0, &dtrRts, sizeof(dtrRts), &bytesReturned, NULL);
-    }
-
     // Phase 6: Read the 19-byte Initial Message sent by the tracker after reset.
     // The DTR toggle triggers a hardware reset; the tracker responds with the
     // Initial Message containing the 8-byte serial number (PTI manual, Section 4.5).
     // Returns true if the message was received and parsed successfully.
-    bool ReadInitialMessage(HANDLE hPort, std::string &serialNumber)
+    bool ReadInitialMessage(SerialTransport &port, std::string &serialNumber)
     {
         // Set read timeouts — the tracker needs time to boot after reset
-        COMMTIMEOUTS timeouts                = {};
-        timeouts.ReadIntervalTimeout         = 50;
-        timeouts.ReadTotalTimeoutConstant    = INIT_MSG_READ_TIMEOUT_MS;
-        timeouts.ReadTotalTimeoutMultiplier  = 10;
-        timeouts.WriteTotalTimeoutConstant   = 50;
-        timeouts.WriteTotalTimeoutMultiplier = 10;
-        SetCommTimeouts(hPort, &timeouts);
+        port.setTimeouts({50, INIT_MSG_READ_TIMEOUT_MS, 10});
 
         // Read into a buffer large enough for the message plus any preceding noise
         unsigned char buffer[256] = {};
-        DWORD         bytesRead   = 0;
+        size_t        bytesRead   = 0;
 
-        if (!ReadFile(hPort, buffer, sizeof(buffer), &bytesRead, NULL) || bytesRead < INIT_MSG_SIZE)
+        if (!port.read(buffer, sizeof(buffer), bytesRead) || bytesRead < INIT_MSG_SIZE)
         {
             if (bytesRead > 0)
                 std::cout << "  [HHD] Read " << bytesRead << " bytes but need at least " << INIT_MSG_SIZE << " for Initial Message" << std::endl;
@@ -197,7 +136,7 @@ namespace
         }
 
         // Scan for the 01 02 03 04 header in the received data
-        for (DWORD i = 0; i + INIT_MSG_SIZE <= bytesRead; i++)
+        for (size_t i = 0; i + INIT_MSG_SIZE <= bytesRead; i++)
         {
             // Check header
             if (memcmp(&buffer[i], INIT_HEADER, INIT_HEADER_SIZE) != 0)
@@ -230,18 +169,17 @@ namespace
 
     // Phase 5: Poll CONFIG_SIZE in a loop, checking for device response.
     // Returns true if configSize becomes non-zero (device detected).
-    bool PollConfigSize(HANDLE hPort, DWORD &configSize)
+    bool PollConfigSize(SerialTransport &port, uint32_t &configSize)
     {
-        DWORD bytesReturned = 0;
-        configSize          = 0;
+        configSize = 0;
 
         for (int i = 0; i < CONFIG_SIZE_MAX_RETRIES; i++)
         {
-            BOOL ok = DeviceIoControl(hPort, IOCTL_SERIAL_CONFIG_SIZE, NULL, 0, &configSize, sizeof(configSize), &bytesReturned, NULL);
+            bool ok = port.configSize(configSize);
 
             if (!ok && i == 0)
             {
-                std::cerr << "  [HHD] CONFIG_SIZE IOCTL not supported (error " << GetLastError() << ")" << std::endl;
+                std::cerr << "  [HHD] CONFIG_SIZE IOCTL not supported (error " << port.lastError() << ")" << std::endl;
                 return false;
             }
 
@@ -251,7 +189,7 @@ namespace
                 return true;
             }
 
-            Sleep(CONFIG_SIZE_POLL_INTERVAL_MS);
+            SleepMs(CONFIG_SIZE_POLL_INTERVAL_MS);
         }
 
         return false;
@@ -260,56 +198,54 @@ namespace
     // Run a single detection pass: configure port, poll for device response,
     // then read the Initial Message for definitive serial number confirmation.
     // Phases 3-6 from the IRP capture + PTI manual Section 4.5.
-    bool RunDetectionPass(HANDLE hPort, const BaudRatePass &pass, DWORD &configSize, std::string &serialNumber)
+    bool RunDetectionPass(SerialTransport &port, const BaudRatePass &pass, uint32_t &configSize, std::string &serialNumber)
     {
         // Phase 3, Step 1: Read current handshake settings
-        DCB dcb       = {};
-        dcb.DCBlength = sizeof(dcb);
-        GetCommState(hPort, &dcb);
+        port.queryHandshake();
 
         // Phase 3, Step 2: DTR toggle (device reset/wake-up)
-        ToggleDTR(hPort);
+        ToggleDTR(port);
 
         // Purge any stale data from buffers before configuring
-        PurgeComm(hPort, PURGE_RXCLEAR | PURGE_TXCLEAR);
+        port.purge(true, true);
 
         // Phase 4, Step 3: Configure handshake with first XonLimit
-        if (!ConfigureHandshake(hPort, pass.xonLimit1))
+        if (!ConfigureHandshake(port, pass.xonLimit1))
             return false;
 
-        // Phase 4, Step 4: Query port status
-        QueryPortStatus(hPort);
+        // Phase 4, Step 4: Query port status (modem status, comm errors, properties)
+        port.queryPortStatus();
 
         // Phase 4, Step 5: Repeat handshake config with adjusted XonLimit
-        if (!ConfigureHandshake(hPort, pass.xonLimit2))
+        if (!ConfigureHandshake(port, pass.xonLimit2))
             return false;
 
         // Query status again
-        QueryPortStatus(hPort);
+        port.queryPortStatus();
 
         // Phase 4, Step 6: Set baud rate
-        if (!SetBaudRate(hPort, pass.baudRate))
+        if (!SetBaudRate(port, pass.baudRate))
             return false;
 
         // Phase 4, Step 7: Assert control lines
-        EscapeCommFunction(hPort, SETRTS);
-        EscapeCommFunction(hPort, SETDTR);
+        port.setRts(true);
+        port.setDtr(true);
 
         // Phase 4, Step 8: Set line control (8N1)
-        if (!SetLineControl8N1(hPort))
+        if (!SetLineControl8N1(port))
             return false;
 
         // Phase 4, Step 9: Verify DTR/RTS state (read-only)
-        QueryDtrRts(hPort);
+        port.queryDtrRts();
 
         // Phase 5: Poll CONFIG_SIZE for device response
-        bool configSizeOk = PollConfigSize(hPort, configSize);
+        bool configSizeOk = PollConfigSize(port, configSize);
 
         // Phase 6: Read Initial Message — definitive tracker detection.
         // The DTR toggle triggered a hardware reset; if a tracker is present
         // it will have sent the 19-byte Initial Message containing its serial
         // number (PTI manual Section 4.5, page 20).
-        bool initMsgOk    = ReadInitialMessage(hPort, serialNumber);
+        bool initMsgOk    = ReadInitialMessage(port, serialNumber);
 
         // Detection succeeds if we got the Initial Message (definitive) or
         // CONFIG_SIZE responded (driver-level confirmation).
@@ -323,36 +259,38 @@ namespace
 // --------------------------------------------------------------------------
 
 HHD_DetectionResult Detect_HHD(const std::string &portName)
+{
+    std::unique_ptr<SerialTransport> port = CreateSerialTransport();
+    return Detect_HHD(*port, portName);
+}
+
+HHD_DetectionResult Detect_HHD(SerialTransport &port, const std::string &portName)
 {
     HHD_DetectionResult result = {};
     result.deviceFound         = false;
     result.portName            = portName;
 
-    std::string portPath       = "\\\\.\\" + portName;
-
     std::cout << "[HHD] Starting detection on " << portName << std::endl;
 
     // Phase 1: Open port
-    HANDLE hPort = OpenPort(portPath);
-    if (hPort == INVALID_HANDLE_VALUE)
+    if (!OpenPort(port, portName))
         return result;
 
     // Phase 2: Close and re-open for clean state
-    CloseHandle(hPort);
-    hPort = OpenPort(portPath);
-    if (hPort == INVALID_HANDLE_VALUE)
+    port.close();
+    if (!OpenPort(port, portName))
         return result;
 
     // Try each baud rate pass
-    for (size_t passIdx = 0; passIdx < _countof(g_DetectionPasses); passIdx++)
+    for (size_t passIdx = 0; passIdx < std::size(g_DetectionPasses); passIdx++)
     {
         const BaudRatePass &pass       = g_DetectionPasses[passIdx];
-        DWORD               configSize = 0;
+        uint32_t            configSize = 0;
 
         std::cout << "  [HHD] Pass " << (passIdx + 1) << ": trying " << pass.baudRate << " baud" << std::endl;
 
         std::string serialNumber;
-        if (RunDetectionPass(hPort, pass, configSize, serialNumber))
+        if (RunDetectionPass(port, pass, configSize, serialNumber))
         {
             result.deviceFound      = true;
             result.detectedBaudRate = pass.baudRate;
@@ -363,8 +301,8 @@ HHD_DetectionResult Detect_HHD(const std::string &portName)
             if (configSize > 0)
             {
                 result.configData.resize(configSize);
-                DWORD bytesRead = 0;
-                ReadFile(hPort, result.configData.data(), configSize, &bytesRead, NULL);
+                size_t bytesRead = 0;
+                port.read(result.configData.data(), configSize, bytesRead);
                 result.configData.resize(bytesRead);
             }
 
@@ -373,24 +311,23 @@ HHD_DetectionResult Detect_HHD(const std::string &portName)
             if (!serialNumber.empty())
                 std::cout << "[HHD] Tracker Serial Number: " << serialNumber << std::endl;
 
-            CloseHandle(hPort);
+            port.close();
             return result;
         }
 
         std::cout << "  [HHD] No response at " << pass.baudRate << " baud" << std::endl;
 
         // Between passes: close and re-open for clean state (matches IRP capture)
-        if (passIdx + 1 < _countof(g_DetectionPasses))
+        if (passIdx + 1 < std::size(g_DetectionPasses))
         {
-            CloseHandle(hPort);
-            hPort = OpenPort(portPath);
-            if (hPort == INVALID_HANDLE_VALUE)
+            port.close();
+            if (!OpenPort(port, portName))
                 return result;
         }
     }
 
     std::cout << "[HHD] No device detected on " << portName << std::endl;
 
-    CloseHandle(hPort);
+    port.close();
     return result;
 }
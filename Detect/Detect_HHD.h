@@ -1,28 +1,19 @@
 #pragma once
 
-#include <windows.h>
+#include "SerialTransport.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
-// Serial IOCTL codes not exposed by the standard Win32 API.
-// These require DeviceIoControl() to invoke directly.
-#ifndef IOCTL_SERIAL_GET_DTRRTS
-#define IOCTL_SERIAL_GET_DTRRTS 0x001b0064
-#endif
-
-#ifndef IOCTL_SERIAL_CONFIG_SIZE
-#define IOCTL_SERIAL_CONFIG_SIZE 0x001b006c
-#endif
-
 // Result of the HHD detection sequence
 struct HHD_DetectionResult
 {
-    bool              deviceFound;
-    DWORD             detectedBaudRate;
-    DWORD             configSize;
-    std::vector<BYTE> configData;
-    std::string       portName;
-    std::string       serialNumber; // 8-byte tracker serial number from Initial Message (decimal)
+    bool                 deviceFound;
+    uint32_t             detectedBaudRate;
+    uint32_t             configSize;
+    std::vector<uint8_t> configData;
+    std::string          portName;
+    std::string          serialNumber; // 8-byte tracker serial number from Initial Message (decimal)
 };
 
 // Performs the HHD Software detection sequence on the specified COM port.
@@ -43,8 +34,12 @@ struct HHD_DetectionResult
 //   Phase 7:   If no response, repeat at next baud rate (2M -> 2.5M)
 //
 // Parameters:
-//   portName - COM port name, e.g. "COM9"
+//   portName - port name, e.g. "COM9" or "ttyUSB0"
 //
 // Returns:
 //   HHD_DetectionResult with deviceFound=true if a device responded.
 HHD_DetectionResult Detect_HHD(const std::string &portName);
+
+// Same sequence on a caller-supplied transport (closed again on return).
+// Backends without CONFIG_SIZE rely on the Initial Message alone.
+HHD_DetectionResult Detect_HHD(SerialTransport &port, const std::string &portName);
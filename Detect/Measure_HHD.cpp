@@ -1,10 +1,21 @@
 #include "Measure_HHD.h"
+#include "ByteRing.h"
+#include "DataSetBatch.h"
+#include "PhoenixCatalog.h"
+#include "PhoenixFramer.h"
+#include "SpscRing.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iomanip>
 #include <iostream>
 #include <cstring>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 // --------------------------------------------------------------------------
 // Internal helpers and constants
@@ -22,26 +33,65 @@ namespace
 
     // Timeouts for the command/response cycle
     const int CMD_ACK_TIMEOUT_MS              = 500;  // max wait for ACK after a command
-    const int CMD_ACK_POLL_MS                 = 1;    // poll interval while waiting for ACK
     const int CMD_ACK_MAX_RETRIES             = 10;   // max non-ACK records to skip before giving up
     const int STOP_GAP_MS                     = 1500; // gap between first and second stop command
     const int FETCH_READ_TIMEOUT_MS           = 5;    // short timeout for non-blocking fetch reads
-    const int RESET_POLL_MS                   = 10;   // poll interval while waiting for device after reset
     const int RESET_SILENCE_THRESHOLD_MS      = 300;  // require this much silence after reset before proceeding
     const int RESET_MIN_BOOT_MS               = 1700; // minimum boot time — VZSoft waits ~1.7s after software reset
+    const int ACQUISITION_WAIT_MS             = 20;   // longest port wait of the acquisition thread before it checks for stop
+    const size_t CMD_BURST_WINDOW             = 8;    // configuration commands sent ahead of their ACKs (~100 bytes in the tracker's input)
+
+    // Read timeouts while commands are acknowledged, and while streaming (non-blocking fetch)
+    const SerialTimeouts COMMAND_TIMEOUTS     = {50, CMD_ACK_TIMEOUT_MS, 10};
+    const SerialTimeouts STREAM_TIMEOUTS      = {1, FETCH_READ_TIMEOUT_MS, 0};
+
+    // Receive ring of a session: ~250 ms of the fastest stream, and the framer's look-ahead
+    // (three records to confirm an unrecognised one) readable across the wrap
+    const size_t RX_RING_SIZE                 = 65536;
+    const size_t RX_RING_WINDOW               = 3 * RECORD_SIZE;
+
+    void SleepMs(int ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    // Monotonic milliseconds for wall-clock bounded loops
+    int64_t NowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 
     // --------------------------------------------------------------------------
     // Build a PTI command buffer
     // --------------------------------------------------------------------------
     // Format: & <code> <index> <bytesPerParam> <numParams> CR [param data]
-    std::vector<uint8_t> BuildCommand(char code, char index, char bytesPerParam, char numParams, const uint8_t *paramData = nullptr, int paramLen = 0)
+    // The parameter layout comes from PhoenixCatalog; commands without parameters send '0' '0'.
+    std::vector<uint8_t> BuildCommand(char code, char index, const uint8_t *paramData = nullptr, int paramLen = 0)
     {
+        const PhoenixCommandInfo *info          = PhoenixCatalog::findCommand(code);
+        int                       bytesPerParam = 0;
+        int                       numParams     = 0;
+        if (paramData && paramLen > 0)
+        {
+            if (!info || info->bytesPerParam == 0 || paramLen % info->bytesPerParam != 0)
+            {
+                std::cerr << "  [Measure] No parameter layout for &" << code << " with " << paramLen << " bytes" << std::endl;
+                paramLen = 0;
+            }
+            else
+            {
+                bytesPerParam = info->bytesPerParam;
+                numParams     = paramLen / bytesPerParam;
+            }
+        }
+
         std::vector<uint8_t> cmd;
+        cmd.reserve(6 + (paramLen > 0 ? paramLen : 0));
         cmd.push_back(0x26); // '&'
         cmd.push_back(static_cast<uint8_t>(code));
         cmd.push_back(static_cast<uint8_t>(index));
-        cmd.push_back(static_cast<uint8_t>(bytesPerParam));
-        cmd.push_back(static_cast<uint8_t>(numParams));
+        cmd.push_back(static_cast<uint8_t>('0' + bytesPerParam));
+        cmd.push_back(static_cast<uint8_t>('0' + numParams));
         cmd.push_back(0x0D); // CR
         if (paramData && paramLen > 0)
         {
@@ -55,38 +105,24 @@ namespace
     // --------------------------------------------------------------------------
     // Returns true if ACK was received and the command code echo matches.
     // For commands that generate no ACK (e.g., &3 START), use sendOnly=true.
-    bool SendCommand(HANDLE hPort, const std::vector<uint8_t> &cmd, bool sendOnly = false)
+    bool SendCommand(SerialTransport &port, const std::vector<uint8_t> &cmd, bool sendOnly = false)
     {
         // Purge RX buffer before sending (matches IRP capture pattern)
-        PurgeComm(hPort, PURGE_RXCLEAR);
+        port.purge(true, false);
 
-        DWORD bytesWritten = 0;
-        if (!WriteFile(hPort, cmd.data(), static_cast<DWORD>(cmd.size()), &bytesWritten, NULL) || bytesWritten != cmd.size())
+        if (!port.write(cmd.data(), cmd.size()))
         {
-            std::cerr << "  [Measure] WriteFile failed (error " << GetLastError() << ")" << std::endl;
+            std::cerr << "  [Measure] Write failed (error " << port.lastError() << ")" << std::endl;
             return false;
         }
 
         if (sendOnly)
             return true;
 
-        // Poll COMMSTATUS waiting for ACK data (≥19 bytes in RX queue)
-        DWORD   errors  = 0;
-        COMSTAT comstat = {};
-        int     elapsed = 0;
-
-        while (elapsed < CMD_ACK_TIMEOUT_MS)
+        // Wait for the ACK data (≥19 bytes in RX queue)
+        if (!port.waitForBytes(ACK_SIZE, CMD_ACK_TIMEOUT_MS))
         {
-            ClearCommError(hPort, &errors, &comstat);
-            if (comstat.cbInQue >= ACK_SIZE)
-                break;
-            Sleep(CMD_ACK_POLL_MS);
-            elapsed += CMD_ACK_POLL_MS;
-        }
-
-        if (comstat.cbInQue < ACK_SIZE)
-        {
-            std::cerr << "  [Measure] ACK timeout for command 0x" << std::hex << (int)cmd[1] << std::dec << " (got " << comstat.cbInQue << " bytes)"
+            std::cerr << "  [Measure] ACK timeout for command 0x" << std::hex << (int)cmd[1] << std::dec << " (got " << port.bytesAvailable() << " bytes)"
                       << std::endl;
             return false;
         }
@@ -97,10 +133,10 @@ namespace
         for (int ackRetry = 0; ackRetry <= CMD_ACK_MAX_RETRIES; ackRetry++)
         {
             uint8_t ackBuf[ACK_SIZE] = {};
-            DWORD   bytesRead        = 0;
-            if (!ReadFile(hPort, ackBuf, ACK_SIZE, &bytesRead, NULL) || bytesRead < ACK_SIZE)
+            size_t  bytesRead        = 0;
+            if (!port.read(ackBuf, ACK_SIZE, bytesRead) || bytesRead < ACK_SIZE)
             {
-                std::cerr << "  [Measure] ReadFile ACK failed (error " << GetLastError() << ")" << std::endl;
+                std::cerr << "  [Measure] Reading ACK failed (error " << port.lastError() << ")" << std::endl;
                 return false;
             }
 
@@ -114,18 +150,7 @@ namespace
                           << "), retry " << (ackRetry + 1) << "/" << CMD_ACK_MAX_RETRIES << std::endl;
 
                 // Wait for the next 19 bytes to arrive
-                errors  = 0;
-                comstat = {};
-                elapsed = 0;
-                while (elapsed < CMD_ACK_TIMEOUT_MS)
-                {
-                    ClearCommError(hPort, &errors, &comstat);
-                    if (comstat.cbInQue >= ACK_SIZE)
-                        break;
-                    Sleep(CMD_ACK_POLL_MS);
-                    elapsed += CMD_ACK_POLL_MS;
-                }
-                if (comstat.cbInQue < ACK_SIZE)
+                if (!port.waitForBytes(ACK_SIZE, CMD_ACK_TIMEOUT_MS))
                 {
                     std::cerr << "  [Measure] ACK timeout after skipping stale data" << std::endl;
                     return false;
@@ -137,6 +162,110 @@ namespace
         return false;
     }
 
+    // --------------------------------------------------------------------------
+    // Send a group of commands back to back and collect their ACKs as they come
+    // --------------------------------------------------------------------------
+    // Up to CMD_BURST_WINDOW commands are outstanding at a time, so the group costs
+    // one round-trip instead of one per command. Each ACK is matched by its
+    // code/index echo (bytes 0 and 1) to the oldest outstanding command with that
+    // code and index; other records (stale data) are skipped, at most
+    // CMD_ACK_MAX_RETRIES of them per command. A command fails when its ACK has not
+    // come CMD_ACK_TIMEOUT_MS after it was sent and the command before it was
+    // acknowledged, or when the tracker answers with an error message.
+    // Returns false on the first failure, leaving the group partly applied.
+    bool SendCommandBurst(SerialTransport &port, const std::vector<std::vector<uint8_t>> &cmds)
+    {
+        port.purge(true, false);
+
+        std::vector<uint8_t> acked(cmds.size(), 0);
+        size_t               oldest    = 0; // first command without an ACK
+        size_t               next      = 0; // first command not yet sent
+        int64_t              oldestDue = 0; // oldest's ACK deadline, counted from when it became the oldest
+        int                  skipped   = 0; // non-ACK records read since oldest became the oldest
+
+        while (oldest < cmds.size())
+        {
+            for (; next < cmds.size() && next - oldest < CMD_BURST_WINDOW; ++next)
+            {
+                if (!port.write(cmds[next].data(), cmds[next].size()))
+                {
+                    std::cerr << "  [Measure] Write failed (error " << port.lastError() << ")" << std::endl;
+                    return false;
+                }
+                if (next == oldest)
+                    oldestDue = NowMs() + CMD_ACK_TIMEOUT_MS;
+            }
+
+            if (!port.waitForBytes(ACK_SIZE, static_cast<int>(std::max<int64_t>(oldestDue - NowMs(), 0))))
+            {
+                std::cerr << "  [Measure] ACK timeout for command 0x" << std::hex << (int)cmds[oldest][1] << std::dec << " (" << oldest << " of "
+                          << cmds.size() << " acknowledged)" << std::endl;
+                return false;
+            }
+
+            uint8_t ackBuf[ACK_SIZE] = {};
+            size_t  bytesRead        = 0;
+            if (!port.read(ackBuf, ACK_SIZE, bytesRead) || bytesRead < ACK_SIZE)
+            {
+                std::cerr << "  [Measure] Reading ACK failed (error " << port.lastError() << ")" << std::endl;
+                return false;
+            }
+
+            size_t k = oldest;
+            while (k < next && (acked[k] || cmds[k][1] != ackBuf[0] || cmds[k][2] != ackBuf[1]))
+                ++k;
+            if (k == next)
+            {
+                // Not an answer to a command in flight. A tracker still streaming a retained
+                // TFS keeps the RX queue full, so the wait above never times out on its own.
+                if (++skipped > CMD_ACK_MAX_RETRIES || NowMs() >= oldestDue)
+                {
+                    std::cerr << "  [Measure] ACK not found for command 0x" << std::hex << (int)cmds[oldest][1] << std::dec << " after skipping "
+                              << skipped << " non-ACK records (" << oldest << " of " << cmds.size() << " acknowledged)" << std::endl;
+                    return false;
+                }
+                continue;
+            }
+
+            if (ackBuf[14] != 0x06)
+            {
+                std::cerr << "  [Measure] Error message 0x" << std::hex << (int)ackBuf[14] << " for command 0x" << (int)cmds[k][1] << std::dec
+                          << std::endl;
+                return false;
+            }
+
+            acked[k] = 1;
+            while (oldest < cmds.size() && acked[oldest])
+            {
+                ++oldest;
+                skipped = 0;
+                if (oldest < next)
+                    oldestDue = NowMs() + CMD_ACK_TIMEOUT_MS;
+            }
+        }
+        return true;
+    }
+
+    // --------------------------------------------------------------------------
+    // Send a group of configuration commands: pipelined, and if the burst fails,
+    // once more from the start with a round-trip per command. The whole group is
+    // repeated, so it has to be safe to apply twice (a TFS program starts with
+    // its clear).
+    // --------------------------------------------------------------------------
+    bool SendCommandGroup(SerialTransport &port, const std::vector<std::vector<uint8_t>> &cmds)
+    {
+        if (SendCommandBurst(port, cmds))
+            return true;
+
+        std::cout << "  [Measure] Pipelined configuration failed — resending " << cmds.size() << " commands one at a time" << std::endl;
+        for (const auto &cmd : cmds)
+        {
+            if (!SendCommand(port, cmd))
+                return false;
+        }
+        return true;
+    }
+
     // --------------------------------------------------------------------------
     // Encode a uint32_t as 4 bytes, MSB first (big-endian)
     // --------------------------------------------------------------------------
@@ -149,66 +278,77 @@ namespace
     }
 
     // --------------------------------------------------------------------------
-    // Decode a big-endian unsigned 32-bit value
+    // Parse `count` consecutive 19-byte records into `samples[0, count)`.
+    // The records are batch-decoded into `columns` (SIMD where available) first.
     // --------------------------------------------------------------------------
-    uint32_t DecodeBE32(const uint8_t *buf)
+    void ParseRecords(const uint8_t *records, size_t count, DataSetColumns &columns, HHD_MeasurementSample *samples)
     {
-        return (static_cast<uint32_t>(buf[0]) << 24) | (static_cast<uint32_t>(buf[1]) << 16) | (static_cast<uint32_t>(buf[2]) << 8) |
-               static_cast<uint32_t>(buf[3]);
-    }
+        columns.clear();
+        decodeDataSets(records, count, columns);
 
-    // --------------------------------------------------------------------------
-    // Decode a big-endian signed 24-bit value (sign-extended to int32_t)
-    // --------------------------------------------------------------------------
-    int32_t DecodeBE24Signed(const uint8_t *buf)
-    {
-        int32_t val = (static_cast<int32_t>(buf[0]) << 16) | (static_cast<int32_t>(buf[1]) << 8) | static_cast<int32_t>(buf[2]);
-        if (val & 0x800000)
-            val |= static_cast<int32_t>(0xFF000000); // sign-extend
-        return val;
+        for (size_t i = 0; i < count; ++i)
+        {
+            HHD_MeasurementSample s = {};
+            s.timestamp_us          = columns.timestamp_us[i];
+            s.x_mm                  = columns.x[i] / 100.0;
+            s.y_mm                  = columns.y[i] / 100.0;
+            s.z_mm                  = columns.z[i] / 100.0;
+            s.status                = columns.statusWord[i];
+            s.ledId                 = columns.ledId[i];
+            s.tcmId                 = columns.tcmId[i];
+            s.endOfFrame            = columns.endOfFrame[i] != 0;
+            s.coordStatus           = columns.coordStatus[i];
+            s.ambientLight          = columns.ambientLight[i];
+            s.triggerIndex          = columns.triggerIndex[i];
+            s.rightEyeSignal        = columns.rightEyeSignal[i];
+            s.rightEyeStatus        = columns.rightEyeStatus[i];
+            s.centerEyeSignal       = columns.centerEyeSignal[i];
+            s.centerEyeStatus       = columns.centerEyeStatus[i];
+            s.leftEyeSignal         = columns.leftEyeSignal[i];
+            s.leftEyeStatus         = columns.leftEyeStatus[i];
+            samples[i]              = s;
+        }
     }
 
     // --------------------------------------------------------------------------
-    // Parse a single 19-byte record into a measurement sample
+    // Collects the data sets the framer emits into runs of records that are
+    // consecutive in memory, and batch-decodes each run where it lies.
     // --------------------------------------------------------------------------
-    HHD_MeasurementSample ParseRecord(const uint8_t *rec)
+    class RecordRuns
     {
-        HHD_MeasurementSample s = {};
-        s.timestamp_us          = DecodeBE32(&rec[0]);                // bytes 1-4
-        s.x_mm                  = DecodeBE24Signed(&rec[4]) / 100.0;  // bytes 5-7
-        s.y_mm                  = DecodeBE24Signed(&rec[7]) / 100.0;  // bytes 8-10
-        s.z_mm                  = DecodeBE24Signed(&rec[10]) / 100.0; // bytes 11-13
-        s.status                = DecodeBE32(&rec[13]);               // bytes 14-17
-        s.ledId                 = rec[17] & 0x7F;                     // byte 18, bits 6-0
-        s.tcmId                 = rec[18] & 0x0F;                     // byte 19, bits 3-0
-
-        // Decode status word fields (bytes 14-17, 0-indexed: rec[13]-rec[16])
-        // Byte 14: E|HHH|mmmm
-        uint8_t b14             = rec[13];
-        s.endOfFrame            = (b14 >> 7) & 1;
-        s.coordStatus           = (b14 >> 4) & 0x07;
-        s.ambientLight          = b14 & 0x0F;
-
-        // Byte 15: ???|La|AAAA (right eye)
-        uint8_t b15             = rec[14];
-        s.rightEyeSignal        = (b15 >> 4) & 0x01;
-        s.rightEyeStatus        = b15 & 0x0F;
-
-        // Byte 16: TTT|Lb|BBBB (center eye + trigger high bits)
-        uint8_t b16             = rec[15];
-        s.centerEyeSignal       = (b16 >> 4) & 0x01;
-        s.centerEyeStatus       = b16 & 0x0F;
-
-        // Byte 17: TTT|Lc|CCCC (left eye + trigger low bits)
-        uint8_t b17             = rec[16];
-        s.leftEyeSignal         = (b17 >> 4) & 0x01;
-        s.leftEyeStatus         = b17 & 0x0F;
-
-        // Trigger index: upper 3 bits of byte 16 + upper 3 bits of byte 17
-        s.triggerIndex          = ((b16 >> 5) & 0x07) << 3 | ((b17 >> 5) & 0x07);
-
-        return s;
-    }
+      public:
+        RecordRuns(DataSetColumns &columns, HHD_MeasurementSample *out) : m_columns(columns), m_out(out) {}
+
+        void add(ByteView bytes, bool skipped)
+        {
+            if (skipped || !PhoenixFramer::isDataSet(bytes.data()))
+                return;
+            if (m_count > 0 && bytes.data() != m_run + m_count * RECORD_SIZE)
+                flush();
+            if (m_count == 0)
+                m_run = bytes.data();
+            ++m_count;
+        }
+
+        // Decode the open run; call before the memory it points into changes
+        void flush()
+        {
+            if (m_count == 0)
+                return;
+            ParseRecords(m_run, m_count, m_columns, m_out + m_decoded);
+            m_decoded += m_count;
+            m_count    = 0;
+        }
+
+        size_t decoded() const { return m_decoded; }
+
+      private:
+        DataSetColumns        &m_columns;
+        HHD_MeasurementSample *m_out;
+        const uint8_t         *m_run     = nullptr; // first record of the open run
+        size_t                 m_count   = 0;       // records in the open run
+        size_t                 m_decoded = 0;
+    };
 
     // --------------------------------------------------------------------------
     // Wait for the device to become ready after a software reset.
@@ -217,42 +357,36 @@ namespace
     // before returning.  This prevents stale data from colliding with the
     // first configuration command ACK.
     // --------------------------------------------------------------------------
-    bool WaitForDeviceReady(HANDLE hPort, int timeoutMs)
+    bool WaitForDeviceReady(SerialTransport &port, int timeoutMs)
     {
-        DWORD   errors   = 0;
-        COMSTAT comstat  = {};
-        int     elapsed  = 0;
-        int     silentMs = 0;
-        bool    sawData  = false;
+        const int64_t start    = NowMs();
+        int64_t       lastData = start;
+        bool          sawData  = false;
 
-        while (elapsed < timeoutMs)
+        while (NowMs() - start < timeoutMs)
         {
-            ClearCommError(hPort, &errors, &comstat);
-            if (comstat.cbInQue > 0)
+            // Ready once the line has been silent long enough after the minimum boot time;
+            // sleep until then unless data arrives first
+            int64_t readyAt = std::max(lastData + RESET_SILENCE_THRESHOLD_MS, start + RESET_MIN_BOOT_MS);
+            int64_t waitMs  = std::min(readyAt, start + timeoutMs) - NowMs();
+            if (port.waitForBytes(1, static_cast<int>(std::max<int64_t>(waitMs, 0))))
             {
                 if (!sawData)
-                    std::cout << "  [Measure] Device responding after " << elapsed << "ms — draining" << std::endl;
-                sawData = true;
-                PurgeComm(hPort, PURGE_RXCLEAR);
-                silentMs = 0; // reset silence counter — more data may follow
+                    std::cout << "  [Measure] Device responding after " << (NowMs() - start) << "ms — draining" << std::endl;
+                sawData  = true;
+                port.purge(true, false);
+                lastData = NowMs(); // restart the silence period — more data may follow
             }
-            else
+            else if (NowMs() >= readyAt)
             {
-                silentMs += RESET_POLL_MS;
-                // Require sustained silence AND a minimum boot time
-                if (silentMs >= RESET_SILENCE_THRESHOLD_MS && elapsed >= RESET_MIN_BOOT_MS)
-                {
-                    std::cout << "  [Measure] Device ready after " << elapsed << "ms (" << silentMs << "ms silence)" << std::endl;
-                    PurgeComm(hPort, PURGE_RXCLEAR);
-                    return true;
-                }
+                std::cout << "  [Measure] Device ready after " << (NowMs() - start) << "ms (" << (NowMs() - lastData) << "ms silence)" << std::endl;
+                port.purge(true, false);
+                return true;
             }
-            Sleep(RESET_POLL_MS);
-            elapsed += RESET_POLL_MS;
         }
 
         std::cout << "  [Measure] Reset timeout (" << timeoutMs << "ms) — proceeding anyway" << std::endl;
-        PurgeComm(hPort, PURGE_RXCLEAR);
+        port.purge(true, false);
         return false;
     }
 
@@ -263,10 +397,26 @@ namespace
 // --------------------------------------------------------------------------
 struct HHD_MeasurementSession
 {
-    HANDLE                       hPort;
+    SerialTransport             *port;
     int                          frequencyHz;
     std::vector<HHD_MarkerEntry> markers;
-    std::vector<uint8_t>         residual;
+    ByteRing                     rx{RX_RING_SIZE, RX_RING_WINDOW}; // received bytes not yet framed
+    bool                         rxBacklog = false;                // the last fetch stopped at its sample limit with records left in rx
+    PhoenixFramer                framer;                           // RX stream framing, in place in rx
+    DataSetColumns               columns;                          // batch decode buffer reused across fetches
+
+    // Acquisition-thread mode (StartAcquisitionThread): the thread owns the port and the
+    // members above; the consumer only touches the ring and the wake-up condition.
+    std::unique_ptr<SpscRing<HHD_MeasurementSample>> ring;
+    std::thread                                      acquisition;
+    std::atomic<bool>                                stopAcquisition{false};
+    std::mutex                                       readyMutex; // only guards the wake-up, never the ring
+    std::condition_variable                          ready;
+    std::atomic<uint64_t>                            samplesAcquired{0};
+    std::atomic<uint64_t>                            samplesDropped{0};
+    std::atomic<uint64_t>                            bytesSkipped{0};
+    std::atomic<size_t>                              ringPeak{0};
+    std::atomic<bool>                                portLost{false};
 };
 
 // --------------------------------------------------------------------------
@@ -484,7 +634,7 @@ std::vector<HHD_ValidationIssue> ValidateMeasurementSetup(int frequencyHz, const
 // Public API
 // --------------------------------------------------------------------------
 
-HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const std::vector<HHD_MarkerEntry> &markers, int resetTimeoutMs)
+HHD_MeasurementSession *StartMeasurement(SerialTransport &port, int frequencyHz, const std::vector<HHD_MarkerEntry> &markers, int resetTimeoutMs)
 {
     // Validate setup before starting — abort on errors, log warnings
     auto issues = ValidateMeasurementSetup(frequencyHz, markers);
@@ -513,32 +663,24 @@ HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const st
               << std::endl;
 
     // Set timeouts for command/response phase
-    COMMTIMEOUTS timeouts                = {};
-    timeouts.ReadIntervalTimeout         = 50;
-    timeouts.ReadTotalTimeoutConstant    = CMD_ACK_TIMEOUT_MS;
-    timeouts.ReadTotalTimeoutMultiplier  = 10;
-    timeouts.WriteTotalTimeoutConstant   = 50;
-    timeouts.WriteTotalTimeoutMultiplier = 10;
-    SetCommTimeouts(hPort, &timeouts);
+    port.setTimeouts(COMMAND_TIMEOUTS);
 
     // Purge all buffers for clean state
-    PurgeComm(hPort, PURGE_RXCLEAR | PURGE_TXCLEAR);
+    port.purge(true, true);
 
     // Wait for any Initial Message the device sends after DTR assertion / port open,
     // then drain it so it doesn't collide with the first command ACK.
-    Sleep(300);
+    SleepMs(300);
     {
-        DWORD   drainErrors = 0;
-        COMSTAT drainStat   = {};
-        ClearCommError(hPort, &drainErrors, &drainStat);
-        if (drainStat.cbInQue > 0)
+        size_t pending = port.bytesAvailable();
+        if (pending > 0)
         {
-            std::cout << "  [Measure] Draining " << drainStat.cbInQue << " bytes (Initial Message)" << std::endl;
-            std::vector<uint8_t> drain(drainStat.cbInQue);
-            DWORD                bytesRead = 0;
-            ReadFile(hPort, drain.data(), drainStat.cbInQue, &bytesRead, NULL);
+            std::cout << "  [Measure] Draining " << pending << " bytes (Initial Message)" << std::endl;
+            std::vector<uint8_t> drain(pending);
+            size_t               bytesRead = 0;
+            port.read(drain.data(), pending, bytesRead);
         }
-        PurgeComm(hPort, PURGE_RXCLEAR);
+        port.purge(true, false);
     }
 
     // --- Configuration sequence (replicating IRP capture) ---
@@ -548,24 +690,27 @@ HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const st
     //    streaming data immediately after reboot.  Sending &5 first ensures
     //    the device is idle before we reset.
     std::cout << "  [Measure] Sending pre-reset STOP (&5)" << std::endl;
-    auto cmdPreStop = BuildCommand('5', '0', '0', '0');
-    SendCommand(hPort, cmdPreStop, /*sendOnly=*/true); // ignore result — device may not be running
-    Sleep(100);
-    PurgeComm(hPort, PURGE_RXCLEAR | PURGE_TXCLEAR);
+    auto cmdPreStop = BuildCommand('5', '0');
+    SendCommand(port, cmdPreStop, /*sendOnly=*/true); // ignore result — device may not be running
+    SleepMs(100);
+    port.purge(true, true);
 
     // 1. Software Reset: &` 000
     //    This command does NOT generate an ACK — the device reboots.
     //    VZSoft waits ~1.7s after sending this before continuing.
     std::cout << "  [Measure] Sending Software Reset (&`)" << std::endl;
-    auto cmdReset = BuildCommand('`', '0', '0', '0');
-    if (!SendCommand(hPort, cmdReset, /*sendOnly=*/true))
+    auto cmdReset = BuildCommand('`', '0');
+    if (!SendCommand(port, cmdReset, /*sendOnly=*/true))
     {
         std::cerr << "  [Measure] Software Reset send failed" << std::endl;
         return nullptr;
     }
 
     // Wait for device to reboot — returns early if the device sends data
-    WaitForDeviceReady(hPort, resetTimeoutMs);
+    WaitForDeviceReady(port, resetTimeoutMs);
+
+    // Steps 2-15 are each acknowledged, but sent as one pipelined group
+    std::vector<std::vector<uint8_t>> setup;
 
     // 2. Set timing: &v 042 + [sampling_period(4)] + [intermission(4)]
     //    The intermission is computed so that:
@@ -580,229 +725,302 @@ HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const st
     EncodeBE32(&timingParams[4], intermission_us);
 
     std::cout << "  [Measure] Setting timing: period=" << samplingPeriod_us << "us, intermission=" << intermission_us << "us" << std::endl;
-    auto cmdTiming = BuildCommand('v', '0', '4', '2', timingParams, 8);
-    if (!SendCommand(hPort, cmdTiming))
-        return nullptr;
+    setup.push_back(BuildCommand('v', '0', timingParams, 8));
 
     // 3. Signal Quality (SQR): &L 011 + 0x02
     uint8_t sqrParam = 0x02;
-    auto    cmdSQR   = BuildCommand('L', '0', '1', '1', &sqrParam, 1);
-    if (!SendCommand(hPort, cmdSQR))
-        return nullptr;
+    setup.push_back(BuildCommand('L', '0', &sqrParam, 1));
 
     // 4. Min Signal (MSR): &O 021 + 0x00 0x02
     uint8_t msrParams[] = {0x00, 0x02};
-    auto    cmdMSR      = BuildCommand('O', '0', '2', '1', msrParams, 2);
-    if (!SendCommand(hPort, cmdMSR))
-        return nullptr;
+    setup.push_back(BuildCommand('O', '0', msrParams, 2));
 
     // 5. Exposure Gain: &Y A11 + 0x08
     uint8_t gainParam = 0x08;
-    auto    cmdGain   = BuildCommand('Y', 'A', '1', '1', &gainParam, 1);
-    if (!SendCommand(hPort, cmdGain))
-        return nullptr;
+    setup.push_back(BuildCommand('Y', 'A', &gainParam, 1));
 
     // 6. SOT Limit: &U 011 + 0x03
     uint8_t sotParam = 0x03;
-    auto    cmdSOT   = BuildCommand('U', '0', '1', '1', &sotParam, 1);
-    if (!SendCommand(hPort, cmdSOT))
-        return nullptr;
+    setup.push_back(BuildCommand('U', '0', &sotParam, 1));
 
     // 7. Tether Mode: &^ 011 + 0x0D
     uint8_t tetherParam = 0x0D;
-    auto    cmdTether   = BuildCommand('^', '0', '1', '1', &tetherParam, 1);
-    if (!SendCommand(hPort, cmdTether))
-        return nullptr;
+    setup.push_back(BuildCommand('^', '0', &tetherParam, 1));
 
     // 8. Single Sampling: &Q A00
-    auto cmdSingleSamp = BuildCommand('Q', 'A', '0', '0');
-    if (!SendCommand(hPort, cmdSingleSamp))
-        return nullptr;
+    setup.push_back(BuildCommand('Q', 'A'));
 
     // 9. Clear TFS: &p 000
     std::cout << "  [Measure] Programming TFS (" << markers.size() << " markers across TCMs)" << std::endl;
-    auto cmdClearTFS = BuildCommand('p', '0', '0', '0');
-    if (!SendCommand(hPort, cmdClearTFS))
-        return nullptr;
+    setup.push_back(BuildCommand('p', '0'));
 
     // 10. Append each marker to TFS: &p {tcmId}12 + {ledId} {flashCount}
     //     Command index = TCMID ('1'-'8'), 2 params of 1 byte each
     for (const auto &m : markers)
     {
-        uint8_t tcm          = (m.tcmId >= 1 && m.tcmId <= 8) ? m.tcmId : 1;
-        uint8_t led          = (m.ledId >= 1 && m.ledId <= 64) ? m.ledId : 1;
-        uint8_t fc           = (m.flashCount >= 1) ? m.flashCount : 1;
-
-        char    indexChar    = static_cast<char>('0' + tcm); // '1'-'8'
-        uint8_t tfsParams[]  = {led, fc};
-        auto    cmdAppendTFS = BuildCommand('p', indexChar, '1', '2', tfsParams, 2);
-        if (!SendCommand(hPort, cmdAppendTFS))
-            return nullptr;
+        uint8_t tcm         = (m.tcmId >= 1 && m.tcmId <= 8) ? m.tcmId : 1;
+        uint8_t led         = (m.ledId >= 1 && m.ledId <= 64) ? m.ledId : 1;
+        uint8_t fc          = (m.flashCount >= 1) ? m.flashCount : 1;
+
+        char    indexChar   = static_cast<char>('0' + tcm); // '1'-'8'
+        uint8_t tfsParams[] = {led, fc};
+        setup.push_back(BuildCommand('p', indexChar, tfsParams, 2));
     }
 
     // 11. Sync EOF: &o 000
-    auto cmdSyncEOF = BuildCommand('o', '0', '0', '0');
-    if (!SendCommand(hPort, cmdSyncEOF))
-        return nullptr;
+    setup.push_back(BuildCommand('o', '0'));
 
     // 12. Multi-Rate Sampling SM0: &X 018 + 8 zero bytes
     uint8_t multiRateParams[8] = {};
-    auto    cmdMultiRate       = BuildCommand('X', '0', '1', '8', multiRateParams, 8);
-    if (!SendCommand(hPort, cmdMultiRate))
-        return nullptr;
+    setup.push_back(BuildCommand('X', '0', multiRateParams, 8));
 
     // 13. Upload TFS: &r 000
-    auto cmdUploadTFS = BuildCommand('r', '0', '0', '0');
-    if (!SendCommand(hPort, cmdUploadTFS))
-        return nullptr;
+    setup.push_back(BuildCommand('r', '0'));
 
     // 14. Refraction OFF: &: 000
-    auto cmdRefraction = BuildCommand(':', '0', '0', '0');
-    if (!SendCommand(hPort, cmdRefraction))
-        return nullptr;
+    setup.push_back(BuildCommand(':', '0'));
 
     // 15. Internal Trigger: &S 000
-    auto cmdTrigger = BuildCommand('S', '0', '0', '0');
-    if (!SendCommand(hPort, cmdTrigger))
+    setup.push_back(BuildCommand('S', '0'));
+
+    if (!SendCommandGroup(port, setup))
         return nullptr;
 
     // --- Switch to short read timeouts for streaming ---
-    timeouts.ReadIntervalTimeout        = 1;
-    timeouts.ReadTotalTimeoutConstant   = FETCH_READ_TIMEOUT_MS;
-    timeouts.ReadTotalTimeoutMultiplier = 0;
-    SetCommTimeouts(hPort, &timeouts);
+    port.setTimeouts(STREAM_TIMEOUTS);
 
     // --- START: &3 000 (no ACK generated) ---
     std::cout << "  [Measure] Sending START (&3)" << std::endl;
-    auto cmdStart = BuildCommand('3', '0', '0', '0');
-    if (!SendCommand(hPort, cmdStart, /*sendOnly=*/true))
+    auto cmdStart = BuildCommand('3', '0');
+    if (!SendCommand(port, cmdStart, /*sendOnly=*/true))
         return nullptr;
 
     std::cout << "[Measure] Measurement started" << std::endl;
 
     // Allocate session
     HHD_MeasurementSession *session = new HHD_MeasurementSession();
-    session->hPort                  = hPort;
+    session->port                   = &port;
     session->frequencyHz            = frequencyHz;
     session->markers                = markers;
     return session;
 }
 
-int FetchMeasurements(HHD_MeasurementSession *session, std::vector<HHD_MeasurementSample> &samples)
+// Wait until the receive ring and the port together hold the bytes that complete the next record
+static bool WaitForRecord(HHD_MeasurementSession *session, int timeoutMs)
 {
-    if (!session)
-        return 0;
-
-    // Check how many bytes are available in the RX queue
-    DWORD   errors  = 0;
-    COMSTAT comstat = {};
-    ClearCommError(session->hPort, &errors, &comstat);
-
-    if (comstat.cbInQue == 0 && session->residual.empty())
-        return 0; // nothing to read
-
-    // Read all available bytes
-    int newSamples = 0;
+    if (session->rxBacklog)
+        return true;
+    size_t pending = session->rx.size();
+    size_t needed  = pending < RECORD_SIZE ? RECORD_SIZE - pending : 1;
+    return session->port->waitForBytes(needed, timeoutMs);
+}
 
-    if (comstat.cbInQue > 0)
+// Read what the port has buffered into the receive ring, as far as the ring has room
+static void FillReceiveRing(HHD_MeasurementSession *session)
+{
+    size_t available = session->port->bytesAvailable();
+    while (available > 0 && session->rx.space() > 0)
     {
-        std::vector<uint8_t> readBuf(comstat.cbInQue);
-        DWORD                bytesRead = 0;
+        size_t   room      = 0;
+        uint8_t *span      = session->rx.writeSpan(room);
+        size_t   bytesRead = 0;
+        if (!session->port->read(span, std::min(room, available), bytesRead) || bytesRead == 0)
+            return;
+        session->rx.commit(bytesRead);
+        available -= std::min(available, bytesRead);
+    }
+}
 
-        if (!ReadFile(session->hPort, readBuf.data(), static_cast<DWORD>(readBuf.size()), &bytesRead, NULL))
-            return 0;
+// Decode up to `maxSamples` data sets from the receive ring into `samples`.
+// The bytes are framed and decoded in place: a partial record stays in the ring for the next
+// call, and after a lost or corrupted byte the framer re-aligns instead of shifting every
+// following record. Only data sets become samples; nothing is allocated.
+static size_t DecodeReceiveRing(HHD_MeasurementSession *session, HHD_MeasurementSample *samples, size_t maxSamples)
+{
+    RecordRuns                runs(session->columns, samples);
+    const PhoenixFramer::Sink sink = [&runs](ByteView bytes, bool skipped) { runs.add(bytes, skipped); };
 
-        readBuf.resize(bytesRead);
+    session->rxBacklog = false;
+    while (!session->rx.empty())
+    {
+        ByteView view  = session->rx.readSpan();
+        bool     whole = view.size() == session->rx.size();
+        size_t   used  = session->framer.frame(view, sink, maxSamples - runs.decoded());
+        runs.flush();
+        session->rx.consume(used);
 
-        // Prepend any residual bytes from the previous call
-        if (!session->residual.empty())
+        if (runs.decoded() == maxSamples)
         {
-            session->residual.insert(session->residual.end(), readBuf.begin(), readBuf.end());
-            readBuf.swap(session->residual);
-            session->residual.clear();
+            session->rxBacklog = session->rx.size() >= RECORD_SIZE;
+            break;
         }
+        if (whole || used == 0)
+            break;
+    }
+    return runs.decoded();
+}
 
-        // Parse complete 19-byte records
-        size_t offset = 0;
-        while (offset + RECORD_SIZE <= readBuf.size())
-        {
-            samples.push_back(ParseRecord(&readBuf[offset]));
-            newSamples++;
-            offset += RECORD_SIZE;
-        }
+// Read everything the port has buffered and append the data sets it completes
+static int ReadRecords(HHD_MeasurementSession *session, std::vector<HHD_MeasurementSample> &samples)
+{
+    FillReceiveRing(session);
 
-        // Save any trailing partial record for the next call
-        if (offset < readBuf.size())
-        {
-            session->residual.assign(readBuf.begin() + offset, readBuf.end());
-        }
-    }
-    else if (!session->residual.empty())
+    // Room for every record the ring can hold, trimmed to what was decoded
+    const size_t first = samples.size();
+    samples.resize(first + session->rx.size() / RECORD_SIZE);
+    samples.resize(first + DecodeReceiveRing(session, samples.data() + first, samples.size() - first));
+    return static_cast<int>(samples.size() - first);
+}
+
+// Body of the acquisition thread: read and decode as soon as data arrives and hand the
+// samples to the consumer through the ring. A full ring drops (and counts) the sample
+// rather than stalling the port.
+static void AcquisitionLoop(HHD_MeasurementSession *session)
+{
+    std::vector<HHD_MeasurementSample> batch;
+    while (!session->stopAcquisition.load(std::memory_order_relaxed))
     {
-        // Only residual data, no new bytes — check if we have a complete record
-        if (session->residual.size() >= RECORD_SIZE)
+        if (!WaitForRecord(session, ACQUISITION_WAIT_MS))
         {
-            size_t offset = 0;
-            while (offset + RECORD_SIZE <= session->residual.size())
-            {
-                samples.push_back(ParseRecord(&session->residual[offset]));
-                newSamples++;
-                offset += RECORD_SIZE;
-            }
-            if (offset < session->residual.size())
-            {
-                session->residual.erase(session->residual.begin(), session->residual.begin() + offset);
-            }
-            else
+            if (session->port->isOpen())
+                continue;
+
+            // The port is gone: stop instead of retrying, and wake the consumer to see portLost
             {
-                session->residual.clear();
+                std::lock_guard<std::mutex> lock(session->readyMutex);
+                session->portLost.store(true, std::memory_order_relaxed);
             }
+            session->ready.notify_one();
+            return;
         }
+
+        batch.clear();
+        if (ReadRecords(session, batch) == 0)
+            continue;
+
+        uint64_t dropped = 0;
+        for (const auto &sample : batch)
+            dropped += session->ring->push(sample) ? 0 : 1;
+        session->samplesAcquired.fetch_add(batch.size() - dropped, std::memory_order_relaxed);
+        session->samplesDropped.fetch_add(dropped, std::memory_order_relaxed);
+        session->bytesSkipped.store(session->framer.skippedBytes(), std::memory_order_relaxed);
+        session->ringPeak.store(std::max(session->ringPeak.load(std::memory_order_relaxed), session->ring->size()), std::memory_order_relaxed);
+
+        // Taking the mutex orders the push before a consumer's predicate check, so the wake-up cannot be lost
+        {
+            std::lock_guard<std::mutex> lock(session->readyMutex);
+        }
+        session->ready.notify_one();
     }
+}
+
+// Stop and join the acquisition thread (no-op without one); the port returns to the caller
+static void StopAcquisitionThread(HHD_MeasurementSession *session)
+{
+    if (!session->acquisition.joinable())
+        return;
+    session->stopAcquisition.store(true, std::memory_order_relaxed);
+    session->acquisition.join();
+}
+
+bool StartAcquisitionThread(HHD_MeasurementSession *session, size_t ringCapacity)
+{
+    if (!session || session->acquisition.joinable())
+        return false;
+
+    session->ring = std::make_unique<SpscRing<HHD_MeasurementSample>>(ringCapacity);
+    session->stopAcquisition.store(false);
+    session->portLost.store(false);
+    session->acquisition = std::thread(AcquisitionLoop, session);
+    return true;
+}
 
-    return newSamples;
+HHD_AcquisitionStats GetAcquisitionStats(const HHD_MeasurementSession *session)
+{
+    HHD_AcquisitionStats stats = {};
+    if (!session || !session->ring)
+        return stats;
+    stats.samplesAcquired = session->samplesAcquired.load(std::memory_order_relaxed);
+    stats.samplesDropped  = session->samplesDropped.load(std::memory_order_relaxed);
+    stats.bytesSkipped    = session->bytesSkipped.load(std::memory_order_relaxed);
+    stats.ringCapacity    = session->ring->capacity();
+    stats.ringPeak        = session->ringPeak.load(std::memory_order_relaxed);
+    stats.portLost        = session->portLost.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool WaitForMeasurements(HHD_MeasurementSession *session, int timeoutMs)
+{
+    if (!session)
+        return false;
+
+    if (!session->acquisition.joinable())
+        return WaitForRecord(session, timeoutMs);
+
+    std::unique_lock<std::mutex> lock(session->readyMutex);
+    return session->ready.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                   [&] { return !session->ring->empty() || session->portLost.load(std::memory_order_relaxed); });
+}
+
+int FetchMeasurements(HHD_MeasurementSession *session, std::vector<HHD_MeasurementSample> &samples)
+{
+    if (!session)
+        return 0;
+
+    // Acquisition thread running: only drain what it has decoded
+    if (session->acquisition.joinable())
+        return static_cast<int>(session->ring->popInto(samples));
+
+    return ReadRecords(session, samples);
+}
+
+int FetchMeasurements(HHD_MeasurementSession *session, HHD_MeasurementSample *samples, size_t maxSamples)
+{
+    if (!session || !samples)
+        return 0;
+
+    if (session->acquisition.joinable())
+        return static_cast<int>(session->ring->popInto(samples, maxSamples));
+
+    FillReceiveRing(session);
+    return static_cast<int>(DecodeReceiveRing(session, samples, maxSamples));
 }
 
 // Send STOP (&5) and drain streaming data until the ACK arrives.
 // During active measurement the device pipeline may contain many queued
 // records, so we read in a time-bounded loop rather than using the
 // generic SendCommand retry logic.
-static bool SendStopAndDrain(HANDLE hPort, int timeoutMs)
+static bool SendStopAndDrain(SerialTransport &port, int timeoutMs)
 {
     // Drain any data already in the host buffer
-    PurgeComm(hPort, PURGE_RXCLEAR);
+    port.purge(true, false);
 
     // Send &5
-    auto  cmdStop      = BuildCommand('5', '0', '0', '0');
-    DWORD bytesWritten = 0;
-    if (!WriteFile(hPort, cmdStop.data(), static_cast<DWORD>(cmdStop.size()), &bytesWritten, NULL))
+    auto cmdStop = BuildCommand('5', '0');
+    if (!port.write(cmdStop.data(), cmdStop.size()))
         return false;
 
     // Read 19-byte records until we find the ACK or timeout.
-    // Use GetTickCount64 for accurate wall-clock timing — the loop must
+    // Use a monotonic clock for accurate wall-clock timing — the loop must
     // not spin forever even when data is flowing continuously.
-    ULONGLONG startTick = GetTickCount64();
+    const int64_t deadline = NowMs() + timeoutMs;
 
-    while ((GetTickCount64() - startTick) < static_cast<ULONGLONG>(timeoutMs))
+    for (int64_t now = NowMs(); now < deadline; now = NowMs())
     {
-        DWORD   errors  = 0;
-        COMSTAT comstat = {};
-        ClearCommError(hPort, &errors, &comstat);
-
-        if (comstat.cbInQue >= ACK_SIZE)
+        if (!port.waitForBytes(ACK_SIZE, static_cast<int>(deadline - now)))
         {
-            uint8_t buf[ACK_SIZE] = {};
-            DWORD   bytesRead     = 0;
-            if (ReadFile(hPort, buf, ACK_SIZE, &bytesRead, NULL) && bytesRead >= ACK_SIZE)
-            {
-                if (buf[0] == 0x35 && buf[1] == 0x30) // '5' '0' = STOP ACK
-                    return true;
-                // Measurement data — discard and keep reading
-            }
+            if (!port.isOpen())
+                return false; // port lost
+            continue;
         }
-        else
+
+        uint8_t buf[ACK_SIZE] = {};
+        size_t  bytesRead     = 0;
+        if (port.read(buf, ACK_SIZE, bytesRead) && bytesRead >= ACK_SIZE)
         {
-            Sleep(CMD_ACK_POLL_MS);
+            if (buf[0] == 0x35 && buf[1] == 0x30) // '5' '0' = STOP ACK
+                return true;
+            // Measurement data — discard and keep reading
         }
     }
 
@@ -816,29 +1034,34 @@ bool StopMeasurement(HHD_MeasurementSession *session)
 
     std::cout << "[Measure] Stopping measurement" << std::endl;
 
+    // The port is needed for the stop commands
+    StopAcquisitionThread(session);
+
+    SerialTransport &port = *session->port;
+    if (!port.isOpen())
+    {
+        std::cout << "[Measure] Port lost — no STOP sent" << std::endl;
+        delete session;
+        return false;
+    }
+
     // Restore longer timeouts for the stop phase
-    COMMTIMEOUTS timeouts                = {};
-    timeouts.ReadIntervalTimeout         = 50;
-    timeouts.ReadTotalTimeoutConstant    = CMD_ACK_TIMEOUT_MS;
-    timeouts.ReadTotalTimeoutMultiplier  = 10;
-    timeouts.WriteTotalTimeoutConstant   = 50;
-    timeouts.WriteTotalTimeoutMultiplier = 10;
-    SetCommTimeouts(session->hPort, &timeouts);
+    port.setTimeouts(COMMAND_TIMEOUTS);
 
     // Send STOP and drain streaming data until ACK
     std::cout << "  [Measure] Sending STOP (&5) — attempt 1" << std::endl;
-    bool ack1 = SendStopAndDrain(session->hPort, 2000);
+    bool ack1 = SendStopAndDrain(port, 2000);
 
     if (!ack1)
     {
         // Retry after a gap (matches IRP capture pattern)
-        Sleep(STOP_GAP_MS);
+        SleepMs(STOP_GAP_MS);
         std::cout << "  [Measure] Sending STOP (&5) — attempt 2" << std::endl;
-        SendStopAndDrain(session->hPort, 2000);
+        SendStopAndDrain(port, 2000);
     }
 
     // Drain any remaining measurement data from the RX buffer
-    PurgeComm(session->hPort, PURGE_RXCLEAR);
+    port.purge(true, false);
 
     std::cout << "[Measure] Measurement stopped" << std::endl;
 
@@ -852,7 +1075,7 @@ bool StopMeasurement(HHD_MeasurementSession *session)
 // ConfigDetect — automatic marker & TCM discovery via probe measurement
 // ---------------------------------------------------------------------------
 
-HHD_ConfigDetectResult ConfigDetect(HANDLE hPort, const HHD_ConfigDetectOptions &options)
+HHD_ConfigDetectResult ConfigDetect(SerialTransport &port, const HHD_ConfigDetectOptions &options)
 {
     HHD_ConfigDetectResult result = {};
     result.success                = false;
@@ -870,7 +1093,7 @@ HHD_ConfigDetectResult ConfigDetect(HANDLE hPort, const HHD_ConfigDetectOptions
               << " (TCM 1-" << maxTcm << ", LED 1-" << maxLed << ")" << std::endl;
 
     // Start a probe measurement session
-    HHD_MeasurementSession *session = StartMeasurement(hPort, options.probeFreqHz, candidates);
+    HHD_MeasurementSession *session = StartMeasurement(port, options.probeFreqHz, candidates);
     if (!session)
     {
         result.summary = "Failed to start probe measurement";
@@ -881,13 +1104,13 @@ HHD_ConfigDetectResult ConfigDetect(HANDLE hPort, const HHD_ConfigDetectOptions
     // --- Warm-up phase: discard data while the tracker adjusts auto-exposure ---
     std::cout << "[ConfigDetect] Warm-up: discarding data for " << options.warmupMs << "ms" << std::endl;
     {
-        ULONGLONG                          warmupStart = GetTickCount64();
+        const int64_t                      warmupEnd = NowMs() + options.warmupMs;
         std::vector<HHD_MeasurementSample> discarded;
-        while ((GetTickCount64() - warmupStart) < static_cast<ULONGLONG>(options.warmupMs))
+        for (int64_t now = NowMs(); now < warmupEnd; now = NowMs())
         {
+            WaitForMeasurements(session, static_cast<int>(warmupEnd - now));
             discarded.clear();
             FetchMeasurements(session, discarded);
-            Sleep(10);
         }
     }
 
@@ -905,10 +1128,11 @@ HHD_ConfigDetectResult ConfigDetect(HANDLE hPort, const HHD_ConfigDetectOptions
     std::map<uint16_t, ProbeStats> stats;
 
     {
-        ULONGLONG                          evalStart = GetTickCount64();
+        const int64_t                      evalEnd = NowMs() + options.evalMs;
         std::vector<HHD_MeasurementSample> samples;
-        while ((GetTickCount64() - evalStart) < static_cast<ULONGLONG>(options.evalMs))
+        for (int64_t now = NowMs(); now < evalEnd; now = NowMs())
         {
+            WaitForMeasurements(session, static_cast<int>(evalEnd - now));
             samples.clear();
             FetchMeasurements(session, samples);
             for (const auto &s : samples)
@@ -929,7 +1153,6 @@ HHD_ConfigDetectResult ConfigDetect(HANDLE hPort, const HHD_ConfigDetectOptions
                 if (allEyesOk)
                     st.framesValid++;
             }
-            Sleep(5);
         }
     }
 
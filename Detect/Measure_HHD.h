@@ -1,6 +1,6 @@
 #pragma once
 
-#include <windows.h>
+#include "SerialTransport.h"
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -74,16 +74,18 @@ std::vector<HHD_ValidationIssue> ValidateMeasurementSetup(int frequencyHz, const
 // Allocated by StartMeasurement, freed by StopMeasurement.
 struct HHD_MeasurementSession;
 
-// Start a measurement session on an already-open COM port.
+// Start a measurement session on an already-open, configured port.
 //
 // Sends the full configuration sequence observed in the IRP capture:
 //   &` (software reset) -> &v (timing) -> &L (SQR) -> &O (MSR) -> &Y (gain)
 //   -> &U (SOT) -> &^ (tether) -> &Q (single sampling) -> &p (clear + program TFS)
 //   -> &o (sync EOF) -> &X (multi-rate) -> &r (upload TFS) -> &: (refraction off)
 //   -> &S (internal trigger) -> &3 (START)
+// Everything from &v to &S is sent pipelined, with the ACKs matched to the commands
+// as they arrive; if that fails the group is repeated one command at a time.
 //
 // Parameters:
-//   hPort          — open COM port handle (caller retains ownership)
+//   port           — open serial port (caller retains ownership; must outlive the session)
 //   frequencyHz    — desired measurement rate in Hz (1–4600, clamped)
 //   markers        — TFS entries defining which markers on which TCMs to sample.
 //                    Each entry maps to one &p append command.
@@ -93,13 +95,16 @@ struct HHD_MeasurementSession;
 //                    software reset. VZSoft waits ~1.7s; default 3000ms.
 //
 // Returns a session handle on success, or nullptr on failure.
-HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const std::vector<HHD_MarkerEntry> &markers, int resetTimeoutMs = 3000);
+HHD_MeasurementSession *StartMeasurement(SerialTransport &port, int frequencyHz, const std::vector<HHD_MarkerEntry> &markers, int resetTimeoutMs = 3000);
 
-// Fetch available measurement samples from the serial buffer.
+// Fetch available measurement samples from the serial buffer (or from the
+// acquisition thread's ring, see StartAcquisitionThread).
 //
-// Designed for use in a run loop: reads all available bytes from the port,
-// parses complete 19-byte records, buffers any residual partial record for
-// the next call.  Non-blocking when no data is available.
+// Designed for use in a run loop: reads all available bytes from the port into
+// the session's receive ring and decodes complete 19-byte data-set records in
+// place; a residual partial record stays in the ring for the next call.  A
+// dropped or corrupted byte only loses the affected record: the stream
+// re-aligns on the record structure.  Non-blocking when no data is available.
 //
 // Parameters:
 //   session — active measurement session
@@ -108,11 +113,56 @@ HHD_MeasurementSession *StartMeasurement(HANDLE hPort, int frequencyHz, const st
 // Returns the number of new samples appended (0 if none available).
 int FetchMeasurements(HHD_MeasurementSession *session, std::vector<HHD_MeasurementSample> &samples);
 
+// Same, into a caller-provided buffer: writes at most `maxSamples` samples to `samples` and
+// leaves the rest queued for the next call (WaitForMeasurements returns at once while
+// records are queued). Allocates nothing, so a run loop with a fixed buffer fetches
+// without touching the heap.
+//
+// Returns the number of samples written.
+int FetchMeasurements(HHD_MeasurementSession *session, HHD_MeasurementSample *samples, size_t maxSamples);
+
+// Block until FetchMeasurements has a complete record to return, or `timeoutMs` has passed.
+//
+// Sleeps on the port's receive notification rather than polling, so a run loop of
+// WaitForMeasurements + FetchMeasurements delivers each record as soon as its last
+// byte arrives and uses no CPU while the line is idle.
+//
+// Returns true if data is ready (or the acquisition thread lost the port), false on timeout.
+bool WaitForMeasurements(HHD_MeasurementSession *session, int timeoutMs);
+
+// Counters of the acquisition thread (all zero without one)
+struct HHD_AcquisitionStats
+{
+    uint64_t samplesAcquired; // samples decoded and queued for the consumer
+    uint64_t samplesDropped;  // samples lost because the ring was full (consumer too slow)
+    uint64_t bytesSkipped;    // bytes discarded while re-aligning the stream (line errors)
+    size_t   ringCapacity;    // samples the ring holds
+    size_t   ringPeak;        // highest ring fill seen
+    bool     portLost;        // the port failed (e.g. device unplugged) and acquisition stopped
+};
+
+// Move the session's port reads to a dedicated acquisition thread.
+//
+// The thread owns the port from now until StopMeasurement: it sleeps until data arrives,
+// decodes the records and queues the samples in a lock-free single-producer/single-consumer
+// ring of `ringCapacity` samples (rounded up to a power of two). FetchMeasurements and
+// WaitForMeasurements then only drain the ring, so a slow console or disk stall on the
+// consumer side no longer holds up the serial driver queue. At ~13k records/s the default
+// ring absorbs a consumer stall of about 5 s; beyond that samples are dropped and counted.
+// If the port fails (device unplugged) the thread ends and sets portLost in the stats;
+// WaitForMeasurements returns at once from then on.
+//
+// Returns false if the session already has an acquisition thread.
+bool StartAcquisitionThread(HHD_MeasurementSession *session, size_t ringCapacity = 65536);
+
+// Snapshot of the acquisition counters; callable from the consumer thread at any time.
+HHD_AcquisitionStats GetAcquisitionStats(const HHD_MeasurementSession *session);
+
 // Stop the measurement and free the session.
 //
-// Sends &5 (stop) twice with a ~1.5s gap (matching the IRP capture),
-// drains the RX buffer, and frees the session struct.
-// The COM port handle is NOT closed (caller manages its lifetime).
+// Stops the acquisition thread if there is one, sends &5 (stop) twice with a
+// ~1.5s gap (matching the IRP capture), drains the RX buffer, and frees the session struct.
+// The port is NOT closed (caller manages its lifetime).
 //
 // Parameters:
 //   session — active measurement session (invalid after this call)
@@ -172,11 +222,11 @@ struct HHD_ConfigDetectOptions
 // The caller must NOT have an active measurement session on the same port.
 //
 // Parameters:
-//   hPort   — open COM port handle (caller retains ownership)
+//   port    — open serial port (caller retains ownership)
 //   options — scan configuration (optional, sensible defaults)
 //
 // Returns:
 //   HHD_ConfigDetectResult with connected TCMs and their active markers.
 //   result.markerList is ready to pass directly to StartMeasurement().
-HHD_ConfigDetectResult ConfigDetect(HANDLE hPort,
+HHD_ConfigDetectResult ConfigDetect(SerialTransport &port,
                                      const HHD_ConfigDetectOptions &options = {});
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Read timeouts of a serial port, with the meaning of the Win32 COMMTIMEOUTS read fields
+struct SerialTimeouts
+{
+    uint32_t intervalMs;  // max gap between two bytes of one read (0 = not used)
+    uint32_t totalMs;     // constant part of the time limit of one read
+    uint32_t perByteMs;   // added to the time limit for every requested byte
+};
+
+// Byte stream to one tracker serial port.
+//
+// Carries everything the detection and measurement engine (Detect_HHD, StartMeasurement,
+// FetchMeasurements, StopMeasurement, ConfigDetect) does with a port, so the engine runs
+// on any backend: Win32 COM ports, POSIX termios devices, or a scripted port in tests.
+// The line settings mirror the serial driver requests the reference application issues
+// (handshake, baud rate and line control are separate requests, in that order).
+class SerialTransport
+{
+  public:
+    virtual ~SerialTransport() = default;
+
+    // Open the port exclusively ("COM9" on Windows, "ttyUSB0" or "/dev/ttyUSB0" elsewhere)
+    virtual bool open(const std::string &portName) = 0;
+    virtual void close()                           = 0;
+    virtual bool isOpen() const                    = 0;
+
+    // Hardware handshake as configured by the reference application: DTR control on,
+    // CTS (and where supported DSR) output flow control, transmit continues on XOFF
+    virtual bool setHandshake(uint16_t xonLimit) = 0;
+
+    // Any rate the port supports, including non-standard ones such as 2.5 Mbaud
+    virtual bool setBaudRate(uint32_t baudRate) = 0;
+
+    // 8 data bits, 1 stop bit, no parity - the only framing the tracker uses
+    virtual bool setLineControl8N1() = 0;
+
+    virtual bool setTimeouts(const SerialTimeouts &timeouts) = 0;
+
+    // Write all of `data`; false on an error or a short write
+    virtual bool write(const uint8_t *data, size_t size) = 0;
+
+    // Read up to `size` bytes within the timeouts; false on an error (a timeout is not an error)
+    virtual bool read(uint8_t *data, size_t size, size_t &bytesRead) = 0;
+
+    // Bytes waiting in the receive queue (pending line errors are cleared)
+    virtual size_t bytesAvailable() = 0;
+
+    // Block until at least `count` bytes are waiting or `timeoutMs` has passed; true if they are.
+    // Sleeps on the driver's receive notification (WaitCommEvent / poll) instead of polling.
+    // When the port fails instead (device unplugged, line hung up) the port is closed, so
+    // isOpen() tells a lost port from a timeout.
+    virtual bool waitForBytes(size_t count, int timeoutMs) = 0;
+
+    // Discard the receive and/or transmit queue
+    virtual void purge(bool rx, bool tx) = 0;
+
+    virtual bool setDtr(bool on) = 0;
+    virtual bool setRts(bool on) = 0;
+
+    // Size of the device configuration block reported by the driver (IOCTL_SERIAL_CONFIG_SIZE);
+    // false when the driver does not support the query
+    virtual bool configSize(uint32_t &size) = 0;
+
+    // Read-only status queries the reference application issues during detection. They have
+    // no effect on the port; backends without an equivalent do nothing.
+    virtual void queryHandshake() {}
+    virtual void queryPortStatus() {} // modem status, line errors, port properties
+    virtual void queryDtrRts() {}
+
+    // OS error code of the last failed call (GetLastError() / errno)
+    virtual int lastError() const = 0;
+};
+
+// Transport of the platform the program runs on (Win32 or POSIX termios)
+std::unique_ptr<SerialTransport> CreateSerialTransport();
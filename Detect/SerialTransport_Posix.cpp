@@ -0,0 +1,337 @@
+#ifndef _WIN32
+
+#include "SerialTransport.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Linux sets any baud rate through termios2 with BOTHER. <asm/termbits.h> defines its own
+// struct termios, so <termios.h> is only used on the other systems.
+#ifdef __linux__
+#include <asm/termbits.h>
+using PortAttributes = struct termios2;
+#else
+#include <termios.h>
+using PortAttributes = struct termios;
+#endif
+
+namespace
+{
+    // Write time limit: constant plus per byte, as the Win32 backend's WriteTotalTimeout*
+    const int WRITE_TIMEOUT_MS          = 50;
+    const int WRITE_TIMEOUT_PER_BYTE_MS = 10;
+
+    // Sleep limits while waiting for the rest of a partly received message
+    const int64_t MIN_LINE_WAIT_US = 50;
+    const int64_t MAX_LINE_WAIT_US = 1000;
+
+    bool GetAttributes(int fd, PortAttributes &attr)
+    {
+#ifdef __linux__
+        return ioctl(fd, TCGETS2, &attr) == 0;
+#else
+        return tcgetattr(fd, &attr) == 0;
+#endif
+    }
+
+    bool SetAttributes(int fd, const PortAttributes &attr)
+    {
+#ifdef __linux__
+        return ioctl(fd, TCSETS2, &attr) == 0;
+#else
+        return tcsetattr(fd, TCSANOW, &attr) == 0;
+#endif
+    }
+
+    bool SetSpeed(PortAttributes &attr, uint32_t baudRate)
+    {
+#ifdef __linux__
+        attr.c_cflag &= ~CBAUD;
+        attr.c_cflag |= BOTHER;
+        attr.c_ispeed = baudRate;
+        attr.c_ospeed = baudRate;
+        return true;
+#else
+        // Standard rates only; macOS and the BSDs take the rate as the speed value itself
+        return cfsetspeed(&attr, static_cast<speed_t>(baudRate)) == 0;
+#endif
+    }
+
+    void Flush(int fd, int queue)
+    {
+#ifdef __linux__
+        ioctl(fd, TCFLSH, queue);
+#else
+        tcflush(fd, queue);
+#endif
+    }
+
+    int64_t NowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // termios device (/dev/ttyUSB0, /dev/ttyS0, ...) in raw mode. Reads wait with poll() so
+    // the Win32 read timeouts (total, per byte and between bytes) behave the same here.
+    class PosixSerialTransport : public SerialTransport
+    {
+      public:
+        ~PosixSerialTransport() override { close(); }
+
+        bool open(const std::string &portName) override
+        {
+            close();
+            std::string path = portName.find('/') == std::string::npos ? "/dev/" + portName : portName;
+            m_fd             = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+            if (m_fd < 0)
+                return fail();
+
+            // Exclusive like a Win32 COM port, raw bytes, no echo or line editing
+            PortAttributes attr;
+            if (ioctl(m_fd, TIOCEXCL) != 0 || !GetAttributes(m_fd, attr))
+                return failAndClose();
+            attr.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+            attr.c_oflag &= ~OPOST;
+            attr.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+            attr.c_cflag |= CLOCAL | CREAD;
+            attr.c_cc[VMIN]  = 0;
+            attr.c_cc[VTIME] = 0;
+            if (!SetAttributes(m_fd, attr))
+                return failAndClose();
+            return true;
+        }
+
+        void close() override
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+            m_fd = -1;
+        }
+
+        bool isOpen() const override { return m_fd >= 0; }
+
+        // termios has CTS/RTS flow control only; DSR handshake and the XON limit have no equivalent
+        bool setHandshake(uint16_t) override
+        {
+            return changeAttributes(
+                       [](PortAttributes &attr)
+                       {
+                           attr.c_cflag |= CRTSCTS;
+                           return true;
+                       }) &&
+                   setDtr(true);
+        }
+
+        bool setBaudRate(uint32_t baudRate) override
+        {
+            if (!changeAttributes([&](PortAttributes &attr) { return SetSpeed(attr, baudRate); }))
+                return false;
+            m_baudRate = baudRate;
+            return true;
+        }
+
+        bool setLineControl8N1() override
+        {
+            return changeAttributes(
+                [](PortAttributes &attr)
+                {
+                    attr.c_cflag &= ~(CSIZE | CSTOPB | PARENB);
+                    attr.c_cflag |= CS8;
+                    return true;
+                });
+        }
+
+        bool setTimeouts(const SerialTimeouts &timeouts) override
+        {
+            m_timeouts = timeouts;
+            return true;
+        }
+
+        bool write(const uint8_t *data, size_t size) override
+        {
+            const int64_t deadline = NowMs() + WRITE_TIMEOUT_MS + WRITE_TIMEOUT_PER_BYTE_MS * static_cast<int64_t>(size);
+            size_t        written  = 0;
+            while (written < size)
+            {
+                ssize_t n = ::write(m_fd, data + written, size - written);
+                if (n > 0)
+                {
+                    written += static_cast<size_t>(n);
+                    continue;
+                }
+                if (n < 0 && errno != EAGAIN && errno != EINTR)
+                    return fail();
+                if (waitFor(POLLOUT, deadline - NowMs()) <= 0)
+                    return false;
+            }
+            return true;
+        }
+
+        bool read(uint8_t *data, size_t size, size_t &bytesRead) override
+        {
+            bytesRead              = 0;
+            const int64_t deadline = NowMs() + m_timeouts.totalMs + static_cast<int64_t>(m_timeouts.perByteMs) * static_cast<int64_t>(size);
+            while (bytesRead < size)
+            {
+                ssize_t n = ::read(m_fd, data + bytesRead, size - bytesRead);
+                if (n > 0)
+                {
+                    bytesRead += static_cast<size_t>(n);
+                    continue;
+                }
+                if (n < 0 && errno != EAGAIN && errno != EINTR)
+                    return fail();
+
+                // Nothing buffered: wait for more until the read's time limit, or the interval
+                // limit once the first bytes have arrived
+                int64_t waitMs = deadline - NowMs();
+                if (bytesRead > 0 && m_timeouts.intervalMs > 0)
+                    waitMs = std::min<int64_t>(waitMs, m_timeouts.intervalMs);
+                int ready = waitFor(POLLIN, waitMs);
+                if (ready < 0)
+                    return false;
+                if (ready == 0)
+                    break;
+            }
+            return true;
+        }
+
+        size_t bytesAvailable() override
+        {
+            int n = 0;
+            if (ioctl(m_fd, FIONREAD, &n) != 0)
+            {
+                fail();
+                return 0;
+            }
+            return static_cast<size_t>(n);
+        }
+
+        bool waitForBytes(size_t count, int timeoutMs) override
+        {
+            const int64_t deadline = NowMs() + timeoutMs;
+            size_t        previous = 0;
+            int64_t       stallUs  = 0;
+            for (size_t available = bytesAvailable(); available < count; available = bytesAvailable())
+            {
+                int64_t remainingMs = deadline - NowMs();
+                if (remainingMs <= 0)
+                    return false;
+                if (available == 0)
+                {
+                    // Idle line: sleep in poll() until the first byte arrives. A hang-up or
+                    // error is reported at once and for good, so the port is closed.
+                    if (waitFor(POLLIN, remainingMs) < 0)
+                    {
+                        close();
+                        return false;
+                    }
+                    continue;
+                }
+
+                // Part of the data is in: poll() would report readable at once, so sleep for
+                // the time the missing bytes take on the line, backing off while nothing new comes
+                stallUs  = available == previous ? std::min(std::max(stallUs * 2, MIN_LINE_WAIT_US), MAX_LINE_WAIT_US) : 0;
+                previous = available;
+
+                int64_t lineUs = static_cast<int64_t>(count - available) * 10 * 1000000 / m_baudRate;
+                lineUs         = std::min<int64_t>(std::max({lineUs, stallUs, MIN_LINE_WAIT_US}), remainingMs * 1000);
+                std::this_thread::sleep_for(std::chrono::microseconds(lineUs));
+            }
+            return true;
+        }
+
+        void purge(bool rx, bool tx) override
+        {
+            if (rx || tx)
+                Flush(m_fd, rx && tx ? TCIOFLUSH : (rx ? TCIFLUSH : TCOFLUSH));
+        }
+
+        bool setDtr(bool on) override { return setModemLine(TIOCM_DTR, on); }
+        bool setRts(bool on) override { return setModemLine(TIOCM_RTS, on); }
+
+        // IOCTL_SERIAL_CONFIG_SIZE is specific to the Windows serial driver
+        bool configSize(uint32_t &size) override
+        {
+            size    = 0;
+            m_error = ENOTSUP;
+            return false;
+        }
+
+        void queryPortStatus() override
+        {
+            int lines = 0;
+            ioctl(m_fd, TIOCMGET, &lines);
+        }
+
+        int lastError() const override { return m_error; }
+
+      private:
+        // Remember errno of the failed call; always false
+        bool fail()
+        {
+            m_error = errno;
+            return false;
+        }
+
+        bool failAndClose()
+        {
+            fail();
+            close();
+            return false;
+        }
+
+        // Wait up to `timeoutMs` until the port is ready for `events`: 1 ready (or interrupted), 0 timeout,
+        // -1 error (also a hang-up or error condition on the port, e.g. a USB adapter unplugged)
+        int waitFor(short events, int64_t timeoutMs)
+        {
+            if (timeoutMs <= 0)
+                return 0;
+            pollfd pfd = {m_fd, events, 0};
+            int    rc  = poll(&pfd, 1, static_cast<int>(timeoutMs));
+            if (rc < 0)
+                return errno == EINTR ? 1 : (fail(), -1);
+            if (rc > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)))
+            {
+                m_error = (pfd.revents & POLLNVAL) ? EBADF : EIO;
+                return -1;
+            }
+            return rc > 0 ? 1 : 0;
+        }
+
+        bool setModemLine(int line, bool on) { return ioctl(m_fd, on ? TIOCMBIS : TIOCMBIC, &line) == 0 || fail(); }
+
+        // Read-modify-write of the port attributes; `change` returns false for a setting the system lacks
+        template <typename Change> bool changeAttributes(Change change)
+        {
+            PortAttributes attr;
+            if (!GetAttributes(m_fd, attr))
+                return fail();
+            if (!change(attr))
+            {
+                m_error = EINVAL;
+                return false;
+            }
+            return SetAttributes(m_fd, attr) || fail();
+        }
+
+        int            m_fd       = -1;
+        int            m_error    = 0;
+        SerialTimeouts m_timeouts = {50, 500, 10};
+        uint32_t       m_baudRate = 9600;
+    };
+} // anonymous namespace
+
+std::unique_ptr<SerialTransport> CreateSerialTransport()
+{
+    return std::make_unique<PosixSerialTransport>();
+}
+
+#endif // !_WIN32
@@ -0,0 +1,273 @@
+#ifdef _WIN32
+
+#include "SerialTransport.h"
+
+#include <windows.h>
+
+// Serial IOCTL codes not exposed by the standard Win32 API.
+// These require DeviceIoControl() to invoke directly.
+#ifndef IOCTL_SERIAL_GET_DTRRTS
+#define IOCTL_SERIAL_GET_DTRRTS 0x001b0064
+#endif
+
+#ifndef IOCTL_SERIAL_CONFIG_SIZE
+#define IOCTL_SERIAL_CONFIG_SIZE 0x001b006c
+#endif
+
+namespace
+{
+    // COM port through CreateFile / SetCommState / ReadFile / WriteFile. The port is opened for
+    // overlapped I/O so that waitForBytes() can sleep in WaitCommEvent(EV_RXCHAR); every other
+    // request waits for its own completion and behaves as before.
+    class Win32SerialTransport : public SerialTransport
+    {
+      public:
+        Win32SerialTransport()
+        {
+            m_ioEvent   = CreateEventA(NULL, TRUE, FALSE, NULL);
+            m_waitEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+        }
+
+        ~Win32SerialTransport() override
+        {
+            close();
+            CloseHandle(m_ioEvent);
+            CloseHandle(m_waitEvent);
+        }
+
+        bool open(const std::string &portName) override
+        {
+            close();
+            // "\\.\" prefix so that COM10 and above open as well
+            std::string path = portName.rfind("\\\\.\\", 0) == 0 ? portName : "\\\\.\\" + portName;
+            m_port           = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+                                           NULL);
+            if (m_port == INVALID_HANDLE_VALUE)
+                return fail();
+            if (!SetCommMask(m_port, EV_RXCHAR))
+            {
+                fail();
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        void close() override
+        {
+            if (m_port != INVALID_HANDLE_VALUE)
+                CloseHandle(m_port);
+            m_port = INVALID_HANDLE_VALUE;
+        }
+
+        bool isOpen() const override { return m_port != INVALID_HANDLE_VALUE; }
+
+        // ControlHandShake = 0x2D:
+        //   Bit 0 (0x01): SERIAL_DTR_CONTROL
+        //   Bit 2 (0x04): SERIAL_DTR_HANDSHAKE
+        //   Bit 3 (0x08): SERIAL_CTS_HANDSHAKE
+        //   Bit 5 (0x20): SERIAL_DSR_HANDSHAKE
+        // FlowReplace = 0x01: SERIAL_XOFF_CONTINUE
+        bool setHandshake(uint16_t xonLimit) override
+        {
+            return changeState(
+                [&](DCB &dcb)
+                {
+                    dcb.fDtrControl       = DTR_CONTROL_ENABLE; // SERIAL_DTR_CONTROL
+                    dcb.fOutxCtsFlow      = TRUE;               // SERIAL_CTS_HANDSHAKE
+                    dcb.fOutxDsrFlow      = TRUE;               // SERIAL_DSR_HANDSHAKE
+                    dcb.fDsrSensitivity   = TRUE;               // SERIAL_DCD_HANDSHAKE
+                    dcb.fTXContinueOnXoff = TRUE;               // SERIAL_XOFF_CONTINUE
+                    dcb.XonLim            = xonLimit;
+                    dcb.XoffLim           = 0;
+                });
+        }
+
+        bool setBaudRate(uint32_t baudRate) override
+        {
+            return changeState([&](DCB &dcb) { dcb.BaudRate = baudRate; });
+        }
+
+        bool setLineControl8N1() override
+        {
+            return changeState(
+                [](DCB &dcb)
+                {
+                    dcb.ByteSize = 8;
+                    dcb.StopBits = ONESTOPBIT;
+                    dcb.Parity   = NOPARITY;
+                });
+        }
+
+        bool setTimeouts(const SerialTimeouts &t) override
+        {
+            COMMTIMEOUTS timeouts                = {};
+            timeouts.ReadIntervalTimeout         = t.intervalMs;
+            timeouts.ReadTotalTimeoutConstant    = t.totalMs;
+            timeouts.ReadTotalTimeoutMultiplier  = t.perByteMs;
+            timeouts.WriteTotalTimeoutConstant   = 50;
+            timeouts.WriteTotalTimeoutMultiplier = 10;
+            return SetCommTimeouts(m_port, &timeouts) || fail();
+        }
+
+        bool write(const uint8_t *data, size_t size) override
+        {
+            OVERLAPPED ov           = request();
+            DWORD      bytesWritten = 0;
+            if (!finish(WriteFile(m_port, data, static_cast<DWORD>(size), NULL, &ov), ov, bytesWritten))
+                return false;
+            return bytesWritten == size;
+        }
+
+        bool read(uint8_t *data, size_t size, size_t &bytesRead) override
+        {
+            OVERLAPPED ov = request();
+            DWORD      n  = 0;
+            bool       ok = finish(ReadFile(m_port, data, static_cast<DWORD>(size), NULL, &ov), ov, n);
+            bytesRead     = n;
+            return ok;
+        }
+
+        size_t bytesAvailable() override
+        {
+            DWORD   errors  = 0;
+            COMSTAT comstat = {};
+            if (!ClearCommError(m_port, &errors, &comstat))
+            {
+                fail();
+                return 0;
+            }
+            return comstat.cbInQue;
+        }
+
+        bool waitForBytes(size_t count, int timeoutMs) override
+        {
+            const ULONGLONG deadline = GetTickCount64() + static_cast<ULONGLONG>(timeoutMs > 0 ? timeoutMs : 0);
+            while (bytesAvailable() < count)
+            {
+                ULONGLONG now = GetTickCount64();
+                if (now >= deadline)
+                    return false;
+
+                DWORD      events = 0;
+                OVERLAPPED ov     = {};
+                ov.hEvent         = m_waitEvent;
+                if (WaitCommEvent(m_port, &events, &ov))
+                    continue;
+                if (GetLastError() != ERROR_IO_PENDING)
+                {
+                    // The driver refuses the wait once the device is gone (e.g. USB adapter unplugged)
+                    fail();
+                    close();
+                    return false;
+                }
+
+                // Bytes that arrived before the wait was issued raise no event, so check again
+                // before sleeping. Resetting the mask completes a wait that is no longer needed.
+                if (bytesAvailable() >= count || WaitForSingleObject(m_waitEvent, static_cast<DWORD>(deadline - now)) != WAIT_OBJECT_0)
+                    SetCommMask(m_port, EV_RXCHAR);
+                DWORD unused = 0;
+                GetOverlappedResult(m_port, &ov, &unused, TRUE);
+            }
+            return true;
+        }
+
+        void purge(bool rx, bool tx) override
+        {
+            DWORD flags = (rx ? PURGE_RXCLEAR : 0) | (tx ? PURGE_TXCLEAR : 0);
+            if (flags != 0)
+                PurgeComm(m_port, flags);
+        }
+
+        bool setDtr(bool on) override { return EscapeCommFunction(m_port, on ? SETDTR : CLRDTR) || fail(); }
+        bool setRts(bool on) override { return EscapeCommFunction(m_port, on ? SETRTS : CLRRTS) || fail(); }
+
+        bool configSize(uint32_t &size) override
+        {
+            OVERLAPPED ov            = request();
+            DWORD      value         = 0;
+            DWORD      bytesReturned = 0;
+            bool       ok            = finish(DeviceIoControl(m_port, IOCTL_SERIAL_CONFIG_SIZE, NULL, 0, &value, sizeof(value), NULL, &ov), ov, bytesReturned);
+            size                     = value;
+            return ok;
+        }
+
+        void queryHandshake() override
+        {
+            DCB dcb       = {};
+            dcb.DCBlength = sizeof(dcb);
+            GetCommState(m_port, &dcb);
+        }
+
+        void queryPortStatus() override
+        {
+            DWORD modemStatus = 0;
+            GetCommModemStatus(m_port, &modemStatus);
+
+            DWORD   errors  = 0;
+            COMSTAT comstat = {};
+            ClearCommError(m_port, &errors, &comstat);
+
+            COMMPROP commProp      = {};
+            commProp.wPacketLength = sizeof(COMMPROP);
+            GetCommProperties(m_port, &commProp);
+        }
+
+        void queryDtrRts() override
+        {
+            OVERLAPPED ov            = request();
+            DWORD      dtrRts        = 0;
+            DWORD      bytesReturned = 0;
+            finish(DeviceIoControl(m_port, IOCTL_SERIAL_GET_DTRRTS, NULL, 0, &dtrRts, sizeof(dtrRts), NULL, &ov), ov, bytesReturned);
+        }
+
+        int lastError() const override { return static_cast<int>(m_lastError); }
+
+      private:
+        // Remember the error of the failed call; always false
+        bool fail()
+        {
+            m_lastError = GetLastError();
+            return false;
+        }
+
+        // Overlapped request that completes on m_ioEvent
+        OVERLAPPED request() const
+        {
+            OVERLAPPED ov = {};
+            ov.hEvent     = m_ioEvent;
+            return ov;
+        }
+
+        // Wait for an overlapped request to complete; `started` is the result of the call that issued it
+        bool finish(BOOL started, OVERLAPPED &ov, DWORD &bytes)
+        {
+            if (!started && GetLastError() != ERROR_IO_PENDING)
+                return fail();
+            return GetOverlappedResult(m_port, &ov, &bytes, TRUE) || fail();
+        }
+
+        // Read-modify-write of the port's DCB (one SetCommState request per change)
+        template <typename Change> bool changeState(Change change)
+        {
+            DCB dcb       = {};
+            dcb.DCBlength = sizeof(dcb);
+            if (!GetCommState(m_port, &dcb))
+                return fail();
+            change(dcb);
+            return SetCommState(m_port, &dcb) || fail();
+        }
+
+        HANDLE m_port      = INVALID_HANDLE_VALUE;
+        HANDLE m_ioEvent   = NULL; // completion of read, write and IOCTL requests
+        HANDLE m_waitEvent = NULL; // completion of WaitCommEvent
+        DWORD  m_lastError = 0;
+    };
+} // anonymous namespace
+
+std::unique_ptr<SerialTransport> CreateSerialTransport()
+{
+    return std::make_unique<Win32SerialTransport>();
+}
+
+#endif // _WIN32
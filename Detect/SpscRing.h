@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity lock-free ring between exactly one producer thread and one consumer thread.
+// The capacity is rounded up to a power of two and allocated once; push() never blocks or
+// allocates, and a full ring rejects the element so the producer can count the overrun.
+// Head and tail live on separate cache lines. The producer keeps a cached copy of the head, so
+// push() only reads the consumer's index when the ring looks full; popInto() takes everything
+// up to the current tail in one batch.
+template <typename T> class SpscRing
+{
+  public:
+    explicit SpscRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < std::max<size_t>(capacity, 2))
+            size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscRing(const SpscRing &)            = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    size_t capacity() const { return m_slots.size(); }
+
+    // Producer: append `value`; false (and nothing stored) when the ring is full
+    bool push(const T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == m_slots.size())
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == m_slots.size())
+                return false;
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: append up to `maxCount` elements to `out` in FIFO order; returns the number moved
+    size_t popInto(std::vector<T> &out, size_t maxCount = static_cast<size_t>(-1))
+    {
+        const size_t head  = m_head.load(std::memory_order_relaxed);
+        const size_t count = std::min(m_tail.load(std::memory_order_acquire) - head, maxCount);
+        for (size_t i = 0; i < count; ++i)
+            out.push_back(m_slots[(head + i) & m_mask]);
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: copy up to `maxCount` elements to `out[0, maxCount)` in FIFO order; returns the number moved
+    size_t popInto(T *out, size_t maxCount)
+    {
+        const size_t head  = m_head.load(std::memory_order_relaxed);
+        const size_t count = std::min(m_tail.load(std::memory_order_acquire) - head, maxCount);
+        for (size_t i = 0; i < count; ++i)
+            out[i] = m_slots[(head + i) & m_mask];
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Either side: elements currently stored (a snapshot; head is read first so it never passes tail)
+    size_t size() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    bool empty() const { return size() == 0; }
+
+  private:
+    alignas(64) std::atomic<size_t> m_head{0}; // next element to pop (written by the consumer)
+    alignas(64) std::atomic<size_t> m_tail{0}; // next free slot (written by the producer)
+    size_t m_headCache = 0;                    // producer's copy of m_head
+    alignas(64) std::vector<T> m_slots;
+    size_t m_mask = 0;
+};
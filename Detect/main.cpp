@@ -3,6 +3,9 @@
 #include "DmsLogReader.h"
 #include "PhoenixDecoder.h"
 #include "JsonWriter.h"
+#include "FrameAssembler.h"
+#include "BatchRunner.h"
+#include "ConvertManifest.h"
 
 #include <windows.h>
 #include <iostream>
@@ -16,6 +19,7 @@
 #include <filesystem>
 #include <chrono>
 #include <ctime>
+#include <cstdlib>
 
 // VisualEyez Configuration
 // Based on logs: 2,500,000 baud, 8 data bits, 1 stop bit, No parity.
@@ -61,7 +65,7 @@ std::string BytesToString(const std::vector<unsigned char> &bytes)
 struct DetectedTracker
 {
     std::string portName;
-    DWORD       baudRate;
+    uint32_t    baudRate;
     std::string serialNumber;
 };
 
@@ -208,14 +212,14 @@ bool LoadDetectionSettings(std::vector<DetectedTracker> &trackers)
         return content.substr(pos, end - pos);
     };
 
-    auto extractNumber = [&](const std::string &key, size_t startPos) -> DWORD
+    auto extractNumber = [&](const std::string &key, size_t startPos) -> uint32_t
     {
         std::string search = "\"" + key + "\": ";
         size_t      pos    = content.find(search, startPos);
         if (pos == std::string::npos)
             return 0;
         pos += search.size();
-        return static_cast<DWORD>(std::stoul(content.substr(pos)));
+        return static_cast<uint32_t>(std::stoul(content.substr(pos)));
     };
 
     // Parse each object block delimited by '{' ... '}'
@@ -255,19 +259,27 @@ std::string GenerateLogFilename()
     return ss.str();
 }
 
-void WriteFrameNdjson(std::ofstream &logFile, const std::vector<HHD_MeasurementSample> &frameSamples)
+using SampleFrameAssembler = FrameAssembler<HHD_MeasurementSample>;
+
+// Write one assembled frame as an NDJSON line: the markers that were seen, in TFS order,
+// followed by the TFS slots that had no sample in this frame.
+void WriteFrameNdjson(std::ofstream &logFile, const std::vector<FrameSlot> &slots, const SampleFrameAssembler::Frame &frame)
 {
-    if (frameSamples.empty() || !logFile.is_open())
+    if (frame.presentCount == 0 || !logFile.is_open())
         return;
 
-    logFile << "{\"frame\":{\"timestamp_us\":" << frameSamples[0].timestamp_us << ",\"markerCount\":" << frameSamples.size()
-            << ",\"triggerIndex\":" << (int)frameSamples[0].triggerIndex << "},\"markers\":[";
+    logFile << "{\"frame\":{\"timestamp_us\":" << frame.timestamp_us << ",\"markerCount\":" << frame.presentCount << ",\"missingCount\":" << frame.missingCount()
+            << ",\"triggerIndex\":" << (int)frame.triggerIndex << ",\"complete\":" << (frame.complete ? "true" : "false") << "},\"markers\":[";
 
-    for (size_t i = 0; i < frameSamples.size(); i++)
+    bool first = true;
+    for (size_t i = 0; i < slots.size(); i++)
     {
-        const auto &s = frameSamples[i];
-        if (i > 0)
+        if (!frame.present[i])
+            continue;
+        const auto &s = frame.samples[i];
+        if (!first)
             logFile << ",";
+        first = false;
         logFile << std::fixed << std::setprecision(2) << "{\"tcmId\":" << (int)s.tcmId << ",\"ledId\":" << (int)s.ledId << ",\"position\":{\"x\":" << s.x_mm
                 << ",\"y\":" << s.y_mm << ",\"z\":" << s.z_mm << "}"
                 << ",\"quality\":{\"ambientLight\":" << (int)s.ambientLight << ",\"coordStatus\":" << (int)s.coordStatus
@@ -277,10 +289,44 @@ void WriteFrameNdjson(std::ofstream &logFile, const std::vector<HHD_MeasurementS
                 << "}}";
     }
 
+    logFile << "],\"missing\":[";
+    first = true;
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (frame.present[i])
+            continue;
+        if (!first)
+            logFile << ",";
+        first = false;
+        logFile << "{\"tcmId\":" << (int)slots[i].tcmId << ",\"ledId\":" << (int)slots[i].ledId << ",\"flash\":" << (int)slots[i].flashIndex << "}";
+    }
+
     logFile << "]}\n";
     logFile.flush();
 }
 
+// Open a detected tracker's port with the line settings of the detection sequence
+// (handshake, baud rate, 8N1) and RTS/DTR asserted
+bool OpenTrackerPort(SerialTransport &port, const DetectedTracker &tracker)
+{
+    if (!port.open(tracker.portName))
+    {
+        std::cout << "Failed to open " << tracker.portName << " (error " << port.lastError() << ")" << std::endl;
+        return false;
+    }
+
+    uint16_t xonLimit = (tracker.baudRate == 2000000) ? 22 : 82;
+    if (!port.setHandshake(xonLimit) || !port.setBaudRate(tracker.baudRate) || !port.setLineControl8N1())
+    {
+        std::cout << "Failed to configure " << tracker.portName << " (error " << port.lastError() << ")" << std::endl;
+        port.close();
+        return false;
+    }
+    port.setRts(true);
+    port.setDtr(true);
+    return true;
+}
+
 HANDLE CheckPort(int portNum)
 {
     std::string portName = "\\\\.\\COM" + std::to_string(portNum);
@@ -454,54 +500,55 @@ bool PingDevice(HANDLE hSerial)
 
 namespace fs = std::filesystem;
 
-static bool convertFile(const std::string &inputPath, const std::string &outputPath)
+static bool convertFile(const std::string &inputPath, const std::string &outputPath, std::ostream &log)
 {
-    std::cout << "Converting: " << inputPath << "\n";
+    log << "Converting: " << inputPath << "\n";
 
     DmsLogReader reader;
     if (!reader.open(inputPath))
+    {
+        log << "  Error: " << reader.error() << "\n";
         return false;
+    }
 
     const auto &hdr = reader.header();
-    std::cout << "  Device: " << hdr.deviceName << "\n";
+    log << "  Device: " << hdr.deviceName << "\n";
     if (!hdr.portConfig.empty())
-        std::cout << "  Port:   " << hdr.portConfig << "\n";
+        log << "  Port:   " << hdr.portConfig << "\n";
 
-    std::vector<IrpRecord> records;
-    if (!reader.readRecords(records))
+    size_t txCount = 0, rxCount = 0;
+    reader.forEachRecord(
+        [&](const IrpRecord &rec)
+        {
+            ++(rec.isTx() ? txCount : rxCount);
+            return true;
+        });
+    if (txCount + rxCount == 0)
     {
-        std::cerr << "  Error: no serial data records found\n";
+        log << "  Error: " << (reader.error().empty() ? "no serial data records found" : reader.error()) << "\n";
         return false;
     }
 
-    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> txRecords, rxRecords;
-    for (const auto &rec : records)
-    {
-        auto entry = std::make_pair(rec.timestamp, rec.serialData);
-        if (rec.functionCode == 4 && !rec.isCompletion)
-            txRecords.push_back(std::move(entry));
-        else
-            rxRecords.push_back(std::move(entry));
-    }
-
-    std::cout << "  TX packets: " << txRecords.size() << "\n";
-    std::cout << "  RX packets: " << rxRecords.size() << "\n";
-
-    PhoenixDecoder            decoder;
-    std::vector<PhoenixFrame> frames;
-    decoder.decode(txRecords, rxRecords, frames);
-
-    std::cout << "  Decoded frames: " << frames.size() << "\n";
+    log << "  TX packets: " << txCount << "\n";
+    log << "  RX packets: " << rxCount << "\n";
 
-    JsonWriter writer;
-    if (!writer.write(outputPath, hdr, inputPath, frames))
+    PhoenixDecoder decoder;
+    JsonWriter     writer;
+    if (!writer.write(outputPath, hdr, inputPath, [&](const FrameSink &sink) { decoder.decode(reader, sink); }))
+    {
+        log << "  Error: " << writer.error() << "\n";
         return false;
+    }
 
-    std::cout << "  Output: " << outputPath << "\n";
+    log << "  Decoded frames: " << writer.counts().total << "\n";
+    log << "  Output: " << outputPath << "\n";
     return true;
 }
 
-static int convertDirectory(const std::string &dirPath)
+// Memory budget of the files converted at once by convertDirectory()
+static const uint64_t kConvertMemoryBudget = 4096ULL << 20;
+
+static int convertDirectory(const std::string &dirPath, unsigned jobCount, bool force)
 {
     fs::path dir(dirPath);
     if (!fs::is_directory(dir))
@@ -510,7 +557,7 @@ static int convertDirectory(const std::string &dirPath)
         return 1;
     }
 
-    std::vector<std::pair<std::string, std::string>> filesToConvert;
+    std::vector<BatchJob> filesToConvert;
     for (const auto &entry : fs::recursive_directory_iterator(dir))
     {
         if (!entry.is_regular_file())
@@ -524,7 +571,7 @@ static int convertDirectory(const std::string &dirPath)
                 outPath = outPath.substr(0, dotPos) + ".json";
             else
                 outPath += ".json";
-            filesToConvert.emplace_back(entry.path().string(), outPath);
+            filesToConvert.push_back({entry.path().string(), outPath, entry.file_size()});
         }
     }
 
@@ -534,27 +581,69 @@ static int convertDirectory(const std::string &dirPath)
         return 1;
     }
 
-    int successCount = 0;
-    for (const auto &[inFile, outFile] : filesToConvert)
+    // Skip the files whose JSON is still current, unless forced
+    ConvertManifest                manifest;
+    std::vector<SourceFingerprint> fingerprints;
+    std::vector<BatchJob>          pending;
+    const std::string              settings = "json " + JsonOptions().settingsKey();
+    manifest.load(dirPath);
+    for (const auto &job : filesToConvert)
     {
-        if (convertFile(inFile, outFile))
-            ++successCount;
+        SourceFingerprint fingerprint = ConvertManifest::fingerprint(job.inputPath);
+        if (!force && manifest.isCurrent(job, settings, fingerprint))
+            continue;
+        pending.push_back(job);
+        fingerprints.push_back(fingerprint);
     }
+    if (pending.size() < filesToConvert.size())
+        std::cout << "Skipping " << filesToConvert.size() - pending.size() << " up-to-date file(s) (--force converts them again).\n";
 
-    std::cout << "\nConverted " << successCount << "/" << filesToConvert.size() << " file(s).\n";
-    return (successCount == static_cast<int>(filesToConvert.size())) ? 0 : 1;
+    BatchRunner runner(jobCount, kConvertMemoryBudget);
+    auto        convert = [&](const BatchJob &job, std::ostream &log)
+    {
+        if (!convertFile(job.inputPath, job.outputPath, log))
+            return false;
+        // Hashed for the manifest on the worker, while the capture is still cached (`job` is an element of `pending`)
+        SourceFingerprint &fingerprint = fingerprints[static_cast<size_t>(&job - pending.data())];
+        ConvertManifest::contentHash(job.inputPath, fingerprint.size, fingerprint.hash);
+        return true;
+    };
+    auto results = runner.run(pending, convert, std::cout, std::cerr);
+    runner.printReport(pending, results, std::cout);
+
+    bool allConverted = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (results[i].success)
+            manifest.record(pending[i], settings, fingerprints[i]);
+        else
+            allConverted = false;
+    }
+    manifest.save();
+    return allConverted ? 0 : 1;
 }
 
 int main(int argc, char *argv[])
 {
     // If a directory argument is given, convert all .dmslog8 files to JSON
+    // ("-j N": N files at once, "--force": also the files whose JSON is up to date)
     if (argc >= 2)
     {
-        return convertDirectory(argv[1]);
+        unsigned jobCount = 1;
+        bool     force    = false;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "-j" && i + 1 < argc)
+                jobCount = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            else if (arg == "--force")
+                force = true;
+        }
+        return convertDirectory(argv[1], jobCount, force);
     }
 
-    HANDLE                       hPort   = INVALID_HANDLE_VALUE;
-    HHD_MeasurementSession      *session = nullptr;
+    std::unique_ptr<SerialTransport> port    = CreateSerialTransport();
+    HHD_MeasurementSession          *session = nullptr;
     std::vector<DetectedTracker> detectedTrackers;
     std::vector<HHD_MarkerEntry> activeMarkers; // discovered or loaded marker config
 
@@ -583,6 +672,8 @@ int main(int argc, char *argv[])
     }
 
     const DWORD MEASURE_DURATION_MS = 3000;
+    const int   INPUT_POLL_MS       = 10;  // keyboard check interval while waiting for data
+    const int   FETCH_BATCH         = 512; // samples per fetch; the rest waits for the next pass
 
     std::cout << "VisualEyez Tracker Interactive Console" << std::endl;
     std::cout << "==========================================" << std::endl;
@@ -610,10 +701,14 @@ int main(int argc, char *argv[])
     std::cout << std::endl;
     ULONGLONG                          measureStartTick = 0;
     std::ofstream                      logFile;
-    std::vector<HHD_MeasurementSample> frameBuffer;
+    SampleFrameAssembler               frameAssembler;
+    std::vector<HHD_MeasurementSample> samples(FETCH_BATCH); // fetch buffer, allocated once
     bool                               cycling    = false;
     int                                cycleCount = 0;
 
+    // Frames completed by the assembler go to the NDJSON log
+    SampleFrameAssembler::FrameHandler writeFrame = [&](const SampleFrameAssembler::Frame &frame) { WriteFrameNdjson(logFile, frameAssembler.slots(), frame); };
+
     // Helper: open port, configure, and start a measurement session.
     // Returns true if session started successfully.
     auto startMeasurementOnTracker                = [&]() -> bool
@@ -621,33 +716,9 @@ int main(int argc, char *argv[])
         if (detectedTrackers.empty())
             return false;
 
-        const auto &tracker  = detectedTrackers[0];
-        std::string portPath = "\\\\.\\" + tracker.portName;
-        hPort                = CreateFileA(portPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-        if (hPort == INVALID_HANDLE_VALUE)
-        {
-            std::cout << "Failed to open " << tracker.portName << std::endl;
+        const auto &tracker = detectedTrackers[0];
+        if (!OpenTrackerPort(*port, tracker))
             return false;
-        }
-
-        DCB dcb       = {};
-        dcb.DCBlength = sizeof(dcb);
-        GetCommState(hPort, &dcb);
-        dcb.BaudRate          = tracker.baudRate;
-        dcb.ByteSize          = 8;
-        dcb.StopBits          = ONESTOPBIT;
-        dcb.Parity            = NOPARITY;
-        dcb.fDtrControl       = DTR_CONTROL_ENABLE;
-        dcb.fOutxCtsFlow      = TRUE;
-        dcb.fOutxDsrFlow      = TRUE;
-        dcb.fDsrSensitivity   = TRUE;
-        dcb.fTXContinueOnXoff = TRUE;
-        dcb.XonLim            = (tracker.baudRate == 2000000) ? 22 : 82;
-        dcb.XoffLim           = 0;
-        SetCommState(hPort, &dcb);
-
-        EscapeCommFunction(hPort, SETRTS);
-        EscapeCommFunction(hPort, SETDTR);
 
         // Use discovered markers if available, otherwise fall back to defaults
         std::vector<HHD_MarkerEntry> markers;
@@ -665,22 +736,23 @@ int main(int argc, char *argv[])
 
         std::cout << "Starting measurement on " << tracker.portName << " at 10 Hz (" << markers.size() << " markers)..." << std::endl;
 
-        session = StartMeasurement(hPort, 10, markers);
+        session = StartMeasurement(*port, 10, markers);
         if (session)
         {
+            // Port reads and decoding run on their own thread; this loop only drains its ring
+            StartAcquisitionThread(session);
             measureStartTick        = GetTickCount64();
             std::string logFilename = GenerateLogFilename();
             logFile.open(logFilename, std::ios::out | std::ios::trunc);
             if (logFile.is_open())
                 std::cout << "Logging to " << logFilename << std::endl;
-            frameBuffer.clear();
+            frameAssembler.configure(markers);
             return true;
         }
         else
         {
             std::cout << "Failed to start measurement." << std::endl;
-            CloseHandle(hPort);
-            hPort = INVALID_HANDLE_VALUE;
+            port->close();
             return false;
         }
     };
@@ -688,17 +760,16 @@ int main(int argc, char *argv[])
     // Helper: stop the current measurement session and close port.
     auto stopCurrentMeasurement = [&]()
     {
-        WriteFrameNdjson(logFile, frameBuffer);
-        frameBuffer.clear();
+        frameAssembler.flush(writeFrame);
         if (logFile.is_open())
             logFile.close();
+
+        HHD_AcquisitionStats stats = GetAcquisitionStats(session);
+        std::cout << "Acquired " << stats.samplesAcquired << " samples, " << stats.samplesDropped << " dropped (ring peak " << stats.ringPeak << "/"
+                  << stats.ringCapacity << ", " << stats.bytesSkipped << " bytes skipped)" << std::endl;
         StopMeasurement(session);
         session = nullptr;
-        if (hPort != INVALID_HANDLE_VALUE)
-        {
-            CloseHandle(hPort);
-            hPort = INVALID_HANDLE_VALUE;
-        }
+        port->close();
     };
 
     while (true)
@@ -716,14 +787,12 @@ int main(int argc, char *argv[])
                 for (int i = 1; i <= 16; ++i)
                 {
                     std::string portName = "COM" + std::to_string(i);
-                    std::string portPath = "\\\\.\\" + portName;
-                    HANDLE      hTest    = CreateFileA(portPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-                    if (hTest == INVALID_HANDLE_VALUE)
+                    if (!port->open(portName))
                         continue;
-                    CloseHandle(hTest);
+                    port->close();
 
                     std::cout << "Probing " << portName << "..." << std::endl;
-                    HHD_DetectionResult result = Detect_HHD(portName);
+                    HHD_DetectionResult result = Detect_HHD(*port, portName);
                     if (result.deviceFound)
                     {
                         std::cout << "  FOUND on " << result.portName;
@@ -752,33 +821,9 @@ int main(int argc, char *argv[])
                     continue;
                 }
 
-                const auto &tracker  = detectedTrackers[0];
-                std::string portPath = "\\\\.\\" + tracker.portName;
-                HANDLE      hProbe   = CreateFileA(portPath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-                if (hProbe == INVALID_HANDLE_VALUE)
-                {
-                    std::cout << "Failed to open " << tracker.portName << std::endl;
-                    continue;
-                }
-
                 // Configure port for the probe
-                DCB dcb       = {};
-                dcb.DCBlength = sizeof(dcb);
-                GetCommState(hProbe, &dcb);
-                dcb.BaudRate          = tracker.baudRate;
-                dcb.ByteSize          = 8;
-                dcb.StopBits          = ONESTOPBIT;
-                dcb.Parity            = NOPARITY;
-                dcb.fDtrControl       = DTR_CONTROL_ENABLE;
-                dcb.fOutxCtsFlow      = TRUE;
-                dcb.fOutxDsrFlow      = TRUE;
-                dcb.fDsrSensitivity   = TRUE;
-                dcb.fTXContinueOnXoff = TRUE;
-                dcb.XonLim            = (tracker.baudRate == 2000000) ? 22 : 82;
-                dcb.XoffLim           = 0;
-                SetCommState(hProbe, &dcb);
-                EscapeCommFunction(hProbe, SETRTS);
-                EscapeCommFunction(hProbe, SETDTR);
+                if (!OpenTrackerPort(*port, detectedTrackers[0]))
+                    continue;
 
                 std::cout << "\n--- Auto-detecting marker configuration ---" << std::endl;
 
@@ -786,8 +831,8 @@ int main(int argc, char *argv[])
                 opts.maxTcmId = 8;
                 opts.maxLedId = 16;
 
-                auto config   = ConfigDetect(hProbe, opts);
-                CloseHandle(hProbe);
+                auto config   = ConfigDetect(*port, opts);
+                port->close();
 
                 if (config.success && !config.markerList.empty())
                 {
@@ -898,27 +943,33 @@ int main(int argc, char *argv[])
         }
 
         // --- Fetch and display measurement data ---
+        // Sleeps until a record arrives (or the next keyboard check) instead of polling
         if (session)
         {
-            std::vector<HHD_MeasurementSample> samples;
-            FetchMeasurements(session, samples);
-            for (const auto &s : samples)
+            WaitForMeasurements(session, INPUT_POLL_MS);
+            int count = FetchMeasurements(session, samples.data(), samples.size());
+            for (int i = 0; i < count; ++i)
             {
+                const auto &s = samples[i];
                 std::cout << "t=" << std::setw(10) << s.timestamp_us << " TCM" << (int)s.tcmId << " LED" << std::setw(2) << (int)s.ledId << std::fixed
                           << std::setprecision(2) << " x=" << std::setw(9) << s.x_mm << " y=" << std::setw(9) << s.y_mm << " z=" << std::setw(9) << s.z_mm
                           << "  amb=" << (int)s.ambientLight << " R:" << (int)s.rightEyeStatus << " C:" << (int)s.centerEyeStatus
                           << " L:" << (int)s.leftEyeStatus << (s.endOfFrame ? " EOF" : "") << std::endl;
 
-                frameBuffer.push_back(s);
-                if (s.endOfFrame)
-                {
-                    WriteFrameNdjson(logFile, frameBuffer);
-                    frameBuffer.clear();
-                }
+                frameAssembler.add(s, writeFrame);
             }
-        }
 
-        Sleep(1); // avoid busy-waiting
+            if (count == 0 && GetAcquisitionStats(session).portLost)
+            {
+                std::cout << "\nSerial port lost (device unplugged?) — stopping measurement." << std::endl;
+                cycling = false;
+                stopCurrentMeasurement();
+            }
+        }
+        else
+        {
+            Sleep(INPUT_POLL_MS); // idle: only the keyboard to watch
+        }
     }
 
     return 0;
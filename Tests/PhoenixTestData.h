@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Tracker byte streams shared by the framer and decoder tests
+
+// `count` well-formed data-set frames with random payload, back to back
+inline std::vector<uint8_t> DataSetStream(size_t count, unsigned seed)
+{
+    std::mt19937         rng(seed);
+    std::vector<uint8_t> bytes(count * 19);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint8_t *p = &bytes[i * 19];
+        for (size_t k = 0; k < 19; ++k)
+            p[k] = static_cast<uint8_t>(rng());
+        p[14] = 0x00;                                        // not an ACK
+        p[17] = static_cast<uint8_t>(p[17] | 0x80);          // LED byte marker
+        p[18] = static_cast<uint8_t>(0xE0 | (p[18] & 0x0F)); // TCM byte marker
+    }
+    return bytes;
+}
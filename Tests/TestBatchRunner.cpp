@@ -0,0 +1,102 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/BatchRunner.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<BatchJob> MakeJobs(int count, uint64_t cost)
+{
+    std::vector<BatchJob> jobs;
+    for (int i = 0; i < count; ++i)
+        jobs.push_back({"in" + std::to_string(i), "out" + std::to_string(i), cost});
+    return jobs;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST_CLASS(BatchRunnerTests)
+{
+  public:
+    TEST_METHOD(RunsEveryJobOnceAndKeepsLogsTogether)
+    {
+        auto             jobs = MakeJobs(40, 1);
+        std::atomic<int> calls{0};
+        auto             convert = [&](const BatchJob &job, std::ostream &log)
+        {
+            ++calls;
+            log << "begin " << job.inputPath << "\n";
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            log << "end " << job.inputPath << "\n";
+            return job.inputPath != "in7";
+        };
+
+        BatchRunner        runner(4, 0);
+        std::ostringstream out, err;
+        auto               results = runner.run(jobs, convert, out, err);
+
+        Assert::AreEqual(40, calls.load());
+        Assert::AreEqual(size_t(40), results.size());
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            Assert::AreEqual(i != 7, results[i].success);
+            Assert::IsTrue(results[i].log == "begin in" + std::to_string(i) + "\nend in" + std::to_string(i) + "\n");
+        }
+
+        // Every log is printed as one block, the failed one to the error stream
+        std::string printed = out.str();
+        for (size_t i = 0; i < jobs.size(); ++i)
+        {
+            if (i != 7)
+                Assert::IsTrue(printed.find(results[i].log) != std::string::npos);
+        }
+        Assert::IsTrue(err.str() == results[7].log);
+    }
+
+    TEST_METHOD(StaysWithinMemoryBudget)
+    {
+        // Budget for two jobs at a time; the oversized job must run alone
+        auto jobs = MakeJobs(12, 100);
+        jobs[5].memoryCost = 1000;
+
+        std::atomic<uint64_t> inUse{0};
+        std::atomic<uint64_t> peak{0};
+        std::atomic<bool>     bigRanAlone{true};
+        auto                  convert = [&](const BatchJob &job, std::ostream &)
+        {
+            uint64_t now = inUse += job.memoryCost;
+            if (job.memoryCost == 1000 && now != 1000)
+                bigRanAlone = false;
+            if (job.memoryCost != 1000)
+            {
+                uint64_t p = peak;
+                while (now > p && !peak.compare_exchange_weak(p, now))
+                {
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            inUse -= job.memoryCost;
+            return true;
+        };
+
+        BatchRunner        runner(6, 250);
+        std::ostringstream out, err;
+        auto               results = runner.run(jobs, convert, out, err);
+
+        for (const auto &r : results)
+            Assert::IsTrue(r.success);
+        Assert::IsTrue(peak.load() <= 200);
+        Assert::IsTrue(bigRanAlone.load());
+    }
+};
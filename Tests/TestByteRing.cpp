@@ -0,0 +1,72 @@
+#include "CppUnitTest.h"
+#include "../Detect/ByteRing.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+TEST_CLASS(ByteRingTests)
+{
+  public:
+    TEST_METHOD(WritesUpToTheWrap)
+    {
+        ByteRing ring(12, 4);
+        Assert::AreEqual(size_t(16), ring.capacity());
+
+        size_t   room = 0;
+        uint8_t *span = ring.writeSpan(room);
+        Assert::AreEqual(size_t(16), room);
+        for (uint8_t i = 0; i < 10; ++i)
+            span[i] = i;
+        ring.commit(10);
+        ring.consume(6);
+        Assert::AreEqual(size_t(4), ring.size());
+        Assert::AreEqual(size_t(12), ring.space());
+
+        // Free space ends at the wrap; the next span starts at the front
+        ring.writeSpan(room);
+        Assert::AreEqual(size_t(6), room);
+        ring.commit(6);
+        span = ring.writeSpan(room);
+        Assert::AreEqual(size_t(6), room);
+        ring.commit(6);
+        Assert::AreEqual(size_t(0), ring.space());
+        ring.writeSpan(room);
+        Assert::AreEqual(size_t(0), room);
+    }
+
+    TEST_METHOD(ReadsAcrossTheWrapThroughTheMirror)
+    {
+        ByteRing ring(16, 4);
+        uint8_t  next = 0;
+        auto     fill = [&](size_t n)
+        {
+            while (n > 0)
+            {
+                size_t   room = 0;
+                uint8_t *span = ring.writeSpan(room);
+                room          = std::min(room, n);
+                for (size_t i = 0; i < room; ++i)
+                    span[i] = next++;
+                ring.commit(room);
+                n -= room;
+            }
+        };
+
+        fill(14);
+        ring.consume(14);
+        fill(10); // positions 14, 15, then 0..7 of the next lap
+
+        // The first 4 bytes past the end are mirrored: 6 contiguous bytes, then the rest from the front
+        ByteView view = ring.readSpan();
+        Assert::AreEqual(size_t(6), view.size());
+        for (size_t i = 0; i < view.size(); ++i)
+            Assert::AreEqual(uint8_t(14 + i), view[i]);
+        ring.consume(6);
+        view = ring.readSpan();
+        Assert::AreEqual(size_t(4), view.size());
+        Assert::AreEqual(uint8_t(20), view[0]);
+        Assert::AreEqual(uint8_t(23), view[3]);
+    }
+};
@@ -0,0 +1,108 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/ColumnarFile.h"
+#include "../ConvertToJson/ColumnarWriter.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static PhoenixFrame DataSetFrame(uint64_t irp, int32_t x, uint8_t led)
+{
+    PhoenixFrame f;
+    f.type                 = PhoenixFrameType::DataSet;
+    f.isTx                 = false;
+    f.irpTimestamp         = irp;
+    f.dataSet.timestamp_us = static_cast<uint32_t>(irp / 10);
+    f.dataSet.x            = x;
+    f.dataSet.y            = -x;
+    f.dataSet.z            = 2 * x;
+    f.dataSet.statusWord   = 0x80000000u | led;
+    f.dataSet.ledId        = led;
+    f.dataSet.tcmId        = 1;
+    return f;
+}
+
+static PhoenixFrame CommandFrame(uint64_t irp, char code, ByteView raw)
+{
+    PhoenixFrame f;
+    f.type                 = PhoenixFrameType::Command;
+    f.isTx                 = true;
+    f.irpTimestamp         = irp;
+    f.command.commandCode  = code;
+    f.command.commandIndex = '0';
+    f.rawBytes             = raw;
+    return f;
+}
+
+// ===========================================================================
+// Columnar export
+// ===========================================================================
+
+TEST_CLASS(ColumnarTests)
+{
+  public:
+    TEST_METHOD(RoundTrip)
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "phx_roundtrip.phxcol").string();
+
+        const uint8_t cmd[] = {'&', '3', '0', '0', '0', 0x0D};
+        DmsLogHeader  header{};
+        header.sessionTimestamp = 133000000000000000ULL;
+        header.deviceName       = "COM9";
+
+        // Enough data sets to spill the columns to their temporary files
+        const size_t   rows = 100000;
+        ColumnarWriter writer;
+        Assert::IsTrue(writer.begin(path, header, "capture.dmslog8"));
+        writer.writeFrame(CommandFrame(5, '3', ByteView(cmd, sizeof(cmd))));
+        for (size_t i = 0; i < rows; ++i)
+            writer.writeFrame(DataSetFrame(10 + i, static_cast<int32_t>(i) - 50000, static_cast<uint8_t>(i % 8)));
+        Assert::IsTrue(writer.end());
+
+        ColumnarFile file;
+        Assert::IsTrue(file.open(path));
+        Assert::AreEqual(uint64_t(rows), file.dataSetCount());
+        Assert::AreEqual(uint64_t(1), file.eventCount());
+        Assert::AreEqual(header.sessionTimestamp, file.sessionTimestamp());
+        Assert::IsTrue(file.text("meta.device") == "COM9");
+        Assert::IsTrue(file.text("meta.sourceFile") == "capture.dmslog8");
+
+        uint64_t       n = 0;
+        const int32_t *x = file.column<int32_t>("dataSet.x", n);
+        Assert::IsTrue(x != nullptr);
+        Assert::AreEqual(uint64_t(rows), n);
+        Assert::AreEqual(int32_t(-50000), x[0]);
+        Assert::AreEqual(int32_t(49999), x[rows - 1]);
+
+        const uint8_t *led = file.column<uint8_t>("dataSet.ledId", n);
+        Assert::AreEqual(uint8_t(7), led[rows - 1]);
+
+        const uint64_t *offsets = file.column<uint64_t>("event.payloadOffset", n);
+        Assert::AreEqual(uint64_t(2), n);
+        const uint8_t *payload = file.column<uint8_t>("event.payload", n);
+        Assert::AreEqual(uint64_t(sizeof(cmd)), offsets[1]);
+        Assert::AreEqual(uint8_t('3'), payload[1]);
+        Assert::AreEqual(uint8_t('3'), file.column<uint8_t>("event.code", n)[0]);
+
+        file.close();
+        std::remove(path.c_str());
+    }
+
+    TEST_METHOD(RejectsDamagedFile)
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "phx_damaged.phxcol").string();
+        std::FILE  *f    = std::fopen(path.c_str(), "wb");
+        std::fputs("PHXCOL not really", f);
+        std::fclose(f);
+
+        ColumnarFile file;
+        Assert::IsFalse(file.open(path));
+        std::remove(path.c_str());
+    }
+};
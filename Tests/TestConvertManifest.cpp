@@ -0,0 +1,143 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/ConvertManifest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static void WriteText(const fs::path &path, const std::string &text)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// Fresh directory with one capture and its converted output
+static fs::path MakeArchive(const char *name)
+{
+    fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    WriteText(dir / "a.dmslog8", std::string(200000, 'a') + "end");
+    WriteText(dir / "a.json", "{}");
+    return dir;
+}
+
+// Converts `job` as a batch run would: check, then hash the capture and record the output
+static bool ConvertIfStale(const fs::path &dir, const BatchJob &job, const std::string &settings)
+{
+    ConvertManifest   manifest;
+    SourceFingerprint fingerprint = ConvertManifest::fingerprint(job.inputPath);
+    manifest.load(dir.string());
+    bool current = manifest.isCurrent(job, settings, fingerprint);
+    if (!current && ConvertManifest::contentHash(job.inputPath, fingerprint.size, fingerprint.hash))
+        manifest.record(job, settings, fingerprint);
+    manifest.save();
+    return !current;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST_CLASS(ConvertManifestTests)
+{
+  public:
+    TEST_METHOD(SkipsCurrentOutputs)
+    {
+        fs::path dir = MakeArchive("phx_manifest_current");
+        BatchJob job{(dir / "a.dmslog8").string(), (dir / "a.json").string(), 0};
+
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+        Assert::IsFalse(ConvertIfStale(dir, job, "json full"));
+
+        // Other settings, or an output that was changed or removed, need a new conversion
+        Assert::IsTrue(ConvertIfStale(dir, job, "phxcol"));
+        WriteText(dir / "a.json", "{ }");
+        Assert::IsTrue(ConvertIfStale(dir, job, "phxcol"));
+        fs::remove(dir / "a.json");
+        Assert::IsTrue(ConvertIfStale(dir, job, "phxcol"));
+        fs::remove_all(dir);
+    }
+
+    TEST_METHOD(DetectsChangedCaptures)
+    {
+        fs::path dir = MakeArchive("phx_manifest_changed");
+        BatchJob job{(dir / "a.dmslog8").string(), (dir / "a.json").string(), 0};
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+
+        // Same contents under a new modification time stay current
+        auto later = fs::last_write_time(job.inputPath) + std::chrono::hours(1);
+        fs::last_write_time(job.inputPath, later);
+        Assert::IsFalse(ConvertIfStale(dir, job, "json full"));
+
+        // Same size, different tail
+        WriteText(job.inputPath, std::string(200000, 'a') + "END");
+        fs::last_write_time(job.inputPath, later + std::chrono::hours(1));
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+
+        // Same size, edited in the middle
+        WriteText(job.inputPath, std::string(100000, 'a') + "b" + std::string(99999, 'a') + "END");
+        fs::last_write_time(job.inputPath, later + std::chrono::hours(2));
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+        Assert::IsFalse(ConvertIfStale(dir, job, "json full"));
+
+        // Appended bytes
+        WriteText(job.inputPath, std::string(200000, 'a') + "END+");
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+        Assert::IsFalse(ConvertIfStale(dir, job, "json full"));
+        fs::remove_all(dir);
+    }
+
+    TEST_METHOD(HashCoversEveryByte)
+    {
+        fs::path dir  = MakeArchive("phx_manifest_hash");
+        fs::path path = dir / "a.dmslog8";
+
+        // Each byte of a stripe, of the zero-padded tail, and the length itself
+        std::string base(1000, 'x');
+        uint64_t    first = 0;
+        WriteText(path, base);
+        Assert::IsTrue(ConvertManifest::contentHash(path.string(), base.size(), first));
+        for (size_t at : {size_t(0), size_t(7), size_t(31), size_t(500), size_t(999)})
+        {
+            std::string edited = base;
+            uint64_t    hash   = 0;
+            edited[at]         = 'y';
+            WriteText(path, edited);
+            Assert::IsTrue(ConvertManifest::contentHash(path.string(), edited.size(), hash));
+            Assert::AreNotEqual(first, hash);
+        }
+        uint64_t padded = 0;
+        WriteText(path, base + std::string(1, '\0'));
+        Assert::IsTrue(ConvertManifest::contentHash(path.string(), base.size() + 1, padded));
+        Assert::AreNotEqual(first, padded);
+
+        // A capture that no longer has the expected size is not hashed
+        Assert::IsFalse(ConvertManifest::contentHash(path.string(), base.size(), padded));
+        fs::remove_all(dir);
+    }
+
+    TEST_METHOD(IgnoresDamagedManifest)
+    {
+        fs::path dir = MakeArchive("phx_manifest_damaged");
+        BatchJob job{(dir / "a.dmslog8").string(), (dir / "a.json").string(), 0};
+        Assert::IsTrue(ConvertIfStale(dir, job, "json full"));
+
+        std::string manifestPath = ConvertManifest::manifestPath(dir.string());
+        fs::resize_file(manifestPath, fs::file_size(manifestPath) - 3);
+
+        ConvertManifest   manifest;
+        SourceFingerprint fingerprint = ConvertManifest::fingerprint(job.inputPath);
+        Assert::IsFalse(manifest.load(dir.string()));
+        Assert::IsFalse(manifest.isCurrent(job, "json full", fingerprint));
+        fs::remove_all(dir);
+    }
+};
@@ -0,0 +1,94 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/DataSetBatch.h"
+
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::vector<uint8_t> RandomRecords(size_t count, unsigned seed)
+{
+    std::mt19937         rng(seed);
+    std::vector<uint8_t> bytes(count * 19);
+    for (auto &b : bytes)
+        b = static_cast<uint8_t>(rng());
+    return bytes;
+}
+
+static bool SameColumns(const DataSetColumns &a, const DataSetColumns &b)
+{
+    return a.timestamp_us == b.timestamp_us && a.x == b.x && a.y == b.y && a.z == b.z && a.statusWord == b.statusWord && a.ledId == b.ledId &&
+           a.tcmId == b.tcmId && a.endOfFrame == b.endOfFrame && a.coordStatus == b.coordStatus && a.ambientLight == b.ambientLight &&
+           a.rightEyeSignal == b.rightEyeSignal && a.rightEyeStatus == b.rightEyeStatus && a.centerEyeSignal == b.centerEyeSignal &&
+           a.centerEyeStatus == b.centerEyeStatus && a.leftEyeSignal == b.leftEyeSignal && a.leftEyeStatus == b.leftEyeStatus &&
+           a.triggerIndex == b.triggerIndex;
+}
+
+// ===========================================================================
+// Batch decoder
+// ===========================================================================
+
+TEST_CLASS(DataSetBatch)
+{
+  public:
+    TEST_METHOD(KnownRecord)
+    {
+        // ts 0x00010203, X -1.00 mm, Y +1.00 mm, Z min, status F5 3A B7 2C, LED 5, TCM 3
+        const uint8_t  rec[19] = {0x00, 0x01, 0x02, 0x03, 0xFF, 0xFF, 0x9C, 0x00, 0x00, 0x64, 0x80, 0x00, 0x00, 0xF5, 0x3A, 0xB7, 0x2C, 0x85, 0xE3};
+        DataSetColumns c;
+        decodeDataSets(rec, 1, c);
+
+        Assert::AreEqual(size_t(1), c.size());
+        Assert::AreEqual(uint32_t(0x00010203), c.timestamp_us[0]);
+        Assert::AreEqual(int32_t(-100), c.x[0]);
+        Assert::AreEqual(int32_t(100), c.y[0]);
+        Assert::AreEqual(int32_t(-8388608), c.z[0]);
+        Assert::AreEqual(uint32_t(0xF53AB72C), c.statusWord[0]);
+        Assert::AreEqual(uint8_t(5), c.ledId[0]);
+        Assert::AreEqual(uint8_t(3), c.tcmId[0]);
+        Assert::AreEqual(uint8_t(1), c.endOfFrame[0]);
+        Assert::AreEqual(uint8_t(7), c.coordStatus[0]);
+        Assert::AreEqual(uint8_t(5), c.ambientLight[0]);
+        Assert::AreEqual(uint8_t(1), c.rightEyeSignal[0]);
+        Assert::AreEqual(uint8_t(0xA), c.rightEyeStatus[0]);
+        Assert::AreEqual(uint8_t(1), c.centerEyeSignal[0]);
+        Assert::AreEqual(uint8_t(7), c.centerEyeStatus[0]);
+        Assert::AreEqual(uint8_t(0), c.leftEyeSignal[0]);
+        Assert::AreEqual(uint8_t(0xC), c.leftEyeStatus[0]);
+        Assert::AreEqual(uint8_t(41), c.triggerIndex[0]); // TTT:TTT = 101:001
+    }
+
+    TEST_METHOD(KernelsMatchScalar)
+    {
+        // Counts around the 4- and 8-record step sizes exercise the scalar tail
+        for (size_t count : {1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 1000})
+        {
+            std::vector<uint8_t> bytes = RandomRecords(count, static_cast<unsigned>(count));
+
+            DataSetColumns reference;
+            decodeDataSets(bytes.data(), count, reference, DataSetKernel::Scalar);
+
+            for (DataSetKernel kernel : {DataSetKernel::Sse41, DataSetKernel::Avx2})
+            {
+                DataSetColumns simd;
+                decodeDataSets(bytes.data(), count, simd, kernel);
+                Assert::IsTrue(SameColumns(reference, simd));
+            }
+        }
+    }
+
+    TEST_METHOD(AppendsToExistingColumns)
+    {
+        std::vector<uint8_t> bytes = RandomRecords(12, 42);
+
+        DataSetColumns whole, parts;
+        decodeDataSets(bytes.data(), 12, whole);
+        decodeDataSets(bytes.data(), 5, parts);
+        decodeDataSets(bytes.data() + 5 * 19, 7, parts);
+        Assert::IsTrue(SameColumns(whole, parts));
+    }
+};
@@ -0,0 +1,180 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/DmsLogIndex.h"
+#include "../ConvertToJson/DmsLogReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Fresh directory holding a copy of one of the sample captures in Data/
+static fs::path CopyCapture(const char *name, const char *capture)
+{
+    fs::path dir = fs::temp_directory_path() / name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    fs::copy_file(fs::path(__FILE__).parent_path().parent_path() / "Data" / capture, dir / capture);
+    return dir / capture;
+}
+
+static std::vector<uint8_t> ReadBytes(const fs::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static bool SameRecord(const IrpRecord &a, const IrpRecord &b)
+{
+    return a.fileOffset == b.fileOffset && a.timestamp == b.timestamp && a.isTx() == b.isTx() && a.serialData.size() == b.serialData.size();
+}
+
+// ===========================================================================
+// Index sidecar and time-based reader access
+// ===========================================================================
+
+TEST_CLASS(DmsLogIndexTests)
+{
+  public:
+    TEST_METHOD(SidecarRoundTrip)
+    {
+        fs::path dir = fs::temp_directory_path() / "phx_index_roundtrip";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        std::string path = DmsLogIndex::sidecarPath((dir / "a.dmslog8").string());
+        Assert::AreEqual((dir / "a.dmsidx").string(), path);
+
+        DmsLogIndex index;
+        index.add(100, 5000, true);
+        index.add(200, 5000, false);
+        index.add(300, 7000, false);
+        Assert::IsTrue(index.save(path, 1 << 20, 42));
+
+        DmsLogIndex loaded;
+        Assert::IsTrue(loaded.load(path, 1 << 20, 42));
+        Assert::AreEqual(size_t(3), loaded.entries().size());
+        Assert::AreEqual(uint64_t(200), loaded.entries()[1].offset);
+        Assert::AreEqual(uint64_t(7000), loaded.entries()[2].timestamp);
+        Assert::AreEqual(uint8_t(1), loaded.entries()[0].isTx);
+        Assert::IsTrue(loaded.isSorted());
+        Assert::AreEqual(size_t(0), loaded.lowerBound(5000));
+        Assert::AreEqual(size_t(2), loaded.lowerBound(5001));
+        Assert::AreEqual(size_t(3), loaded.lowerBound(7001));
+        fs::remove_all(dir);
+    }
+
+    TEST_METHOD(StaleSidecarIsIgnored)
+    {
+        fs::path dir = fs::temp_directory_path() / "phx_index_stale";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        std::string path = (dir / "a.dmsidx").string();
+
+        DmsLogIndex index;
+        index.add(100, 5000, true);
+        Assert::IsTrue(index.save(path, 1 << 20, 42));
+
+        DmsLogIndex loaded;
+        Assert::IsFalse(loaded.load(path, (1 << 20) + 1, 42)); // capture grew
+        Assert::IsFalse(loaded.load(path, 1 << 20, 43));       // capture rewritten
+        Assert::IsTrue(loaded.entries().empty());
+
+        // Another sidecar version
+        std::vector<uint8_t> raw = ReadBytes(path);
+        raw[8] ^= 0xFF;
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char *>(raw.data()), static_cast<std::streamsize>(raw.size()));
+        Assert::IsFalse(loaded.load(path, 1 << 20, 42));
+
+        // Truncated entries
+        raw[8] ^= 0xFF;
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char *>(raw.data()), static_cast<std::streamsize>(raw.size() - 1));
+        Assert::IsFalse(loaded.load(path, 1 << 20, 42));
+        fs::remove_all(dir);
+    }
+
+    TEST_METHOD(ReaderBuildsAndReusesSidecar)
+    {
+        fs::path    capture = CopyCapture("phx_index_reader", "detect_start_stop.dmslog8");
+        std::string sidecar = DmsLogIndex::sidecarPath(capture.string());
+
+        DmsLogReader reader;
+        Assert::IsTrue(reader.open(capture.string()));
+        Assert::IsTrue(reader.loadIndex());
+        Assert::IsTrue(fs::exists(sidecar));
+
+        // A second reader loads the sidecar instead of rewriting it
+        std::vector<uint8_t> built = ReadBytes(sidecar);
+        auto                 time  = fs::last_write_time(sidecar) - std::chrono::hours(1);
+        fs::last_write_time(sidecar, time);
+        DmsLogReader again;
+        Assert::IsTrue(again.open(capture.string()));
+        Assert::IsTrue(again.loadIndex());
+        Assert::IsTrue(fs::last_write_time(sidecar) == time);
+
+        // Touching the capture makes the sidecar stale: it is rebuilt, with the same entries
+        fs::last_write_time(capture, fs::last_write_time(capture) + std::chrono::hours(1));
+        DmsLogReader touched;
+        Assert::IsTrue(touched.open(capture.string()));
+        Assert::IsTrue(touched.loadIndex());
+        Assert::IsTrue(fs::last_write_time(sidecar) != time);
+        std::vector<uint8_t> rebuilt = ReadBytes(sidecar);
+        Assert::AreEqual(built.size(), rebuilt.size());
+        Assert::IsTrue(std::equal(built.begin() + 32, built.end(), rebuilt.begin() + 32)); // all but the capture time
+        fs::remove_all(capture.parent_path());
+    }
+
+    TEST_METHOD(SeekAndRangeMatchFullRead)
+    {
+        fs::path     capture = CopyCapture("phx_index_range", "detect_start_stop.dmslog8");
+        DmsLogReader reader;
+        Assert::IsTrue(reader.open(capture.string()));
+
+        std::vector<IrpRecord> all;
+        Assert::IsTrue(reader.readRecords(all));
+        Assert::IsTrue(all.size() > 100);
+
+        const uint64_t         t0 = all[all.size() / 4].timestamp;
+        const uint64_t         t1 = all[all.size() / 2].timestamp;
+        std::vector<IrpRecord> expected;
+        for (const auto &rec : all)
+        {
+            if (rec.timestamp >= t0 && rec.timestamp < t1)
+                expected.push_back(rec);
+        }
+
+        std::vector<IrpRecord> range;
+        Assert::IsTrue(reader.readRange(t0, t1, range));
+        Assert::AreEqual(expected.size(), range.size());
+        for (size_t i = 0; i < range.size(); ++i)
+            Assert::IsTrue(SameRecord(expected[i], range[i]));
+
+        // The cursor starts at the first record at or after t0 and walks on in file order
+        RecordCursor cursor = reader.seek(t0);
+        IrpRecord    rec;
+        size_t       first = 0;
+        while (all[first].timestamp < t0)
+            ++first;
+        for (size_t i = first; i < first + 10; ++i)
+        {
+            Assert::IsTrue(cursor.next(rec));
+            Assert::IsTrue(SameRecord(all[i], rec));
+        }
+
+        // Past the end of the capture
+        const uint64_t end = all.back().timestamp + 1;
+        range.clear();
+        Assert::IsFalse(reader.readRange(end, end + 1000, range));
+        RecordCursor past = reader.seek(end);
+        Assert::IsFalse(past.next(rec));
+        fs::remove_all(capture.parent_path());
+    }
+};
@@ -0,0 +1,137 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/DmsLogReader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static fs::path DataDir()
+{
+    return fs::path(__FILE__).parent_path().parent_path() / "Data";
+}
+
+static bool SameRecords(const std::vector<IrpRecord> &a, const std::vector<IrpRecord> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].fileOffset != b[i].fileOffset || a[i].timestamp != b[i].timestamp || a[i].isTx() != b[i].isTx() ||
+            a[i].serialData.size() != b[i].serialData.size() ||
+            !std::equal(a[i].serialData.begin(), a[i].serialData.end(), b[i].serialData.begin()))
+            return false;
+    }
+    return true;
+}
+
+// Parses `path` serially and in parallel with small ranges, so that the range boundaries fall
+// inside records and every range resyncs and is stitched
+static void CheckParallelMatchesSerial(const fs::path &path)
+{
+    DmsLogReader reader;
+    Assert::IsTrue(reader.open(path.string()));
+
+    std::vector<IrpRecord> serial;
+    const bool             found = reader.readRecords(serial);
+    for (uint64_t chunkBytes : {uint64_t(256), uint64_t(4096), uint64_t(65536)})
+    {
+        for (unsigned threads : {1u, 2u, 3u, 8u, 64u})
+        {
+            std::vector<IrpRecord> parallel;
+            Assert::AreEqual(found, reader.readRecordsParallel(parallel, threads, chunkBytes));
+            Assert::IsTrue(SameRecords(serial, parallel));
+        }
+    }
+}
+
+// ===========================================================================
+// Parallel record parsing
+// ===========================================================================
+
+TEST_CLASS(DmsLogReaderTests)
+{
+  public:
+    TEST_METHOD(ParallelParseMatchesSerial)
+    {
+        size_t captures = 0;
+        for (const auto &entry : fs::directory_iterator(DataDir()))
+        {
+            if (entry.path().extension() == ".dmslog8")
+            {
+                CheckParallelMatchesSerial(entry.path());
+                ++captures;
+            }
+        }
+        Assert::IsTrue(captures > 0);
+    }
+
+    TEST_METHOD(ParallelParseMatchesSerialOffTheWalk)
+    {
+        fs::path dir = fs::temp_directory_path() / "phx_reader_nested";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+        fs::path path = dir / "nested.dmslog8";
+
+        const fs::path         source = DataDir() / "detect_start_stop.dmslog8";
+        std::ifstream          in(source, std::ios::binary);
+        std::vector<uint8_t>   bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<IrpRecord> original;
+        {
+            DmsLogReader reader;
+            Assert::IsTrue(reader.open(source.string()));
+            Assert::IsTrue(reader.readRecords(original));
+        }
+
+        // The capture header, then each serial record followed by a non-serial record holding a copy of
+        // it and a non-serial record that runs 8 bytes past its end. A range that starts in such a
+        // record resyncs onto the copy, off the serial walk (which skips the record whole), and then
+        // jumps over the next serial record; the stitching has to drop the copy and catch that one up.
+        std::vector<uint8_t> raw(bytes.begin(), bytes.begin() + original[0].fileOffset);
+        auto                 retype = [&](size_t header, size_t size)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                raw[header + 8 + i]  = static_cast<uint8_t>(size >> (8 * i)); // record size
+                raw[header + 12 + i] = i == 0 ? 2 : 0;                         // type 2 (not serial data), request
+            }
+        };
+        for (const IrpRecord &rec : original)
+        {
+            auto at = bytes.begin() + rec.fileOffset;
+            raw.insert(raw.end(), at, at + rec.recordSize);
+
+            const size_t host = raw.size();
+            raw.insert(raw.end(), at, at + 24);
+            raw.insert(raw.end(), at, at + rec.recordSize);
+            const size_t overrun = raw.size();
+            raw.insert(raw.end(), at, at + 24);
+            raw.insert(raw.end(), 24, uint8_t(0));
+            retype(host, raw.size() - host);
+            retype(overrun, raw.size() - overrun + 8);
+        }
+
+        // Overwritten stretches send both walks through the resync
+        std::mt19937 rng(7);
+        for (size_t at : {raw.size() / 5, raw.size() / 2})
+        {
+            for (size_t i = at; i < at + 700; ++i)
+                raw[i] = static_cast<uint8_t>(rng());
+        }
+        std::fill(raw.begin() + raw.size() * 4 / 5, raw.begin() + raw.size() * 4 / 5 + 300, uint8_t(0));
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char *>(raw.data()), static_cast<std::streamsize>(raw.size()));
+
+        CheckParallelMatchesSerial(path);
+        fs::remove_all(dir);
+    }
+};
@@ -0,0 +1,170 @@
+#include "CppUnitTest.h"
+#include "../Detect/Measure_HHD.h"
+#include "../ConvertToJson/FrameAssembler.h"
+#include "../ConvertToJson/PhoenixDecoder.h"
+
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using Assembler = FrameAssembler<HHD_MeasurementSample>;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static HHD_MeasurementSample Sample(uint8_t tcm, uint8_t led, uint32_t t, bool eof = false)
+{
+    HHD_MeasurementSample s = {};
+    s.tcmId                 = tcm;
+    s.ledId                 = led;
+    s.timestamp_us          = t;
+    s.endOfFrame            = eof;
+    return s;
+}
+
+// Raw 19-byte data set as the tracker sends it
+static void AppendDataSet(std::vector<uint8_t> &stream, uint8_t tcm, uint8_t led, uint32_t t, bool eof = false)
+{
+    uint8_t r[19] = {static_cast<uint8_t>(t >> 24), static_cast<uint8_t>(t >> 16), static_cast<uint8_t>(t >> 8), static_cast<uint8_t>(t)};
+    r[13]         = eof ? 0x80 : 0x00; // status word bit 31: end of frame
+    r[17]         = static_cast<uint8_t>(0x80 | led);
+    r[18]         = static_cast<uint8_t>(0xE0 | tcm);
+    stream.insert(stream.end(), r, r + sizeof(r));
+}
+
+struct CollectedFrame
+{
+    std::vector<uint8_t>  present;
+    std::vector<uint32_t> timestamps;
+    size_t                unexpected;
+    bool                  complete;
+};
+
+static std::vector<CollectedFrame> Run(Assembler &assembler, const std::vector<HHD_MeasurementSample> &samples)
+{
+    std::vector<CollectedFrame> frames;
+    Assembler::FrameHandler     collect = [&](const Assembler::Frame &f)
+    {
+        CollectedFrame c{f.present, {}, f.unexpected, f.complete};
+        for (const auto &s : f.samples)
+            c.timestamps.push_back(s.timestamp_us);
+        frames.push_back(c);
+    };
+    for (const auto &s : samples)
+        assembler.add(s, collect);
+    assembler.flush(collect);
+    return frames;
+}
+
+// ===========================================================================
+// Frame assembly
+// ===========================================================================
+
+TEST_CLASS(FrameAssemblerTests)
+{
+  public:
+    TEST_METHOD(SlotsFollowTfsOrder)
+    {
+        std::vector<HHD_MarkerEntry> tfs = {{1, 3, 1}, {2, 1, 2}, {1, 1, 1}};
+        Assembler                    assembler(tfs);
+
+        const auto &slots = assembler.slots();
+        Assert::AreEqual(size_t(4), slots.size());
+        Assert::AreEqual(uint8_t(3), slots[0].ledId);
+        Assert::AreEqual(uint8_t(2), slots[1].tcmId);
+        Assert::AreEqual(uint8_t(0), slots[1].flashIndex);
+        Assert::AreEqual(uint8_t(1), slots[2].flashIndex);
+        Assert::AreEqual(uint8_t(1), slots[3].ledId);
+    }
+
+    TEST_METHOD(CompleteFramesInAnyArrivalOrder)
+    {
+        std::vector<HHD_MarkerEntry> tfs = {{1, 1, 1}, {1, 2, 1}, {2, 1, 2}};
+        Assembler                    assembler(tfs);
+
+        auto frames = Run(assembler, {Sample(2, 1, 10), Sample(1, 2, 11), Sample(2, 1, 12), Sample(1, 1, 13, true), // frame 1
+                                      Sample(1, 1, 20), Sample(1, 2, 21), Sample(2, 1, 22), Sample(2, 1, 23, true)});
+
+        Assert::AreEqual(size_t(2), frames.size());
+        Assert::IsTrue(frames[0].complete);
+        Assert::IsTrue(frames[0].present == std::vector<uint8_t>{1, 1, 1, 1});
+        Assert::IsTrue(frames[0].timestamps == std::vector<uint32_t>{13, 11, 10, 12}); // flashes of (2,1) in arrival order
+        Assert::IsTrue(frames[1].timestamps == std::vector<uint32_t>{20, 21, 22, 23});
+    }
+
+    TEST_METHOD(MissingMarkersAreFlagged)
+    {
+        std::vector<HHD_MarkerEntry> tfs = {{1, 1, 1}, {1, 2, 1}, {1, 3, 1}};
+        Assembler                    assembler(tfs);
+
+        auto frames = Run(assembler, {Sample(1, 1, 10), Sample(1, 3, 12, true)});
+
+        Assert::AreEqual(size_t(1), frames.size());
+        Assert::IsTrue(frames[0].present == std::vector<uint8_t>{1, 0, 1});
+    }
+
+    TEST_METHOD(LostEndOfFrameStartsNextFrame)
+    {
+        std::vector<HHD_MarkerEntry> tfs = {{1, 1, 1}, {1, 2, 1}};
+        Assembler                    assembler(tfs);
+
+        // The end-of-frame sample of the first frame (1,2) was lost
+        auto frames = Run(assembler, {Sample(1, 1, 10), Sample(1, 1, 20), Sample(1, 2, 21, true)});
+
+        Assert::AreEqual(size_t(2), frames.size());
+        Assert::IsFalse(frames[0].complete);
+        Assert::IsTrue(frames[0].present == std::vector<uint8_t>{1, 0});
+        Assert::IsTrue(frames[1].complete);
+        Assert::IsTrue(frames[1].present == std::vector<uint8_t>{1, 1});
+    }
+
+    TEST_METHOD(UnexpectedMarkersAreCounted)
+    {
+        std::vector<HHD_MarkerEntry> tfs = {{1, 1, 1}};
+        Assembler                    assembler(tfs);
+
+        auto frames = Run(assembler, {Sample(3, 7, 10), Sample(1, 1, 11, true)});
+
+        Assert::AreEqual(size_t(1), frames.size());
+        Assert::AreEqual(size_t(1), frames[0].unexpected);
+        Assert::IsTrue(frames[0].present == std::vector<uint8_t>{1});
+    }
+
+    TEST_METHOD(AssemblesDecodedDataSets)
+    {
+        // Offline: data sets decoded from a capture's RX stream, grouped with the same TFS
+        std::vector<uint8_t> rx;
+        AppendDataSet(rx, 1, 1, 10);
+        AppendDataSet(rx, 1, 2, 11, true);
+        AppendDataSet(rx, 1, 2, 21, true); // (1,1) missing
+        AppendDataSet(rx, 1, 1, 30);
+        AppendDataSet(rx, 1, 2, 31, true);
+
+        PhoenixDecoder            decoder;
+        std::vector<PhoenixFrame> decoded;
+        decoder.decode({}, {{100, ByteView(rx.data(), rx.size())}}, decoded);
+
+        std::vector<HHD_MarkerEntry>                 tfs = {{1, 1, 1}, {1, 2, 1}};
+        FrameAssembler<PhoenixDataSet>               assembler(tfs);
+        std::vector<std::vector<uint8_t>>            present;
+        std::vector<uint32_t>                        starts;
+        FrameAssembler<PhoenixDataSet>::FrameHandler collect = [&](const AssembledFrame<PhoenixDataSet> &f)
+        {
+            present.push_back(f.present);
+            starts.push_back(f.timestamp_us);
+        };
+        for (const auto &frame : decoded)
+        {
+            if (frame.type == PhoenixFrameType::DataSet)
+                assembler.add(frame.dataSet, collect);
+        }
+        assembler.flush(collect);
+
+        Assert::AreEqual(size_t(3), present.size());
+        Assert::IsTrue(present[0] == std::vector<uint8_t>{1, 1});
+        Assert::IsTrue(present[1] == std::vector<uint8_t>{0, 1});
+        Assert::IsTrue(present[2] == std::vector<uint8_t>{1, 1});
+        Assert::IsTrue(starts == std::vector<uint32_t>{10, 21, 30});
+    }
+};
@@ -0,0 +1,76 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/JsonBuffer.h"
+
+#include <sstream>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// 2024-03-05T12:34:56Z as FILETIME, plus `us` microseconds
+static uint64_t FileTime(uint32_t extraSeconds, uint32_t us)
+{
+    const uint64_t kUnixEpochDiff = 116444736000000000ULL;
+    uint64_t       unixSeconds    = 1709642096ULL + extraSeconds;
+    return kUnixEpochDiff + unixSeconds * 10000000ULL + uint64_t(us) * 10;
+}
+
+// ===========================================================================
+// JSON buffer
+// ===========================================================================
+
+TEST_CLASS(JsonBufferTests)
+{
+  public:
+    TEST_METHOD(NumbersAndHex)
+    {
+        std::ostringstream out;
+        {
+            JsonBuffer buffer(out, 16); // smaller than the text, forces block flushes
+            buffer << "n=" << size_t(1234567890123) << ' ' << -42 << ' ';
+            buffer.writeHex32(0x00C0FFEE);
+            buffer << ' ';
+            const uint8_t bytes[] = {0x00, 0x7F, 0xAB};
+            buffer.writeHex(bytes, sizeof(bytes));
+        }
+        Assert::IsTrue(out.str() == "n=1234567890123 -42 00c0ffee 007fab");
+    }
+
+    TEST_METHOD(HundredthsMatchFixedTwoDecimals)
+    {
+        std::ostringstream out;
+        {
+            JsonBuffer buffer(out);
+            for (int32_t v : {0, 5, -5, 100, -100, 123456, -8388608, 8388607})
+            {
+                buffer.writeHundredths(v);
+                buffer << ' ';
+            }
+        }
+        Assert::IsTrue(out.str() == "0.00 0.05 -0.05 1.00 -1.00 1234.56 -83886.08 83886.07 ");
+    }
+
+    TEST_METHOD(EscapesControlCharacters)
+    {
+        std::ostringstream out;
+        {
+            JsonBuffer buffer(out);
+            buffer << JsonEscaped{std::string_view("a\"b\\c\nd\x01", 8)};
+        }
+        Assert::IsTrue(out.str() == "a\\\"b\\\\c\\nd\\u0001");
+    }
+
+    TEST_METHOD(TimestampAcrossSecondRollover)
+    {
+        Iso8601Formatter formatter;
+        char             buf[Iso8601Formatter::kMaxLength];
+
+        Assert::IsTrue(std::string(buf, formatter.format(FileTime(0, 999999), buf)) == "2024-03-05T12:34:56.999999Z");
+        Assert::IsTrue(std::string(buf, formatter.format(FileTime(1, 1), buf)) == "2024-03-05T12:34:57.000001Z");
+        Assert::IsTrue(std::string(buf, formatter.format(FileTime(0, 0), buf)) == "2024-03-05T12:34:56.000000Z");
+        Assert::IsTrue(std::string(buf, formatter.format(0, buf)) == "1970-01-01T00:00:00Z");
+    }
+};
@@ -0,0 +1,342 @@
+#include "CppUnitTest.h"
+#include "../Detect/Measure_HHD.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+// Scripted tracker: acknowledges each command with a 19-byte Message Set echoing its code and
+// index, except the software reset and START (the device sends none for those). Command
+// number `errorAt` (counted from 0) is answered with an error message instead.
+// The receive queue is locked so that an acquisition thread can read while the test injects.
+// unplug() makes the port fail like a removed USB adapter: waits fail and the port closes.
+// A non-empty `stream` is a tracker that never stops sending data sets.
+class FakeTrackerPort : public SerialTransport
+{
+  public:
+    bool open(const std::string &) override { return m_open = true; }
+    void close() override { m_open = false; }
+    bool isOpen() const override { return m_open; }
+    bool setHandshake(uint16_t) override { return true; }
+    bool setBaudRate(uint32_t) override { return true; }
+    bool setLineControl8N1() override { return true; }
+    bool setTimeouts(const SerialTimeouts &) override { return true; }
+
+    bool write(const uint8_t *data, size_t size) override
+    {
+        if (!m_open || size < 6 || data[0] != '&')
+            return false;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        commands.push_back(static_cast<char>(data[1]));
+        if (acknowledge && data[1] != '`' && data[1] != '3')
+        {
+            uint8_t ack[19] = {data[1], data[2]};
+            ack[14]         = static_cast<int>(commands.size()) - 1 == errorAt ? 0x15 : 0x06;
+            m_rx.insert(m_rx.end(), ack, ack + sizeof(ack));
+            mostQueued = std::max(mostQueued, m_rx.size() / sizeof(ack));
+        }
+        return true;
+    }
+
+    bool read(uint8_t *data, size_t size, size_t &bytesRead) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        keepStreaming();
+        bytesRead = std::min(size, m_rx.size());
+        std::copy(m_rx.begin(), m_rx.begin() + bytesRead, data);
+        m_rx.erase(m_rx.begin(), m_rx.begin() + bytesRead);
+        return true;
+    }
+
+    size_t bytesAvailable() override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        keepStreaming();
+        return m_rx.size();
+    }
+
+    // Scripted bytes arrive in whole injections: a short nap stands in for the receive event
+    bool waitForBytes(size_t count, int timeoutMs) override
+    {
+        if (!m_open)
+            return false;
+        if (bytesAvailable() >= count)
+            return true;
+        if (timeoutMs > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return bytesAvailable() >= count;
+    }
+
+    void purge(bool rx, bool) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (rx)
+            m_rx.clear();
+    }
+
+    bool setDtr(bool) override { return true; }
+    bool setRts(bool) override { return true; }
+    bool configSize(uint32_t &size) override { return (size = 0, false); }
+    int  lastError() const override { return 0; }
+
+    // Bytes "received" from the tracker
+    void inject(const uint8_t *data, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rx.insert(m_rx.end(), data, data + size);
+    }
+
+    void unplug() { m_open = false; }
+
+    std::string          commands;       // command codes in the order they were written
+    bool                 acknowledge = true;
+    int                  errorAt     = -1;
+    size_t               mostQueued  = 0; // most unread answers at once (commands in flight)
+    std::vector<uint8_t> stream;          // record received over and over while the queue runs short
+
+  private:
+    void keepStreaming()
+    {
+        if (m_rx.size() < stream.size())
+            m_rx.insert(m_rx.end(), stream.begin(), stream.end());
+    }
+
+    std::mutex          m_mutex;
+    std::deque<uint8_t> m_rx;
+    std::atomic<bool>   m_open{true};
+};
+
+// One 19-byte data set for marker `led` on TCM `tcm`, X = `x` hundredths of a millimetre
+static std::vector<uint8_t> DataSet(uint32_t timestamp, int32_t x, uint8_t tcm, uint8_t led)
+{
+    std::vector<uint8_t> r(19, 0);
+    r[0]  = static_cast<uint8_t>(timestamp >> 24);
+    r[1]  = static_cast<uint8_t>(timestamp >> 16);
+    r[2]  = static_cast<uint8_t>(timestamp >> 8);
+    r[3]  = static_cast<uint8_t>(timestamp);
+    r[4]  = static_cast<uint8_t>(x >> 16);
+    r[5]  = static_cast<uint8_t>(x >> 8);
+    r[6]  = static_cast<uint8_t>(x);
+    r[17] = static_cast<uint8_t>(0x80 | led);
+    r[18] = static_cast<uint8_t>(0xE0 | tcm);
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+TEST_CLASS(MeasureSessionTests)
+{
+  public:
+    TEST_METHOD(RunsSessionOverTransport)
+    {
+        FakeTrackerPort              port;
+        std::vector<HHD_MarkerEntry> markers = {{1, 1, 1}, {2, 3, 1}};
+
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, markers, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+        Assert::IsTrue(port.commands == "5`vLOYU^QpppoXr:S3");
+        Assert::IsTrue(port.mostQueued > 1); // configuration is pipelined
+
+        // A record split across two reads is completed by the second fetch
+        std::vector<uint8_t> first = DataSet(1000, 12345, 1, 1);
+        std::vector<uint8_t> last  = DataSet(1115, -250, 2, 3);
+        port.inject(first.data(), first.size());
+        port.inject(last.data(), 7);
+
+        std::vector<HHD_MeasurementSample> samples;
+        Assert::IsTrue(WaitForMeasurements(session, 0));
+        Assert::AreEqual(1, FetchMeasurements(session, samples));
+        Assert::IsFalse(WaitForMeasurements(session, 0));
+        Assert::AreEqual(0, FetchMeasurements(session, samples));
+        port.inject(last.data() + 7, 11);
+        Assert::IsFalse(WaitForMeasurements(session, 0));
+        port.inject(last.data() + 18, 1);
+        Assert::IsTrue(WaitForMeasurements(session, 0));
+        Assert::AreEqual(1, FetchMeasurements(session, samples));
+
+        Assert::AreEqual(size_t(2), samples.size());
+        Assert::AreEqual(1000u, samples[0].timestamp_us);
+        Assert::AreEqual(123.45, samples[0].x_mm, 1e-9);
+        Assert::AreEqual(2, static_cast<int>(samples[1].tcmId));
+        Assert::AreEqual(3, static_cast<int>(samples[1].ledId));
+        Assert::AreEqual(-2.5, samples[1].x_mm, 1e-9);
+
+        Assert::IsTrue(StopMeasurement(session));
+        Assert::IsTrue(port.commands.back() == '5');
+    }
+
+    TEST_METHOD(FetchesIntoFixedBuffer)
+    {
+        FakeTrackerPort         port;
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+
+        // Five records, the last one split: the buffer takes two at a time, the rest stays queued
+        std::vector<uint8_t> stream;
+        for (uint32_t i = 0; i < 5; ++i)
+        {
+            std::vector<uint8_t> record = DataSet(1000 + i, 0, 1, 1);
+            stream.insert(stream.end(), record.begin(), record.end());
+        }
+        port.inject(stream.data(), stream.size() - 5);
+
+        HHD_MeasurementSample samples[2] = {};
+        Assert::AreEqual(2, FetchMeasurements(session, samples, 2));
+        Assert::AreEqual(1001u, samples[1].timestamp_us);
+        Assert::IsTrue(WaitForMeasurements(session, 0));
+        Assert::AreEqual(2, FetchMeasurements(session, samples, 2));
+        Assert::AreEqual(1003u, samples[1].timestamp_us);
+        Assert::IsFalse(WaitForMeasurements(session, 0));
+        Assert::AreEqual(0, FetchMeasurements(session, samples, 2));
+
+        port.inject(stream.data() + stream.size() - 5, 5);
+        Assert::AreEqual(1, FetchMeasurements(session, samples, 2));
+        Assert::AreEqual(1004u, samples[0].timestamp_us);
+
+        Assert::IsTrue(StopMeasurement(session));
+    }
+
+    TEST_METHOD(DecodesAcrossReceiveRingWrap)
+    {
+        FakeTrackerPort         port;
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+
+        // 10000 records (190000 bytes, several laps of the receive ring) in chunks of 1000 bytes,
+        // so records straddle both the reads and the ring's wrap
+        std::vector<uint8_t> stream;
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            std::vector<uint8_t> record = DataSet(i, static_cast<int32_t>(i), 1, 1);
+            stream.insert(stream.end(), record.begin(), record.end());
+        }
+
+        std::vector<HHD_MeasurementSample> samples;
+        for (size_t pos = 0; pos < stream.size(); pos += 1000)
+        {
+            port.inject(stream.data() + pos, std::min<size_t>(1000, stream.size() - pos));
+            FetchMeasurements(session, samples);
+        }
+
+        Assert::AreEqual(size_t(10000), samples.size());
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            Assert::AreEqual(i, samples[i].timestamp_us);
+            Assert::AreEqual(i / 100.0, samples[i].x_mm, 1e-9);
+        }
+
+        Assert::IsTrue(StopMeasurement(session));
+    }
+
+    TEST_METHOD(AcquisitionThreadQueuesSamples)
+    {
+        FakeTrackerPort         port;
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+        Assert::IsTrue(StartAcquisitionThread(session, 8));
+        Assert::IsFalse(StartAcquisitionThread(session, 8));
+
+        // Nothing is read while the consumer is away: 20 samples into a ring of 8
+        std::vector<uint8_t> stream;
+        for (uint32_t i = 0; i < 20; ++i)
+        {
+            std::vector<uint8_t> record = DataSet(1000 + i, 0, 1, 1);
+            stream.insert(stream.end(), record.begin(), record.end());
+        }
+        port.inject(stream.data(), stream.size());
+
+        std::vector<HHD_MeasurementSample> samples;
+        Assert::IsTrue(WaitForMeasurements(session, 1000));
+        while (GetAcquisitionStats(session).samplesAcquired + GetAcquisitionStats(session).samplesDropped < 20)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        FetchMeasurements(session, samples);
+
+        HHD_AcquisitionStats stats = GetAcquisitionStats(session);
+        Assert::AreEqual(size_t(8), stats.ringCapacity);
+        Assert::AreEqual(uint64_t(8), stats.samplesAcquired);
+        Assert::AreEqual(uint64_t(12), stats.samplesDropped);
+        Assert::AreEqual(size_t(8), samples.size());
+        Assert::AreEqual(1000u, samples.front().timestamp_us);
+        Assert::AreEqual(1007u, samples.back().timestamp_us);
+
+        // Once drained, new samples flow again
+        std::vector<uint8_t> record = DataSet(2000, 0, 1, 1);
+        port.inject(record.data(), record.size());
+        Assert::IsTrue(WaitForMeasurements(session, 1000));
+        samples.clear();
+        Assert::AreEqual(1, FetchMeasurements(session, samples));
+        Assert::AreEqual(2000u, samples[0].timestamp_us);
+
+        Assert::IsTrue(StopMeasurement(session));
+    }
+
+    TEST_METHOD(AcquisitionStopsWhenPortLost)
+    {
+        FakeTrackerPort         port;
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+        Assert::IsTrue(StartAcquisitionThread(session, 8));
+
+        port.unplug();
+        Assert::IsTrue(WaitForMeasurements(session, 1000));
+        Assert::IsTrue(GetAcquisitionStats(session).portLost);
+
+        std::vector<HHD_MeasurementSample> samples;
+        Assert::AreEqual(0, FetchMeasurements(session, samples));
+        Assert::IsFalse(StopMeasurement(session));
+    }
+
+    TEST_METHOD(FailsWithoutAcknowledge)
+    {
+        FakeTrackerPort port;
+        port.acknowledge = false;
+
+        Assert::IsNull(StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0));
+
+        // The pipelined burst sends a window of commands and stops at the first missing ACK;
+        // the sequential retry then stops at that same command
+        Assert::IsTrue(port.commands == "5`vLOYU^Qpv");
+    }
+
+    TEST_METHOD(GivesUpOnStaleDataStream)
+    {
+        // A tracker still running a retained TFS after the reset: the receive queue never empties
+        FakeTrackerPort port;
+        port.acknowledge = false;
+        port.stream      = DataSet(1000, 0, 1, 1);
+
+        const auto start = std::chrono::steady_clock::now();
+        Assert::IsNull(StartMeasurement(port, 10, {{1, 1, 1}}, /*resetTimeoutMs=*/0));
+        Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+        Assert::IsTrue(port.commands == "5`vLOYU^Qpv");
+    }
+
+    TEST_METHOD(RetriesConfigurationSequentially)
+    {
+        FakeTrackerPort port;
+        port.errorAt = 11; // the second TFS append
+
+        HHD_MeasurementSession *session = StartMeasurement(port, 10, {{1, 1, 1}, {2, 3, 1}, {1, 2, 1}}, /*resetTimeoutMs=*/0);
+        Assert::IsNotNull(session);
+
+        // The burst stops at the error; the whole group is sent again, from the timing command
+        const std::string retry = "vLOYU^QppppoXr:S3";
+        Assert::IsTrue(port.commands.size() > 2 + retry.size());
+        Assert::IsTrue(port.commands.compare(port.commands.size() - retry.size(), retry.size(), retry) == 0);
+
+        Assert::IsTrue(StopMeasurement(session));
+    }
+};
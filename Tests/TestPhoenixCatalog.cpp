@@ -0,0 +1,49 @@
+#include "CppUnitTest.h"
+#include "../ConvertToJson/PhoenixCatalog.h"
+
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ===========================================================================
+// Command catalog
+// ===========================================================================
+
+TEST_CLASS(PhoenixCatalogTests)
+{
+  public:
+    TEST_METHOD(CodesAreUnique)
+    {
+        std::set<char> codes;
+        for (const auto &info : PhoenixCatalog::kCommands)
+            Assert::IsTrue(codes.insert(info.code).second);
+    }
+
+    TEST_METHOD(ParameterLayoutsMatchMeasurementCommands)
+    {
+        const PhoenixCommandInfo *timing = PhoenixCatalog::findCommand('v');
+        Assert::IsTrue(timing != nullptr);
+        Assert::AreEqual(uint8_t(4), timing->bytesPerParam);
+        Assert::AreEqual(uint8_t(2), timing->numParams);
+        Assert::IsTrue(timing->bigEndian);
+
+        Assert::AreEqual(uint8_t(2), PhoenixCatalog::findCommand('O')->bytesPerParam);
+        Assert::AreEqual(uint8_t(8), PhoenixCatalog::findCommand('X')->numParams);
+        Assert::AreEqual(uint8_t(0), PhoenixCatalog::findCommand('3')->bytesPerParam);
+    }
+
+    TEST_METHOD(UnknownCodesHaveNames)
+    {
+        Assert::IsTrue(PhoenixCatalog::findCommand('!') == nullptr);
+        Assert::IsTrue(PhoenixCatalog::commandName('!') == "Unknown Command '!'");
+        Assert::IsTrue(PhoenixCatalog::commandName('p') == "Target Flashing Sequence (TFS)");
+    }
+
+    TEST_METHOD(EyeStatusDescriptions)
+    {
+        Assert::IsTrue(PhoenixCatalog::eyeStatusDescription(0) == "No anomaly");
+        Assert::IsTrue(PhoenixCatalog::eyeStatusDescription(7) == "Unknown (7)");
+        Assert::IsTrue(PhoenixCatalog::eyeStatusDescription(12) == "No signal (NUC_NOISE_ONLY)");
+        Assert::IsTrue(PhoenixCatalog::eyeStatusDescription(200) == "Unknown");
+    }
+};
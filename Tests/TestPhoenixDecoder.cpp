@@ -0,0 +1,91 @@
+#include "CppUnitTest.h"
+#include "PhoenixTestData.h"
+#include "../ConvertToJson/PhoenixDecoder.h"
+
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static ByteView View(const std::vector<uint8_t> &bytes)
+{
+    return ByteView(bytes.data(), bytes.size());
+}
+
+// Line noise that is not the start of a frame, then a command, then the reply
+struct NoiseThenCommand
+{
+    std::vector<uint8_t> noise1   = std::vector<uint8_t>(5, 0x00);
+    std::vector<uint8_t> noise2   = std::vector<uint8_t>(7, 0x00);
+    std::vector<uint8_t> command  = {'&', '0', '0', '0', '0', '\r'};
+    std::vector<uint8_t> dataSets = DataSetStream(4, 1);
+
+    TimedRecords tx() const { return {{300, View(command)}}; }
+    TimedRecords rx() const { return {{100, View(noise1)}, {200, View(noise2)}, {400, View(dataSets)}}; }
+};
+
+// ===========================================================================
+// Decoder
+// ===========================================================================
+
+TEST_CLASS(PhoenixDecoderTests)
+{
+  public:
+    TEST_METHOD(TxOnlyCapture)
+    {
+        std::vector<uint8_t>      command = {'&', '0', '0', '0', '0', '\r'};
+        PhoenixDecoder            decoder;
+        std::vector<PhoenixFrame> frames;
+        decoder.decode({{100, View(command)}}, {}, frames);
+
+        Assert::AreEqual(size_t(1), frames.size());
+        Assert::IsTrue(frames[0].type == PhoenixFrameType::Command);
+    }
+
+    TEST_METHOD(HeldNoiseKeepsItsRecord)
+    {
+        // The noise is only given up once the data sets after the command confirm the alignment;
+        // it still carries the timestamps of its own records and comes before the command
+        NoiseThenCommand          capture;
+        PhoenixDecoder            decoder;
+        std::vector<PhoenixFrame> frames;
+        decoder.decode(capture.tx(), capture.rx(), frames);
+
+        Assert::AreEqual(size_t(7), frames.size());
+        Assert::IsTrue(frames[0].type == PhoenixFrameType::Unknown);
+        Assert::AreEqual(uint64_t(100), frames[0].irpTimestamp);
+        Assert::AreEqual(size_t(5), frames[0].rawBytes.size());
+        Assert::IsTrue(frames[1].type == PhoenixFrameType::Unknown);
+        Assert::AreEqual(uint64_t(200), frames[1].irpTimestamp);
+        Assert::AreEqual(size_t(7), frames[1].rawBytes.size());
+        Assert::IsTrue(frames[2].type == PhoenixFrameType::Command);
+        Assert::AreEqual(uint64_t(300), frames[2].irpTimestamp);
+        for (size_t i = 3; i < 7; ++i)
+        {
+            Assert::IsTrue(frames[i].type == PhoenixFrameType::DataSet);
+            Assert::AreEqual(uint64_t(400), frames[i].irpTimestamp);
+        }
+    }
+
+    TEST_METHOD(StreamedDecodeMatchesVector)
+    {
+        NoiseThenCommand          capture;
+        PhoenixDecoder            decoder;
+        std::vector<PhoenixFrame> frames;
+        decoder.decode(capture.tx(), capture.rx(), frames);
+
+        std::vector<std::pair<PhoenixFrameType, uint64_t>> streamed;
+        PhoenixDecoder                                     streaming;
+        streaming.decode(capture.tx(), capture.rx(), [&](const PhoenixFrame &frame) { streamed.emplace_back(frame.type, frame.irpTimestamp); });
+
+        Assert::AreEqual(frames.size(), streamed.size());
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            Assert::IsTrue(frames[i].type == streamed[i].first);
+            Assert::AreEqual(frames[i].irpTimestamp, streamed[i].second);
+        }
+    }
+};
@@ -0,0 +1,158 @@
+#include "CppUnitTest.h"
+#include "PhoenixTestData.h"
+#include "../ConvertToJson/PhoenixFramer.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+struct FramerResult
+{
+    std::vector<std::vector<uint8_t>> frames;
+    size_t                            skipped = 0;
+};
+
+// Push `stream` in chunks of 1..maxChunk bytes, then flush
+static FramerResult Frame(const std::vector<uint8_t> &stream, size_t maxChunk, unsigned seed)
+{
+    PhoenixFramer framer;
+    FramerResult  result;
+    auto          sink = [&](ByteView bytes, bool skipped)
+    {
+        if (skipped)
+            result.skipped += bytes.size();
+        else
+            result.frames.emplace_back(bytes.begin(), bytes.end());
+    };
+
+    std::mt19937 rng(seed);
+    size_t       pos = 0;
+    while (pos < stream.size())
+    {
+        size_t n = std::min<size_t>(1 + rng() % maxChunk, stream.size() - pos);
+        framer.push(ByteView(stream.data() + pos, n), sink);
+        pos += n;
+    }
+    framer.flush(sink);
+    return result;
+}
+
+static std::vector<uint8_t> FrameAt(const std::vector<uint8_t> &stream, size_t index)
+{
+    return std::vector<uint8_t>(stream.begin() + index * 19, stream.begin() + (index + 1) * 19);
+}
+
+// ===========================================================================
+// Framer
+// ===========================================================================
+
+TEST_CLASS(PhoenixFramerTests)
+{
+  public:
+    TEST_METHOD(FramesSplitAcrossChunks)
+    {
+        auto stream = DataSetStream(200, 1);
+        auto result = Frame(stream, 50, 2);
+
+        Assert::AreEqual(size_t(200), result.frames.size());
+        Assert::AreEqual(size_t(0), result.skipped);
+        for (size_t i = 0; i < 200; ++i)
+            Assert::IsTrue(result.frames[i] == FrameAt(stream, i));
+    }
+
+    TEST_METHOD(ResyncAfterDroppedByte)
+    {
+        auto stream = DataSetStream(200, 3);
+        stream.erase(stream.begin() + 50 * 19 + 7); // frame 50 loses a byte
+
+        auto result = Frame(stream, 64, 4);
+
+        // Frames before and after the damaged one survive; only its 18 bytes are discarded
+        Assert::AreEqual(size_t(199), result.frames.size());
+        Assert::AreEqual(size_t(18), result.skipped);
+        for (size_t i = 0; i < 50; ++i)
+            Assert::IsTrue(result.frames[i] == FrameAt(stream, i));
+        for (size_t i = 51; i < 200; ++i)
+        {
+            std::vector<uint8_t> expected(stream.begin() + i * 19 - 1, stream.begin() + (i + 1) * 19 - 1);
+            Assert::IsTrue(result.frames[i - 1] == expected);
+        }
+    }
+
+    TEST_METHOD(ResyncAfterInsertedBytes)
+    {
+        auto stream = DataSetStream(100, 5);
+        stream.insert(stream.begin() + 30 * 19, {0x00, 0x11, 0x22});
+
+        auto result = Frame(stream, 19, 6);
+
+        Assert::AreEqual(size_t(100), result.frames.size());
+        Assert::AreEqual(size_t(3), result.skipped);
+    }
+
+    TEST_METHOD(UnrecognisedFrameKeepsAlignment)
+    {
+        auto stream = DataSetStream(20, 7);
+        std::fill(stream.begin() + 5 * 19, stream.begin() + 6 * 19, uint8_t(0)); // aligned but not a known frame type
+
+        auto result = Frame(stream, 40, 8);
+
+        Assert::AreEqual(size_t(20), result.frames.size());
+        Assert::AreEqual(size_t(0), result.skipped);
+    }
+
+    TEST_METHOD(FramesInPlace)
+    {
+        auto stream = DataSetStream(100, 9);
+        stream.erase(stream.begin() + 40 * 19 + 3); // frame 40 loses a byte
+
+        // The caller keeps the unconsumed bytes and presents them again with the next chunk
+        PhoenixFramer        framer;
+        FramerResult         result;
+        std::vector<uint8_t> kept;
+        auto                 sink = [&](ByteView bytes, bool skipped)
+        {
+            if (skipped)
+                result.skipped += bytes.size();
+            else
+                result.frames.emplace_back(bytes.begin(), bytes.end());
+        };
+        for (size_t pos = 0; pos < stream.size(); pos += 23)
+        {
+            kept.insert(kept.end(), stream.begin() + pos, stream.begin() + std::min(pos + 23, stream.size()));
+            size_t used = framer.frame(ByteView(kept.data(), kept.size()), sink);
+            kept.erase(kept.begin(), kept.begin() + used);
+        }
+
+        // Same frames as push(), and nothing buffered inside the framer
+        auto pushed = Frame(stream, 23, 10);
+        Assert::AreEqual(size_t(0), framer.pending());
+        Assert::AreEqual(size_t(0), kept.size());
+        Assert::AreEqual(size_t(18), result.skipped);
+        Assert::IsTrue(result.frames == pushed.frames);
+
+        // A frame limit stops early and leaves the rest unconsumed
+        PhoenixFramer limited;
+        result.frames.clear();
+        Assert::AreEqual(size_t(3 * 19), limited.frame(ByteView(stream.data(), 10 * 19), sink, 3));
+        Assert::AreEqual(size_t(3), result.frames.size());
+    }
+
+    TEST_METHOD(InitAndAckAreFrameStarts)
+    {
+        uint8_t init[19] = {0x01, 0x02, 0x03, 0x04};
+        uint8_t ack[19]  = {'&', '3'};
+        ack[14]          = 0x06;
+        Assert::IsTrue(PhoenixFramer::isFrameStart(init));
+        Assert::IsTrue(PhoenixFramer::isFrameStart(ack));
+
+        uint8_t zero[19] = {};
+        Assert::IsFalse(PhoenixFramer::isFrameStart(zero));
+    }
+};
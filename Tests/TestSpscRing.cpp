@@ -0,0 +1,65 @@
+#include "CppUnitTest.h"
+#include "../Detect/SpscRing.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+TEST_CLASS(SpscRingTests)
+{
+  public:
+    TEST_METHOD(RejectsWhenFull)
+    {
+        SpscRing<int> ring(5);
+        Assert::AreEqual(size_t(8), ring.capacity());
+
+        for (int i = 0; i < 8; ++i)
+            Assert::IsTrue(ring.push(i));
+        Assert::IsFalse(ring.push(8));
+        Assert::AreEqual(size_t(8), ring.size());
+
+        std::vector<int> out;
+        Assert::AreEqual(size_t(3), ring.popInto(out, 3));
+        Assert::IsTrue(ring.push(8));
+        Assert::AreEqual(size_t(6), ring.popInto(out));
+        Assert::IsTrue(ring.empty());
+        Assert::AreEqual(size_t(0), ring.popInto(out));
+
+        for (int i = 0; i < 9; ++i)
+            Assert::AreEqual(i, out[i]);
+    }
+
+    TEST_METHOD(KeepsOrderAcrossThreads)
+    {
+        const uint32_t     count = 1000000;
+        SpscRing<uint32_t> ring(1024);
+
+        std::thread producer(
+            [&]
+            {
+                for (uint32_t i = 0; i < count;)
+                {
+                    if (ring.push(i))
+                        ++i;
+                    else
+                        std::this_thread::yield();
+                }
+            });
+
+        std::vector<uint32_t> out;
+        out.reserve(count);
+        while (out.size() < count)
+        {
+            if (ring.popInto(out) == 0)
+                std::this_thread::yield();
+        }
+        producer.join();
+
+        bool inOrder = true;
+        for (uint32_t i = 0; i < count; ++i)
+            inOrder = inOrder && out[i] == i;
+        Assert::IsTrue(inOrder);
+    }
+};